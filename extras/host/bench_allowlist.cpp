@@ -0,0 +1,100 @@
+// NAME: bench_allowlist.cpp
+//
+// DESC: Замер списка разрешённых UID на хосте: время построения, байт на UID,
+//       время поиска для UID из списка и чужих UID, ложные срабатывания.
+//       Для сравнения — двоичный поиск по отсортированному массиву UID.
+//
+// Этот файл является частью библиотеки PN5180 для среды Arduino.
+//
+// Эта библиотека является свободным программным обеспечением; вы можете распространять и/или
+// изменять её на условиях Стандартной Общественной Лицензии GNU (LGPL) версии 2.1
+// либо (по вашему выбору) любой более поздней версии.
+//
+// Эта библиотека распространяется в надежде, что она будет полезной,
+// но БЕЗ КАКИХ-ЛИБО ГАРАНТИЙ; даже без подразумеваемой гарантии
+// КОММЕРЧЕСКОЙ ЦЕННОСТИ или ПРИГОДНОСТИ ДЛЯ ОПРЕДЕЛЕННОЙ ЦЕЛИ. Подробнее см. в
+// Стандартной Общественной Лицензии GNU.
+//
+//
+
+#include <stdio.h>
+#include <time.h>
+#include <algorithm>
+#include "pn5180_allowlist_builder.h"
+
+#define BENCH_LOOKUPS 4000000
+#define BENCH_MISSES 1000000
+
+static volatile size_t sink; // не даёт компилятору выбросить цикл сравнения
+
+static uint64_t nowNs()
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static double lookupNs(PN5180Allowlist &allowlist, const std::vector<PN5180Uid> &uids, size_t *found)
+{
+	*found = 0;
+	uint64_t start = nowNs();
+	for (size_t i = 0; i < BENCH_LOOKUPS; i++)
+	{
+		const PN5180Uid &uid = uids[i % uids.size()];
+		*found += allowlist.contains(uid.data(), uid.size());
+	}
+	return (double)(nowNs() - start) / BENCH_LOOKUPS;
+}
+
+static double sortedNs(const std::vector<PN5180Uid> &sorted, const std::vector<PN5180Uid> &uids)
+{
+	size_t found = 0;
+	uint64_t start = nowNs();
+	for (size_t i = 0; i < BENCH_LOOKUPS; i++)
+		found += std::binary_search(sorted.begin(), sorted.end(), uids[i % uids.size()]);
+	sink = found;
+	return (double)(nowNs() - start) / BENCH_LOOKUPS;
+}
+
+static void run(size_t count)
+{
+	std::vector<PN5180Uid> uids, strangers;
+	pn5180RandomUids(count, 1, uids);
+	pn5180RandomUids(BENCH_MISSES, 2, strangers);
+
+	std::vector<uint8_t> image;
+	PN5180AllowlistBuildStats stats;
+	std::string error;
+	uint64_t start = nowNs();
+	if (!pn5180BuildAllowlist(uids, image, &stats, &error))
+	{
+		printf("%7zu  build failed: %s\n", count, error.c_str());
+		return;
+	}
+	double buildMs = (nowNs() - start) / 1e6;
+
+	PN5180Allowlist allowlist;
+	allowlist.beginMemory(image.data());
+	size_t hits, falsePositives;
+	double hitNs = lookupNs(allowlist, uids, &hits);
+	double missNs = lookupNs(allowlist, strangers, &falsePositives);
+
+	std::vector<PN5180Uid> sorted(uids);
+	std::sort(sorted.begin(), sorted.end());
+	double sortedHitNs = sortedNs(sorted, uids);
+
+	printf("%7zu %9.1f %5u %9zu %9.2f %8.1f %8.1f %9.1f %8s %6zu\n", stats.keys, buildMs, stats.seed, image.size(),
+		   (double)image.size() / stats.keys, hitNs, missNs, sortedHitNs,
+		   hits == BENCH_LOOKUPS ? "ok" : "MISSED", falsePositives);
+}
+
+int main()
+{
+	printf("%d lookups per column; misses cycle over %d foreign UIDs, fp = false positives among them (2^-32 each)\n\n",
+		   BENCH_LOOKUPS, BENCH_MISSES);
+	printf("   UIDs  build ms  seed     bytes  bytes/UID   hit ns  miss ns sorted ns     hits    fp\n");
+	size_t sizes[] = {256, 1000, 4000, 16000, PN5180_ALLOWLIST_MAX_COUNT};
+	for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++)
+		run(sizes[s]);
+	return 0;
+}
@@ -0,0 +1,158 @@
+// NAME: bench_events.cpp
+//
+// DESC: Пропускная способность разбора потока событий и сравнение
+//       объёма на линии с текстовым выводом скетча.
+//
+// Этот файл является частью библиотеки PN5180 для среды Arduino.
+//
+// Эта библиотека является свободным программным обеспечением; вы можете распространять и/или
+// изменять её на условиях Стандартной Общественной Лицензии GNU (LGPL) версии 2.1
+// либо (по вашему выбору) любой более поздней версии.
+//
+// Эта библиотека распространяется в надежде, что она будет полезной,
+// но БЕЗ КАКИХ-ЛИБО ГАРАНТИЙ; даже без подразумеваемой гарантии
+// КОММЕРЧЕСКОЙ ЦЕННОСТИ или ПРИГОДНОСТИ ДЛЯ ОПРЕДЕЛЕННОЙ ЦЕЛИ. Подробнее см. в
+// Стандартной Общественной Лицензии GNU.
+//
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <vector>
+#include "pn5180_event_parser.h"
+
+#define BENCH_EVENTS 2000000
+#define BENCH_NOISE_PERCENT 1
+
+static uint64_t nowNs()
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+struct Counter
+{
+	uint64_t enter;
+	uint64_t other;
+};
+
+static void countEvent(const PN5180Event &event, void *context)
+{
+	Counter *counter = (Counter *)context;
+	PN5180CardEvent card;
+	if (pn5180DecodeCard(event, &card) && card.hasTypeA)
+		counter->enter++;
+	else
+		counter->other++;
+}
+
+/*
+ * Смесь событий цикла опроса: вход карты Type A с 7-байтовым UID,
+ * уход, результат APDU, ошибка IRQ.
+ */
+static std::vector<uint8_t> buildStream(size_t count, size_t *typeABytes)
+{
+	std::vector<uint8_t> stream;
+	uint8_t frame[PN5180_EVENT_MAX_FRAME];
+	uint8_t seq = 0;
+	srand(1);
+	for (size_t i = 0; i < count; i++)
+	{
+		uint8_t payload[PN5180_EVENT_MAX_PAYLOAD];
+		uint8_t type, len;
+		uint8_t kind = i % 10;
+		if (kind < 6)
+		{
+			type = PN5180_EVENT_CARD_ENTER;
+			payload[0] = 0;
+			payload[1] = 7;
+			for (int b = 0; b < 7; b++)
+				payload[2 + b] = rand() & 0xFF;
+			payload[9] = 0x44;
+			payload[10] = 0x00;
+			payload[11] = 0x00;
+			len = 12;
+		}
+		else if (kind < 8)
+		{
+			type = PN5180_EVENT_CARD_LEAVE;
+			payload[0] = 0;
+			payload[1] = 7;
+			for (int b = 0; b < 7; b++)
+				payload[2 + b] = rand() & 0xFF;
+			len = 9;
+		}
+		else if (kind < 9)
+		{
+			type = PN5180_EVENT_APDU_RESULT;
+			uint8_t apdu[5] = {1, 0x90, 0x00, 10, 0};
+			memcpy(payload, apdu, sizeof(apdu));
+			len = 5;
+		}
+		else
+		{
+			type = PN5180_EVENT_ERROR;
+			uint8_t error[5] = {PN5180_EVENT_ERROR_IRQ, 0x06, 0x67, 0x06, 0x66};
+			memcpy(payload, error, sizeof(error));
+			len = 5;
+		}
+		size_t n = pn5180EncodeEvent(type, seq++, payload, len, frame);
+		if (kind == 0)
+			*typeABytes = n;
+		stream.insert(stream.end(), frame, frame + n);
+	}
+	return stream;
+}
+
+static void run(const char *name, const std::vector<uint8_t> &stream, size_t chunk)
+{
+	Counter counter = {0, 0};
+	PN5180EventParser parser(countEvent, &counter);
+	uint64_t start = nowNs();
+	for (size_t pos = 0; pos < stream.size(); pos += chunk)
+	{
+		size_t n = stream.size() - pos < chunk ? stream.size() - pos : chunk;
+		parser.feed(stream.data() + pos, n);
+	}
+	double seconds = (nowNs() - start) / 1e9;
+	const PN5180ParserStats &stats = parser.getStats();
+	printf("%-8s %6zu %10.1f %10.2f %10llu %9llu %9llu %9llu\n", name, chunk, stream.size() / seconds / 1e6, stats.frames / seconds / 1e6,
+		   (unsigned long long)stats.frames, (unsigned long long)stats.crcErrors, (unsigned long long)stats.lost,
+		   (unsigned long long)stats.skipped);
+}
+
+int main()
+{
+	size_t typeABytes = 0;
+	std::vector<uint8_t> clean = buildStream(BENCH_EVENTS, &typeABytes);
+
+	// Помехи: случайные байты поверх 1% позиций
+	std::vector<uint8_t> noisy = clean;
+	srand(2);
+	for (size_t i = 0; i < noisy.size() * BENCH_NOISE_PERCENT / 100; i++)
+		noisy[rand() % noisy.size()] = rand() & 0xFF;
+
+	printf("%zu events, %zu bytes, %.1f bytes/event\n\n", (size_t)BENCH_EVENTS, clean.size(), (double)clean.size() / BENCH_EVENTS);
+	printf("stream    chunk       MB/s  Mframes/s     frames crcErrors      lost   skipped\n");
+	size_t chunks[] = {1, 64, 4096};
+	for (size_t c = 0; c < sizeof(chunks) / sizeof(chunks[0]); c++)
+		run("clean", clean, chunks[c]);
+	for (size_t c = 0; c < sizeof(chunks) / sizeof(chunks[0]); c++)
+		run("noisy", noisy, chunks[c]);
+
+	// Текст printCardWorkInfo() для той же карты Type A (без строк о типе карты)
+	const char *text = "UID: 04:A1:B2:C3:D4:E5:F6\r\nSAK: 0x00\r\nATQA: 0x0044\r\n";
+	size_t textBytes = strlen(text);
+	printf("\nType A card enter on the wire: binary %zu bytes, text %zu bytes (+ descriptive lines)\n", typeABytes, textBytes);
+	long bauds[] = {9600, 115200, 500000, 1000000};
+	for (size_t b = 0; b < sizeof(bauds) / sizeof(bauds[0]); b++)
+	{
+		double bytesPerSecond = bauds[b] / 10.0; // 8N1
+		printf("  %7ld baud: binary %8.0f events/s (%.3f ms), text %6.0f events/s\n", bauds[b], bytesPerSecond / typeABytes,
+			   typeABytes * 1000.0 / bytesPerSecond, bytesPerSecond / textBytes);
+	}
+	return 0;
+}
@@ -0,0 +1,208 @@
+// NAME: build_allowlist.cpp
+//
+// DESC: Построение образа списка разрешённых UID (PN5180Allowlist.h).
+//
+//   ./build_allowlist -o allowlist.bin uids.txt
+//   ./build_allowlist -H AllowlistData.h --name allowlist uids.txt
+//   ./build_allowlist --random 256 --seed 7 --keys -H ../../src/AllowlistBenchData.h --name allowlistBench
+//
+// Входной файл: по одному UID в строке в шестнадцатеричном виде (разделители
+// ':', '-', пробел), '#' — комментарий; без файла UID читаются со stdin.
+//
+// Этот файл является частью библиотеки PN5180 для среды Arduino.
+//
+// Эта библиотека является свободным программным обеспечением; вы можете распространять и/или
+// изменять её на условиях Стандартной Общественной Лицензии GNU (LGPL) версии 2.1
+// либо (по вашему выбору) любой более поздней версии.
+//
+// Эта библиотека распространяется в надежде, что она будет полезной,
+// но БЕЗ КАКИХ-ЛИБО ГАРАНТИЙ; даже без подразумеваемой гарантии
+// КОММЕРЧЕСКОЙ ЦЕННОСТИ или ПРИГОДНОСТИ ДЛЯ ОПРЕДЕЛЕННОЙ ЦЕЛИ. Подробнее см. в
+// Стандартной Общественной Лицензии GNU.
+//
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <set>
+#include "pn5180_allowlist_builder.h"
+
+static void usage()
+{
+	fprintf(stderr, "usage: build_allowlist [-o image.bin] [-H header.h [--name NAME] [--keys]]\n"
+					"                       [--random N [--seed S] | uids.txt]\n");
+	exit(2);
+}
+
+static bool readUids(FILE *in, const char *name, std::vector<PN5180Uid> &uids)
+{
+	char line[256];
+	unsigned number = 0;
+	while (fgets(line, sizeof(line), in))
+	{
+		number++;
+		char *comment = strchr(line, '#');
+		if (comment)
+			*comment = 0;
+		char *p = line;
+		while (*p == ' ' || *p == '\t')
+			p++;
+		if (*p == 0 || *p == '\r' || *p == '\n')
+			continue;
+		PN5180Uid uid;
+		if (!pn5180ParseUid(p, uid))
+		{
+			fprintf(stderr, "%s:%u: not a 4, 7 or 10 byte UID\n", name, number);
+			return false;
+		}
+		uids.push_back(uid);
+	}
+	return true;
+}
+
+static bool writeImage(const char *path, const std::vector<uint8_t> &image)
+{
+	FILE *out = fopen(path, "wb");
+	if (!out)
+		return false;
+	bool ok = fwrite(image.data(), 1, image.size(), out) == image.size();
+	return fclose(out) == 0 && ok;
+}
+
+static void writeBytes(FILE *out, const uint8_t *data, size_t len)
+{
+	for (size_t i = 0; i < len; i++)
+		fprintf(out, "%s0x%02X,", i % 12 ? " " : "\n  ", data[i]);
+}
+
+/*
+ * C-заголовок с образом в PROGMEM. С --keys — ещё и сами UID
+ * (длина и 10 байт на UID) для замера поиска на плате.
+ */
+static bool writeHeader(const char *path, const char *name, const std::vector<uint8_t> &image, size_t count,
+						const std::vector<PN5180Uid> &uids)
+{
+	FILE *out = fopen(path, "w");
+	if (!out)
+		return false;
+	fprintf(out, "// Generated by extras/host/build_allowlist, do not edit.\n");
+	fprintf(out, "// %zu UIDs, %zu bytes.\n\n", count, image.size());
+	fprintf(out, "#include <Arduino.h>\n\n");
+	fprintf(out, "static const uint8_t %s[%zu] PROGMEM = {", name, image.size());
+	writeBytes(out, image.data(), image.size());
+	fprintf(out, "\n};\n");
+	if (!uids.empty())
+	{
+		fprintf(out, "\nstatic const uint16_t %sKeyCount = %zu;\n", name, uids.size());
+		fprintf(out, "static const uint8_t %sKeys[%zu][11] PROGMEM = {", name, uids.size());
+		for (size_t i = 0; i < uids.size(); i++)
+		{
+			uint8_t key[11] = {(uint8_t)uids[i].size()};
+			memcpy(key + 1, uids[i].data(), uids[i].size());
+			fprintf(out, "\n  {");
+			for (size_t k = 0; k < sizeof(key); k++)
+				fprintf(out, "%s0x%02X", k ? ", " : "", key[k]);
+			fprintf(out, "},");
+		}
+		fprintf(out, "\n};\n");
+	}
+	return fclose(out) == 0;
+}
+
+int main(int argc, char **argv)
+{
+	const char *imagePath = 0;
+	const char *headerPath = 0;
+	const char *name = "allowlist";
+	const char *input = 0;
+	bool keys = false;
+	long randomCount = -1;
+	unsigned long randomSeed = 1;
+	for (int i = 1; i < argc; i++)
+	{
+		if (!strcmp(argv[i], "-o") && i + 1 < argc)
+			imagePath = argv[++i];
+		else if (!strcmp(argv[i], "-H") && i + 1 < argc)
+			headerPath = argv[++i];
+		else if (!strcmp(argv[i], "--name") && i + 1 < argc)
+			name = argv[++i];
+		else if (!strcmp(argv[i], "--keys"))
+			keys = true;
+		else if (!strcmp(argv[i], "--random") && i + 1 < argc)
+			randomCount = strtol(argv[++i], 0, 0);
+		else if (!strcmp(argv[i], "--seed") && i + 1 < argc)
+			randomSeed = strtoul(argv[++i], 0, 0);
+		else if (argv[i][0] != '-' && !input)
+			input = argv[i];
+		else
+			usage();
+	}
+	if (!imagePath && !headerPath)
+		usage();
+
+	std::vector<PN5180Uid> uids;
+	if (randomCount >= 0)
+		pn5180RandomUids(randomCount, randomSeed, uids);
+	else
+	{
+		FILE *in = input ? fopen(input, "r") : stdin;
+		if (!in)
+		{
+			perror(input);
+			return 1;
+		}
+		bool ok = readUids(in, input ? input : "stdin", uids);
+		if (input)
+			fclose(in);
+		if (!ok)
+			return 1;
+	}
+
+	std::vector<uint8_t> image;
+	PN5180AllowlistBuildStats stats;
+	std::string error;
+	if (!pn5180BuildAllowlist(uids, image, &stats, &error))
+	{
+		fprintf(stderr, "build_allowlist: %s\n", error.c_str());
+		return 1;
+	}
+
+	// Проверка тем же кодом, что работает на плате
+	PN5180Allowlist allowlist;
+	bool ok = allowlist.beginMemory(image.data()) && allowlist.getCount() == stats.keys;
+	for (size_t i = 0; i < uids.size() && ok; i++)
+		ok = allowlist.contains(uids[i].data(), uids[i].size());
+	if (!ok)
+	{
+		fprintf(stderr, "build_allowlist: image does not verify\n");
+		return 1;
+	}
+
+	fprintf(stderr, "%zu UIDs (%zu duplicates dropped), %zu buckets (%zu direct), seed %u, max displacement %u\n",
+			stats.keys, stats.duplicates, stats.buckets, stats.directBuckets, stats.seed, stats.maxDisp);
+	fprintf(stderr, "%zu bytes, %.2f bytes/UID\n", image.size(), stats.keys ? (double)image.size() / stats.keys : 0.0);
+
+	if (imagePath && !writeImage(imagePath, image))
+	{
+		perror(imagePath);
+		return 1;
+	}
+	if (headerPath)
+	{
+		// UID для замера — без повторов, в порядке входа
+		std::vector<PN5180Uid> listed;
+		std::set<PN5180Uid> added;
+		for (size_t i = 0; i < uids.size() && keys; i++)
+		{
+			if (added.insert(uids[i]).second)
+				listed.push_back(uids[i]);
+		}
+		if (!writeHeader(headerPath, name, image, stats.keys, listed))
+		{
+			perror(headerPath);
+			return 1;
+		}
+	}
+	return 0;
+}
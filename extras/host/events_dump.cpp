@@ -0,0 +1,66 @@
+// NAME: events_dump.cpp
+//
+// DESC: Печать событий из потока (stdin или порт, уже настроенный stty).
+//
+//   stty -F /dev/ttyUSB0 500000 raw -echo && ./events_dump < /dev/ttyUSB0
+//
+// Этот файл является частью библиотеки PN5180 для среды Arduino.
+//
+// Эта библиотека является свободным программным обеспечением; вы можете распространять и/или
+// изменять её на условиях Стандартной Общественной Лицензии GNU (LGPL) версии 2.1
+// либо (по вашему выбору) любой более поздней версии.
+//
+// Эта библиотека распространяется в надежде, что она будет полезной,
+// но БЕЗ КАКИХ-ЛИБО ГАРАНТИЙ; даже без подразумеваемой гарантии
+// КОММЕРЧЕСКОЙ ЦЕННОСТИ или ПРИГОДНОСТИ ДЛЯ ОПРЕДЕЛЕННОЙ ЦЕЛИ. Подробнее см. в
+// Стандартной Общественной Лицензии GNU.
+//
+//
+
+#include <stdio.h>
+#include <unistd.h>
+#include "pn5180_event_parser.h"
+
+static void printUid(const PN5180CardEvent &card)
+{
+	for (uint8_t i = 0; i < card.uidLength; i++)
+		printf("%s%02X", i ? ":" : "", card.uid[i]);
+}
+
+static void printEvent(const PN5180Event &event, void *)
+{
+	PN5180CardEvent card;
+	PN5180ApduEvent apdu;
+	PN5180ErrorEvent error;
+	printf("#%03u ", event.seq);
+	if (event.type == PN5180_EVENT_HELLO && event.length == 3)
+		printf("HELLO protocol %u, PN5180 %u.%u\n", event.payload[0], event.payload[2], event.payload[1]);
+	else if (pn5180DecodeCard(event, &card))
+	{
+		printf("%s tech %u UID ", event.type == PN5180_EVENT_CARD_ENTER ? "ENTER" : "LEAVE", card.technology);
+		printUid(card);
+		if (card.hasTypeA)
+			printf(" ATQA %02X%02X SAK %02X", card.atqa[1], card.atqa[0], card.sak);
+		printf("\n");
+	}
+	else if (pn5180DecodeApdu(event, &apdu))
+		printf("APDU #%u SW %04X, %u bytes\n", apdu.index, apdu.sw, apdu.responseLength);
+	else if (pn5180DecodeError(event, &error))
+		printf("ERROR %u detail 0x%08X\n", error.code, (unsigned)error.detail);
+	else
+		printf("type 0x%02X, %u bytes\n", event.type, event.length);
+	fflush(stdout);
+}
+
+int main()
+{
+	PN5180EventParser parser(printEvent);
+	uint8_t buffer[256];
+	ssize_t n;
+	while ((n = read(0, buffer, sizeof(buffer))) > 0)
+		parser.feed(buffer, (size_t)n);
+	const PN5180ParserStats &stats = parser.getStats();
+	fprintf(stderr, "%llu frames, %llu lost, %llu CRC errors, %llu bytes skipped\n", (unsigned long long)stats.frames,
+			(unsigned long long)stats.lost, (unsigned long long)stats.crcErrors, (unsigned long long)stats.skipped);
+	return 0;
+}
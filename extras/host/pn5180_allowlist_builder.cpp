@@ -0,0 +1,228 @@
+// NAME: pn5180_allowlist_builder.cpp
+//
+// DESC: Построение образа списка разрешённых UID на хосте: минимальная
+//       совершенная хеш-функция методом «хеш и смещение» (CHD).
+//
+// Этот файл является частью библиотеки PN5180 для среды Arduino.
+//
+// Эта библиотека является свободным программным обеспечением; вы можете распространять и/или
+// изменять её на условиях Стандартной Общественной Лицензии GNU (LGPL) версии 2.1
+// либо (по вашему выбору) любой более поздней версии.
+//
+// Эта библиотека распространяется в надежде, что она будет полезной,
+// но БЕЗ КАКИХ-ЛИБО ГАРАНТИЙ; даже без подразумеваемой гарантии
+// КОММЕРЧЕСКОЙ ЦЕННОСТИ или ПРИГОДНОСТИ ДЛЯ ОПРЕДЕЛЕННОЙ ЦЕЛИ. Подробнее см. в
+// Стандартной Общественной Лицензии GNU.
+//
+//
+
+#include <ctype.h>
+#include <algorithm>
+#include "pn5180_allowlist_builder.h"
+
+static bool validLength(size_t len)
+{
+	return len == 4 || len == 7 || len == 10;
+}
+
+/*
+ * Одна попытка с глобальным seed. Корзины обрабатываются от больших к меньшим:
+ * для корзины из нескольких ключей ищется смещение, при котором все её ключи
+ * попадают в разные свободные слоты. Корзины из одного ключа получают
+ * оставшиеся слоты напрямую (бит PN5180_ALLOWLIST_DIRECT), поэтому
+ * последние, самые трудные размещения не требуют перебора.
+ */
+static bool tryBuild(const std::vector<PN5180Uid> &keys, uint16_t seed, uint16_t buckets,
+					 std::vector<uint16_t> &disp, std::vector<uint32_t> &fp, PN5180AllowlistBuildStats &stats)
+{
+	size_t n = keys.size();
+	uint32_t base = (uint32_t)seed << 16;
+	std::vector<uint32_t> h(n);
+	std::vector<std::vector<size_t> > members(buckets);
+	for (size_t i = 0; i < n; i++)
+	{
+		h[i] = pn5180AllowlistHash(keys[i].data(), keys[i].size(), base);
+		members[pn5180AllowlistReduce(h[i], buckets)].push_back(i);
+	}
+
+	std::vector<uint16_t> order(buckets);
+	for (uint16_t b = 0; b < buckets; b++)
+		order[b] = b;
+	std::stable_sort(order.begin(), order.end(), [&](uint16_t a, uint16_t b) {
+		return members[a].size() > members[b].size();
+	});
+
+	disp.assign(buckets, 0);
+	fp.assign(n, 0);
+	std::vector<bool> taken(n, false);
+	std::vector<uint16_t> slots;
+	stats.directBuckets = 0;
+	stats.maxDisp = 0;
+
+	size_t pos = 0;
+	for (; pos < order.size() && members[order[pos]].size() >= 2; pos++)
+	{
+		const std::vector<size_t> &bucket = members[order[pos]];
+		bool placed = false;
+		for (uint32_t d = 0; d < PN5180_ALLOWLIST_DIRECT && !placed; d++)
+		{
+			stats.trials++;
+			slots.clear();
+			bool ok = true;
+			for (size_t k = 0; k < bucket.size() && ok; k++)
+			{
+				const PN5180Uid &key = keys[bucket[k]];
+				uint16_t slot = pn5180AllowlistReduce(pn5180AllowlistHash(key.data(), key.size(), base + d + 1), n);
+				ok = !taken[slot] && std::find(slots.begin(), slots.end(), slot) == slots.end();
+				slots.push_back(slot);
+			}
+			if (!ok)
+				continue;
+			for (size_t k = 0; k < bucket.size(); k++)
+			{
+				taken[slots[k]] = true;
+				fp[slots[k]] = h[bucket[k]];
+			}
+			disp[order[pos]] = d;
+			if (d > stats.maxDisp)
+				stats.maxDisp = d;
+			placed = true;
+		}
+		if (!placed)
+			return false;
+	}
+
+	uint16_t free = 0;
+	for (; pos < order.size() && members[order[pos]].size() == 1; pos++)
+	{
+		while (taken[free])
+			free++;
+		size_t key = members[order[pos]][0];
+		taken[free] = true;
+		fp[free] = h[key];
+		disp[order[pos]] = PN5180_ALLOWLIST_DIRECT | free;
+		stats.directBuckets++;
+	}
+	return true;
+}
+
+bool pn5180BuildAllowlist(const std::vector<PN5180Uid> &uids, std::vector<uint8_t> &image,
+						  PN5180AllowlistBuildStats *stats, std::string *error)
+{
+	PN5180AllowlistBuildStats local;
+	PN5180AllowlistBuildStats &s = stats ? *stats : local;
+	s = PN5180AllowlistBuildStats();
+
+	for (size_t i = 0; i < uids.size(); i++)
+	{
+		if (!validLength(uids[i].size()))
+		{
+			if (error)
+				*error = "UID #" + std::to_string(i + 1) + ": length must be 4, 7 or 10 bytes";
+			return false;
+		}
+	}
+	std::vector<PN5180Uid> keys(uids);
+	std::sort(keys.begin(), keys.end());
+	keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+	s.duplicates = uids.size() - keys.size();
+	s.keys = keys.size();
+	if (keys.size() > PN5180_ALLOWLIST_MAX_COUNT)
+	{
+		if (error)
+			*error = "more than " + std::to_string(PN5180_ALLOWLIST_MAX_COUNT) + " UIDs";
+		return false;
+	}
+
+	uint16_t n = keys.size();
+	uint16_t buckets = n ? (n + PN5180_ALLOWLIST_BUCKET_KEYS - 1) / PN5180_ALLOWLIST_BUCKET_KEYS : 0;
+	std::vector<uint16_t> disp;
+	std::vector<uint32_t> fp;
+	uint32_t seed = 0;
+	while (seed <= 0xFFFF && !tryBuild(keys, seed, buckets, disp, fp, s))
+		seed++;
+	if (seed > 0xFFFF)
+	{
+		if (error)
+			*error = "no displacement found for any seed";
+		return false;
+	}
+	s.seed = seed;
+	s.buckets = buckets;
+
+	image.clear();
+	image.reserve(PN5180_ALLOWLIST_HEADER_LEN + 2 * disp.size() + 4 * fp.size());
+	const uint8_t header[PN5180_ALLOWLIST_HEADER_LEN] = {
+		'P', 'N', 'A', 'L', PN5180_ALLOWLIST_VERSION, 0,
+		(uint8_t)(n & 0xFF), (uint8_t)(n >> 8),
+		(uint8_t)(buckets & 0xFF), (uint8_t)(buckets >> 8),
+		(uint8_t)(seed & 0xFF), (uint8_t)(seed >> 8)};
+	image.insert(image.end(), header, header + sizeof(header));
+	for (size_t b = 0; b < disp.size(); b++)
+	{
+		image.push_back(disp[b] & 0xFF);
+		image.push_back(disp[b] >> 8);
+	}
+	for (size_t i = 0; i < fp.size(); i++)
+	{
+		for (int k = 0; k < 4; k++)
+			image.push_back((fp[i] >> (8 * k)) & 0xFF);
+	}
+	return true;
+}
+
+bool pn5180ParseUid(const char *text, PN5180Uid &uid)
+{
+	uid.clear();
+	int high = -1;
+	for (const char *p = text; *p; p++)
+	{
+		if (*p == ':' || *p == ' ' || *p == '-' || *p == '\t' || *p == '\r' || *p == '\n')
+		{
+			if (high >= 0)
+				return false; // нечётное число цифр в байте
+			continue;
+		}
+		if (!isxdigit((unsigned char)*p))
+			return false;
+		int v = isdigit((unsigned char)*p) ? *p - '0' : tolower((unsigned char)*p) - 'a' + 10;
+		if (high < 0)
+			high = v;
+		else
+		{
+			uid.push_back((uint8_t)(high << 4 | v));
+			high = -1;
+		}
+	}
+	return high < 0 && validLength(uid.size());
+}
+
+/*
+ * Доли длин — как в реальном парке: 7-байтовые (NTAG, Ultralight, DESFire)
+ * с кодом производителя NXP, 4-байтовые (Classic), немного 10-байтовых.
+ */
+void pn5180RandomUids(size_t count, uint32_t seed, std::vector<PN5180Uid> &uids)
+{
+	uint32_t x = seed ? seed : 1;
+	uids.clear();
+	uids.reserve(count);
+	for (size_t i = 0; i < count; i++)
+	{
+		x ^= x << 13;
+		x ^= x >> 17;
+		x ^= x << 5;
+		uint8_t kind = x % 10;
+		size_t len = kind < 4 ? 4 : (kind < 9 ? 7 : 10);
+		PN5180Uid uid(len);
+		for (size_t k = 0; k < len; k++)
+		{
+			x ^= x << 13;
+			x ^= x >> 17;
+			x ^= x << 5;
+			uid[k] = x >> 24;
+		}
+		if (len == 7)
+			uid[0] = 0x04;
+		uids.push_back(uid);
+	}
+}
@@ -0,0 +1,49 @@
+// NAME: pn5180_allowlist_builder.h
+//
+// DESC: Host-side builder of UID allowlist images (PN5180Allowlist.h).
+//
+// This file is part of the PN5180 library for the Arduino environment.
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// Lesser General Public License for more details.
+//
+#ifndef PN5180_ALLOWLIST_BUILDER_H
+#define PN5180_ALLOWLIST_BUILDER_H
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include "PN5180Allowlist.h"
+
+typedef std::vector<uint8_t> PN5180Uid;
+
+struct PN5180AllowlistBuildStats
+{
+  size_t keys;          // distinct UIDs in the image
+  size_t duplicates;    // repeated UIDs dropped
+  size_t buckets;
+  size_t directBuckets; // one-key buckets stored as the slot itself
+  uint16_t seed;        // global seed that succeeded
+  uint16_t maxDisp;     // largest displacement searched
+  uint64_t trials;      // displacement candidates tried
+};
+
+// Builds the image; on failure returns false and a reason in error
+bool pn5180BuildAllowlist(const std::vector<PN5180Uid> &uids, std::vector<uint8_t> &image,
+                          PN5180AllowlistBuildStats *stats, std::string *error);
+
+// "04A1B2C3", "04:A1:B2:C3" or "04 a1 b2 c3"; 4, 7 or 10 bytes
+bool pn5180ParseUid(const char *text, PN5180Uid &uid);
+
+// Deterministic pseudo-random UIDs for tests and benchmarks (xorshift32)
+void pn5180RandomUids(size_t count, uint32_t seed, std::vector<PN5180Uid> &uids);
+
+#endif /* PN5180_ALLOWLIST_BUILDER_H */
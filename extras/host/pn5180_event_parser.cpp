@@ -0,0 +1,205 @@
+// NAME: pn5180_event_parser.cpp
+//
+// DESC: Разбор двоичного потока событий карт на стороне хоста.
+//
+// Этот файл является частью библиотеки PN5180 для среды Arduino.
+//
+// Эта библиотека является свободным программным обеспечением; вы можете распространять и/или
+// изменять её на условиях Стандартной Общественной Лицензии GNU (LGPL) версии 2.1
+// либо (по вашему выбору) любой более поздней версии.
+//
+// Эта библиотека распространяется в надежде, что она будет полезной,
+// но БЕЗ КАКИХ-ЛИБО ГАРАНТИЙ; даже без подразумеваемой гарантии
+// КОММЕРЧЕСКОЙ ЦЕННОСТИ или ПРИГОДНОСТИ ДЛЯ ОПРЕДЕЛЕННОЙ ЦЕЛИ. Подробнее см. в
+// Стандартной Общественной Лицензии GNU.
+//
+//
+
+#include <string.h>
+#include "pn5180_event_parser.h"
+
+// CRC-16/CCITT-FALSE по таблице: на хосте разбор упирается в неё
+static struct CrcTable
+{
+	uint16_t entry[256];
+	CrcTable()
+	{
+		for (int i = 0; i < 256; i++)
+		{
+			uint16_t crc = (uint16_t)(i << 8);
+			for (int b = 0; b < 8; b++)
+				crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+			entry[i] = crc;
+		}
+	}
+} crcTable;
+
+uint16_t pn5180EventCrc(const uint8_t *data, uint16_t len, uint16_t crc)
+{
+	while (len--)
+		crc = (uint16_t)((crc << 8) ^ crcTable.entry[(crc >> 8) ^ *data++]);
+	return crc;
+}
+
+PN5180EventParser::PN5180EventParser(PN5180EventHandler handler, void *context)
+	: handler(handler), context(context)
+{
+	reset();
+}
+
+void PN5180EventParser::reset()
+{
+	memset(&stats, 0, sizeof(stats));
+	lastSeq = -1;
+	pendingLen = 0;
+}
+
+const PN5180ParserStats &PN5180EventParser::getStats() const
+{
+	return stats;
+}
+
+/*
+ * Основной путь — кадры прямо во входном буфере, без копирования.
+ * В pending попадает только незаконченный кадр на границе двух вызовов.
+ */
+size_t PN5180EventParser::feed(const uint8_t *data, size_t len)
+{
+	uint64_t before = stats.frames;
+	stats.bytes += len;
+	while (len > 0)
+	{
+		if (pendingLen == 0)
+		{
+			size_t used = scan(data, len);
+			data += used;
+			len -= used;
+			memcpy(pending, data, len);
+			pendingLen = len;
+			break;
+		}
+		size_t take = sizeof(pending) - pendingLen;
+		if (take > len)
+			take = len;
+		memcpy(pending + pendingLen, data, take);
+		pendingLen += take;
+		data += take;
+		len -= take;
+		size_t used = scan(pending, pendingLen);
+		memmove(pending, pending + used, pendingLen - used);
+		pendingLen -= used;
+	}
+	return (size_t)(stats.frames - before);
+}
+
+/*
+ * Возвращает число обработанных байт; остаток — начало кадра, которому
+ * не хватает данных. После ошибки CRC поиск SOF продолжается со следующего байта.
+ */
+size_t PN5180EventParser::scan(const uint8_t *data, size_t len)
+{
+	size_t i = 0;
+	while (i < len)
+	{
+		if (data[i] != PN5180_EVENT_SOF)
+		{
+			const uint8_t *sof = (const uint8_t *)memchr(data + i, PN5180_EVENT_SOF, len - i);
+			size_t next = sof ? (size_t)(sof - data) : len;
+			stats.skipped += next - i;
+			i = next;
+			continue;
+		}
+		if (len - i < 2)
+			break;
+		uint8_t payloadLen = data[i + 1];
+		if (payloadLen > PN5180_EVENT_MAX_PAYLOAD)
+		{
+			stats.skipped++;
+			i++;
+			continue;
+		}
+		size_t total = PN5180_EVENT_HEADER_LEN + payloadLen + PN5180_EVENT_CRC_LEN;
+		if (len - i < total)
+			break;
+		uint16_t crc = pn5180EventCrc(data + i + 1, PN5180_EVENT_HEADER_LEN - 1 + payloadLen);
+		if (crc != (uint16_t)(data[i + total - 2] | (data[i + total - 1] << 8)))
+		{
+			stats.crcErrors++;
+			stats.skipped++;
+			i++;
+			continue;
+		}
+		deliver(data + i);
+		i += total;
+	}
+	return i;
+}
+
+void PN5180EventParser::deliver(const uint8_t *frame)
+{
+	PN5180Event event;
+	event.length = frame[1];
+	event.seq = frame[2];
+	event.type = frame[3];
+	memcpy(event.payload, frame + PN5180_EVENT_HEADER_LEN, event.length);
+	// HELLO — перезапуск устройства, SEQ начинается заново
+	if (lastSeq >= 0 && event.type != PN5180_EVENT_HELLO)
+		stats.lost += (uint8_t)(event.seq - lastSeq - 1);
+	lastSeq = event.seq;
+	stats.frames++;
+	if (handler)
+		handler(event, context);
+}
+
+bool pn5180DecodeCard(const PN5180Event &event, PN5180CardEvent *card)
+{
+	if ((event.type != PN5180_EVENT_CARD_ENTER && event.type != PN5180_EVENT_CARD_LEAVE) || event.length < 2)
+		return false;
+	card->technology = event.payload[0];
+	card->uidLength = event.payload[1];
+	if (card->uidLength > sizeof(card->uid) || event.length < 2 + card->uidLength)
+		return false;
+	memcpy(card->uid, event.payload + 2, card->uidLength);
+	card->hasTypeA = event.type == PN5180_EVENT_CARD_ENTER && event.length == 5 + card->uidLength;
+	if (card->hasTypeA)
+	{
+		card->atqa[0] = event.payload[2 + card->uidLength];
+		card->atqa[1] = event.payload[3 + card->uidLength];
+		card->sak = event.payload[4 + card->uidLength];
+	}
+	return true;
+}
+
+bool pn5180DecodeApdu(const PN5180Event &event, PN5180ApduEvent *apdu)
+{
+	if (event.type != PN5180_EVENT_APDU_RESULT || event.length != 5)
+		return false;
+	apdu->index = event.payload[0];
+	apdu->sw = (uint16_t)((event.payload[1] << 8) | event.payload[2]);
+	apdu->responseLength = (uint16_t)(event.payload[3] | (event.payload[4] << 8));
+	return true;
+}
+
+bool pn5180DecodeError(const PN5180Event &event, PN5180ErrorEvent *error)
+{
+	if (event.type != PN5180_EVENT_ERROR || event.length != 5)
+		return false;
+	error->code = event.payload[0];
+	error->detail = (uint32_t)event.payload[1] | ((uint32_t)event.payload[2] << 8) | ((uint32_t)event.payload[3] << 16) | ((uint32_t)event.payload[4] << 24);
+	return true;
+}
+
+size_t pn5180EncodeEvent(uint8_t type, uint8_t seq, const uint8_t *payload, uint8_t len, uint8_t *frame)
+{
+	if (len > PN5180_EVENT_MAX_PAYLOAD)
+		return 0;
+	frame[0] = PN5180_EVENT_SOF;
+	frame[1] = len;
+	frame[2] = seq;
+	frame[3] = type;
+	memcpy(frame + PN5180_EVENT_HEADER_LEN, payload, len);
+	uint16_t crc = pn5180EventCrc(frame + 1, PN5180_EVENT_HEADER_LEN - 1 + len);
+	frame[PN5180_EVENT_HEADER_LEN + len] = crc & 0xFF;
+	frame[PN5180_EVENT_HEADER_LEN + len + 1] = crc >> 8;
+	return PN5180_EVENT_HEADER_LEN + len + PN5180_EVENT_CRC_LEN;
+}
@@ -0,0 +1,99 @@
+// NAME: pn5180_event_parser.h
+//
+// DESC: Host-side parser for the binary card event stream (PN5180Events.h).
+//
+// This file is part of the PN5180 library for the Arduino environment.
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// Lesser General Public License for more details.
+//
+#ifndef PN5180_EVENT_PARSER_H
+#define PN5180_EVENT_PARSER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define PN5180_EVENTS_PROTOCOL_ONLY
+#include "PN5180Events.h"
+
+struct PN5180Event
+{
+  uint8_t type;
+  uint8_t seq;
+  uint8_t length;
+  uint8_t payload[PN5180_EVENT_MAX_PAYLOAD];
+};
+
+struct PN5180ParserStats
+{
+  uint64_t bytes;     // bytes fed
+  uint64_t frames;    // frames delivered
+  uint64_t skipped;   // bytes outside valid frames (noise, text, damaged frames)
+  uint64_t crcErrors; // frame candidates rejected by CRC
+  uint64_t lost;      // frames missing according to SEQ
+};
+
+typedef void (*PN5180EventHandler)(const PN5180Event &event, void *context);
+
+class PN5180EventParser
+{
+public:
+  PN5180EventParser(PN5180EventHandler handler, void *context = 0);
+
+  void reset();
+  // Accepts any split of the stream; returns the number of frames delivered
+  size_t feed(const uint8_t *data, size_t len);
+  const PN5180ParserStats &getStats() const;
+
+private:
+  PN5180EventHandler handler;
+  void *context;
+  PN5180ParserStats stats;
+  int lastSeq; // -1 = none yet
+  // Tail of the previous feed(): always shorter than one frame
+  uint8_t pending[2 * PN5180_EVENT_MAX_FRAME];
+  size_t pendingLen;
+
+  size_t scan(const uint8_t *data, size_t len);
+  void deliver(const uint8_t *frame);
+};
+
+// Decoded payloads; each returns false if the event has another type or is malformed
+struct PN5180CardEvent
+{
+  uint8_t technology;
+  uint8_t uidLength;
+  uint8_t uid[10];
+  bool hasTypeA; // ATQA and SAK valid (CARD_ENTER of a Type A card)
+  uint8_t atqa[2];
+  uint8_t sak;
+};
+
+struct PN5180ApduEvent
+{
+  uint8_t index;
+  uint16_t sw;
+  uint16_t responseLength;
+};
+
+struct PN5180ErrorEvent
+{
+  uint8_t code;
+  uint32_t detail;
+};
+
+bool pn5180DecodeCard(const PN5180Event &event, PN5180CardEvent *card);
+bool pn5180DecodeApdu(const PN5180Event &event, PN5180ApduEvent *apdu);
+bool pn5180DecodeError(const PN5180Event &event, PN5180ErrorEvent *error);
+
+// Builds a frame exactly like PN5180EventWriter; returns its length (0 if payload too long)
+size_t pn5180EncodeEvent(uint8_t type, uint8_t seq, const uint8_t *payload, uint8_t len, uint8_t *frame);
+
+#endif /* PN5180_EVENT_PARSER_H */
@@ -0,0 +1,128 @@
+// NAME: test_events.cpp
+//
+// DESC: Табличные тесты разбора потока событий (pn5180_event_parser.cpp) на хосте:
+//       каждый поток подаётся целиком, по одному байту и всеми разбиениями на две порции.
+//
+// Этот файл является частью библиотеки PN5180 для среды Arduino.
+//
+// Эта библиотека является свободным программным обеспечением; вы можете распространять и/или
+// изменять её на условиях Стандартной Общественной Лицензии GNU (LGPL) версии 2.1
+// либо (по вашему выбору) любой более поздней версии.
+//
+// Эта библиотека распространяется в надежде, что она будет полезной,
+// но БЕЗ КАКИХ-ЛИБО ГАРАНТИЙ; даже без подразумеваемой гарантии
+// КОММЕРЧЕСКОЙ ЦЕННОСТИ или ПРИГОДНОСТИ ДЛЯ ОПРЕДЕЛЕННОЙ ЦЕЛИ. Подробнее см. в
+// Стандартной Общественной Лицензии GNU.
+//
+//
+
+#include <stdio.h>
+#include <string>
+#include <vector>
+#include "pn5180_event_parser.h"
+
+struct EventsCase
+{
+	const char *name;
+	std::vector<uint8_t> stream;
+	std::string trace; // "<тип>/<seq>/<длина>;" на каждое событие
+	uint64_t crcErrors;
+	uint64_t lost;
+};
+
+static void onEvent(const PN5180Event &event, void *context)
+{
+	char line[32];
+	snprintf(line, sizeof(line), "%u/%u/%u;", event.type, event.seq, event.length);
+	*(std::string *)context += line;
+}
+
+static std::vector<uint8_t> frame(uint8_t type, uint8_t seq, const std::vector<uint8_t> &payload)
+{
+	uint8_t buffer[PN5180_EVENT_MAX_FRAME];
+	size_t n = pn5180EncodeEvent(type, seq, payload.data(), payload.size(), buffer);
+	return std::vector<uint8_t>(buffer, buffer + n);
+}
+
+static std::vector<uint8_t> operator+(std::vector<uint8_t> a, const std::vector<uint8_t> &b)
+{
+	a.insert(a.end(), b.begin(), b.end());
+	return a;
+}
+
+static std::vector<uint8_t> damaged(std::vector<uint8_t> frame, size_t pos)
+{
+	frame[pos] ^= 0x01;
+	return frame;
+}
+
+static bool check(const EventsCase &test, const std::vector<size_t> &splits, const char *how)
+{
+	std::string trace;
+	PN5180EventParser parser(onEvent, &trace);
+	size_t pos = 0;
+	for (size_t i = 0; i <= splits.size(); i++)
+	{
+		size_t end = i < splits.size() ? splits[i] : test.stream.size();
+		parser.feed(test.stream.data() + pos, end - pos);
+		pos = end;
+	}
+	const PN5180ParserStats &stats = parser.getStats();
+	if (trace == test.trace && stats.crcErrors == test.crcErrors && stats.lost == test.lost && stats.bytes == test.stream.size())
+		return true;
+	printf("FAIL %s (%s): crcErrors %llu, lost %llu\n  got      %s\n  expected %s\n", test.name, how,
+		   (unsigned long long)stats.crcErrors, (unsigned long long)stats.lost, trace.c_str(), test.trace.c_str());
+	return false;
+}
+
+int main()
+{
+	std::vector<uint8_t> enter = {0, 7, 0x04, 0xA1, 0xB2, 0xC3, 0xD4, 0xE5, 0xF6, 0x44, 0x00, 0x00};
+	std::vector<uint8_t> leave = {0, 4, 0xDE, 0xAD, 0xBE, 0xEF};
+	std::vector<uint8_t> maxPayload(PN5180_EVENT_MAX_PAYLOAD, 0xA5);
+
+	const std::vector<EventsCase> cases = {
+		{"single frame", frame(PN5180_EVENT_CARD_ENTER, 0, enter), "1/0/12;", 0, 0},
+		{"empty and maximum payload",
+		 frame(PN5180_EVENT_HELLO, 1, {}) + frame(PN5180_EVENT_ERROR, 2, maxPayload), "0/1/0;4/2/24;", 0, 0},
+		{"text and noise between frames",
+		 std::vector<uint8_t>{'o', 'k', '\r', '\n', 0xA5} + frame(PN5180_EVENT_CARD_ENTER, 3, enter) +
+			 std::vector<uint8_t>{0x00, 0xA5, 0x01} + frame(PN5180_EVENT_CARD_LEAVE, 4, leave),
+		 "1/3/12;2/4/6;", 1, 0}, // A5 01 перед кадром — кандидат с неверной CRC
+		{"damaged payload byte",
+		 frame(PN5180_EVENT_CARD_ENTER, 5, enter) + damaged(frame(PN5180_EVENT_CARD_LEAVE, 6, leave), 7) +
+			 frame(PN5180_EVENT_CARD_LEAVE, 7, leave),
+		 "1/5/12;2/7/6;", 1, 1},
+		{"damaged length byte",
+		 damaged(frame(PN5180_EVENT_CARD_ENTER, 8, enter), 1) + frame(PN5180_EVENT_CARD_LEAVE, 9, leave), "2/9/6;", 1, 0},
+		{"sequence gap and wrap",
+		 frame(PN5180_EVENT_CARD_LEAVE, 254, leave) + frame(PN5180_EVENT_CARD_LEAVE, 255, leave) +
+			 frame(PN5180_EVENT_CARD_LEAVE, 2, leave),
+		 "2/254/6;2/255/6;2/2/6;", 0, 2},
+		{"HELLO restarts the sequence",
+		 frame(PN5180_EVENT_CARD_LEAVE, 40, leave) + frame(PN5180_EVENT_HELLO, 0, {}) + frame(PN5180_EVENT_CARD_LEAVE, 1, leave),
+		 "2/40/6;0/0/0;2/1/6;", 0, 0},
+		{"truncated last frame", frame(PN5180_EVENT_HELLO, 10, {}) + std::vector<uint8_t>{0xA5, 0x02, 0x0B},
+		 "0/10/0;", 0, 0},
+	};
+
+	int failed = 0;
+	for (size_t c = 0; c < cases.size(); c++)
+	{
+		const EventsCase &test = cases[c];
+		bool ok = check(test, std::vector<size_t>(), "whole");
+		std::vector<size_t> bytewise;
+		for (size_t i = 1; i < test.stream.size(); i++)
+			bytewise.push_back(i);
+		ok = ok && check(test, bytewise, "byte by byte");
+		for (size_t split = 1; split < test.stream.size() && ok; split++)
+		{
+			char how[32];
+			snprintf(how, sizeof(how), "split at %zu", split);
+			ok = check(test, std::vector<size_t>(1, split), how);
+		}
+		failed += !ok;
+	}
+	printf("test_events: %zu cases, %d failed\n", cases.size(), failed);
+	return failed ? 1 : 0;
+}
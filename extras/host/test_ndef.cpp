@@ -0,0 +1,219 @@
+// NAME: test_ndef.cpp
+//
+// DESC: Табличные тесты потокового разбора NDEF (src/PN5180NDEF.cpp) на хосте.
+//       Каждый случай подаётся целиком и всеми разбиениями на две порции,
+//       а также по одному байту: события и итог должны совпадать.
+//
+// Этот файл является частью библиотеки PN5180 для среды Arduino.
+//
+// Эта библиотека является свободным программным обеспечением; вы можете распространять и/или
+// изменять её на условиях Стандартной Общественной Лицензии GNU (LGPL) версии 2.1
+// либо (по вашему выбору) любой более поздней версии.
+//
+// Эта библиотека распространяется в надежде, что она будет полезной,
+// но БЕЗ КАКИХ-ЛИБО ГАРАНТИЙ; даже без подразумеваемой гарантии
+// КОММЕРЧЕСКОЙ ЦЕННОСТИ или ПРИГОДНОСТИ ДЛЯ ОПРЕДЕЛЕННОЙ ЦЕЛИ. Подробнее см. в
+// Стандартной Общественной Лицензии GNU.
+//
+//
+
+#include <stdio.h>
+#include <string>
+#include <vector>
+#include "PN5180NDEF.h"
+
+struct NdefCase
+{
+	const char *name;
+	bool tlv;
+	std::vector<uint8_t> input;
+	uint8_t status;
+	std::string trace; // ожидаемые события, см. Trace
+	int abortAt;       // номер события, на котором обработчик возвращает false (-1 — никогда)
+};
+
+/*
+ * Запись событий в строку: "B<номер> <флаги> <тип> id<длина ID> len<длина>;" на начало записи,
+ * "E<номер> <полезная нагрузка>;" на конец. Полезная нагрузка собирается из всех порций,
+ * поэтому строка не зависит от разбиения входа; смещения порций проверяются по ходу.
+ */
+struct Trace
+{
+	std::string text;
+	std::string payload;
+	int events;
+	int abortAt;
+	bool offsetError;
+};
+
+static bool onRecord(uint8_t event, const NDEFRecord &record, const uint8_t *data, uint16_t len, void *context)
+{
+	Trace &trace = *(Trace *)context;
+	char line[96];
+	if (event == NDEF_EVENT_RECORD_BEGIN)
+	{
+		std::string type((const char *)record.type, record.typeLength < NDEF_MAX_TYPE_LEN ? record.typeLength : NDEF_MAX_TYPE_LEN);
+		snprintf(line, sizeof(line), "B%u %02X %s id%u len%u;", record.index, record.flags, type.c_str(), record.idLength,
+				 (unsigned)record.payloadLength);
+		trace.text += line;
+		trace.payload.clear();
+	}
+	else if (event == NDEF_EVENT_PAYLOAD)
+	{
+		if (record.payloadOffset != trace.payload.size())
+			trace.offsetError = true;
+		trace.payload.append((const char *)data, len);
+	}
+	else
+	{
+		if (trace.payload.size() != record.payloadLength)
+			trace.offsetError = true;
+		snprintf(line, sizeof(line), "E%u ", record.index);
+		trace.text += line + trace.payload + ";";
+	}
+	return trace.events++ != trace.abortAt;
+}
+
+// Строковый литерал без завершающего нуля; внутренние нули сохраняются
+template <size_t N>
+static std::vector<uint8_t> bytes(const char (&text)[N])
+{
+	return std::vector<uint8_t>(text, text + N - 1);
+}
+
+static std::vector<uint8_t> operator+(std::vector<uint8_t> a, const std::vector<uint8_t> &b)
+{
+	a.insert(a.end(), b.begin(), b.end());
+	return a;
+}
+
+static std::vector<uint8_t> longPayload()
+{
+	std::vector<uint8_t> payload;
+	for (int i = 0; i < 300; i++)
+		payload.push_back('a' + i % 26);
+	return payload;
+}
+
+// Подача input порциями по границам splits; возвращает итоговый статус
+static uint8_t run(const NdefCase &test, const std::vector<size_t> &splits, Trace &trace)
+{
+	NDEFParser parser;
+	trace.text.clear();
+	trace.payload.clear();
+	trace.events = 0;
+	trace.abortAt = test.abortAt;
+	trace.offsetError = false;
+	parser.begin(onRecord, &trace, test.tlv);
+	uint8_t status = NDEF_PARSE_MORE;
+	size_t pos = 0;
+	for (size_t i = 0; i <= splits.size(); i++)
+	{
+		size_t end = i < splits.size() ? splits[i] : test.input.size();
+		status = parser.feed(test.input.data() + pos, end - pos);
+		pos = end;
+	}
+	if (status != parser.getStatus())
+		trace.offsetError = true;
+	return status;
+}
+
+static bool check(const NdefCase &test, const std::vector<size_t> &splits, const char *how)
+{
+	Trace trace;
+	uint8_t status = run(test, splits, trace);
+	if (status == test.status && trace.text == test.trace && !trace.offsetError)
+		return true;
+	printf("FAIL %s (%s): status %u, expected %u%s\n  got      %s\n  expected %s\n", test.name, how, status, test.status,
+		   trace.offsetError ? ", payload offset mismatch" : "", trace.text.c_str(), test.trace.c_str());
+	return false;
+}
+
+int main()
+{
+	std::vector<uint8_t> lp = longPayload();
+	std::string lps(lp.begin(), lp.end());
+
+	const std::vector<NdefCase> cases = {
+		// TLV с коротким (1 байт) и длинным (0xFF + 2 байта) полем длины
+		{"short TLV, SR URI record", true,
+		 {0x03, 0x09, 0xD1, 0x01, 0x05, 'U', 0x04, 'a', 'b', 'c', 'd', 0xFE},
+		 NDEF_PARSE_DONE, "B0 D1 U id0 len5;E0 \x04" "abcd;", -1},
+		{"long TLV, 4-byte payload length", true,
+		 std::vector<uint8_t>{0x03, 0xFF, 0x01, 0x3C, 0xC2, 0x0A} + bytes("\x00\x00\x01\x2C") + bytes("text/plain") + lp,
+		 NDEF_PARSE_DONE, "B0 C2 text/plain id0 len300;E0 " + lps + ";", -1},
+		{"long TLV, SR record", true,
+		 {0x03, 0xFF, 0x00, 0x06, 0xD1, 0x01, 0x02, 'T', 'h', 'i'},
+		 NDEF_PARSE_DONE, "B0 D1 T id0 len2;E0 hi;", -1},
+
+		// Lock/Memory Control и NULL перед сообщением пропускаются, терминатор без сообщения
+		{"lock and memory control TLVs", true,
+		 {0x01, 0x03, 0xA0, 0x10, 0x44, 0x02, 0x03, 0x00, 0x00, 0x00, 0x00, 0x03, 0x05, 0xD1, 0x01, 0x01, 'U', 0x00},
+		 NDEF_PARSE_DONE, "B0 D1 U id0 len1;E0 " + std::string(1, '\0') + ";", -1},
+		{"proprietary TLV with long length", true,
+		 std::vector<uint8_t>{0xFD, 0xFF, 0x01, 0x00} + std::vector<uint8_t>(256, 0x55) + std::vector<uint8_t>{0x03, 0x03, 0xD0, 0x00, 0x00},
+		 NDEF_PARSE_DONE, "B0 D0  id0 len0;E0 ;", -1},
+		{"terminator only", true, {0xFE}, NDEF_PARSE_DONE, "", -1},
+		{"NULL TLVs then terminator", true, {0x00, 0x00, 0x01, 0x00, 0xFE, 0x03}, NDEF_PARSE_DONE, "", -1},
+		{"empty NDEF message TLV", true, {0x00, 0x03, 0x00, 0xFE}, NDEF_PARSE_DONE, "", -1},
+		{"incomplete TLV area", true, {0x03, 0x09, 0xD1, 0x01}, NDEF_PARSE_MORE, "", -1},
+
+		// Сочетания TNF, SR, IL и CF
+		{"empty record", true, {0x03, 0x03, 0xD0, 0x00, 0x00}, NDEF_PARSE_DONE, "B0 D0  id0 len0;E0 ;", -1},
+		{"ID present (IL) and two records", true,
+		 {0x03, 0x10, 0x99, 0x01, 0x02, 0x03, 'T', 'a', 'b', 'c', 'h', 'i', 0x51, 0x01, 0x01, 'U', 0x06, 0xFE},
+		 NDEF_PARSE_DONE, "B0 99 T id3 len2;E0 hi;B1 51 U id0 len1;E1 \x06;", -1},
+		{"IL with empty type, TLV too short", true,
+		 {0x03, 0x06, 0xDD, 0x00, 0x01, 0x02, 'x', 'y', 'z'},
+		 NDEF_PARSE_ERROR, "B0 DD  id2 len1;", -1},
+		{"IL with empty type and payload", true,
+		 {0x03, 0x07, 0xDD, 0x00, 0x01, 0x02, 'x', 'y', 'z'},
+		 NDEF_PARSE_DONE, "B0 DD  id2 len1;E0 z;", -1},
+		{"chunked record (CF, TNF unchanged)", true,
+		 {0x03, 0x14, 0xB2, 0x03, 0x02, 'a', '/', 'b', '1', '2', 0x36, 0x00, 0x02, '3', '4', 0x56, 0x00, 0x02, '5', '6', 0x00, 0x00},
+		 NDEF_PARSE_DONE, "B0 B2 a/b id0 len2;E0 12;B1 36  id0 len2;E1 34;B2 56  id0 len2;E2 56;", -1},
+		{"external type, long record", true,
+		 std::vector<uint8_t>{0x03, 0x0F, 0xC4, 0x06} + bytes("\x00\x00\x00\x03") + bytes("ex.com") + bytes("xyz"),
+		 NDEF_PARSE_DONE, "B0 C4 ex.com id0 len3;E0 xyz;", -1},
+		{"type longer than NDEF_MAX_TYPE_LEN", true,
+		 std::vector<uint8_t>{0x03, 0x16, 0xD2, 0x12, 0x01} + bytes("application/x-long") + bytes("!"),
+		 NDEF_PARSE_DONE, "B0 D2 application/x-lo id0 len1;E0 !;", -1},
+
+		// Ошибки
+		{"first record without MB", true, {0x03, 0x04, 0x51, 0x01, 0x00, 'U'}, NDEF_PARSE_ERROR, "", -1},
+		{"second record with MB", true,
+		 {0x03, 0x08, 0x91, 0x01, 0x00, 'U', 0xD1, 0x01, 0x00, 'U'},
+		 NDEF_PARSE_ERROR, "B0 91 U id0 len0;E0 ;", -1},
+		{"TLV ends before ME", true, {0x03, 0x04, 0x91, 0x01, 0x00, 'U', 0xFE}, NDEF_PARSE_ERROR, "B0 91 U id0 len0;E0 ;", -1},
+
+		// Сообщение без TLV (файл NDEF Type 4) и остановка обработчиком
+		{"raw message", false, {0xD1, 0x01, 0x03, 'T', 0x02, 'e', 'n', 0xAA}, NDEF_PARSE_DONE, "B0 D1 T id0 len3;E0 \x02" "en;", -1},
+		{"raw message, two records", false,
+		 {0x91, 0x01, 0x01, 'U', 0x01, 0x51, 0x01, 0x01, 'U', 0x02},
+		 NDEF_PARSE_DONE, "B0 91 U id0 len1;E0 \x01;B1 51 U id0 len1;E1 \x02;", -1},
+		{"aborted at record begin", false, {0xD1, 0x01, 0x01, 'U', 0x01}, NDEF_PARSE_ABORTED, "B0 D1 U id0 len1;", 0},
+		{"aborted at record end", false,
+		 {0x91, 0x01, 0x01, 'U', 0x01, 0x51, 0x01, 0x01, 'U', 0x02},
+		 NDEF_PARSE_ABORTED, "B0 91 U id0 len1;E0 \x01;", 2},
+	};
+
+	int failed = 0;
+	for (size_t c = 0; c < cases.size(); c++)
+	{
+		const NdefCase &test = cases[c];
+		bool ok = check(test, std::vector<size_t>(), "whole");
+		std::vector<size_t> bytewise;
+		for (size_t i = 1; i < test.input.size(); i++)
+			bytewise.push_back(i);
+		ok = ok && check(test, bytewise, "byte by byte");
+		for (size_t split = 1; split < test.input.size() && ok; split++)
+		{
+			char how[32];
+			snprintf(how, sizeof(how), "split at %zu", split);
+			ok = check(test, std::vector<size_t>(1, split), how);
+		}
+		failed += !ok;
+	}
+	printf("test_ndef: %zu cases, %d failed\n", cases.size(), failed);
+	return failed ? 1 : 0;
+}
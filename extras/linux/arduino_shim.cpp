@@ -0,0 +1,196 @@
+// NAME: arduino_shim.cpp
+//
+// DESC: Реализация минимального Arduino API для Linux поверх HalBackend.
+//
+// Этот файл является частью библиотеки PN5180 для среды Arduino.
+//
+// Эта библиотека является свободным программным обеспечением; вы можете распространять и/или
+// изменять её на условиях Стандартной Общественной Лицензии GNU (LGPL) версии 2.1
+// либо (по вашему выбору) любой более поздней версии.
+//
+// Эта библиотека распространяется в надежде, что она будет полезной,
+// но БЕЗ КАКИХ-ЛИБО ГАРАНТИЙ; даже без подразумеваемой гарантии
+// КОММЕРЧЕСКОЙ ЦЕННОСТИ или ПРИГОДНОСТИ ДЛЯ ОПРЕДЕЛЕННОЙ ЦЕЛИ. Подробнее см. в
+// Стандартной Общественной Лицензии GNU.
+//
+
+#include <Arduino.h>
+#include <SPI.h>
+#include <time.h>
+#include <stdlib.h>
+#include <mutex>
+#include <string>
+#include <thread>
+#include "hal_backend.h"
+
+HardwareSerial Serial;
+SPIClass SPI;
+
+static HalBackend *backend = 0;
+// NSS, опущенный этим потоком последним: каждый поток работает со своим считывателем
+static thread_local uint8_t activeNss = 0xFF;
+// Serial: строка собирается в потоке и выводится целиком
+static thread_local std::string serialLine;
+static std::mutex serialMutex;
+
+void setHalBackend(HalBackend *b)
+{
+	backend = b;
+}
+
+HalBackend *getHalBackend()
+{
+	return backend;
+}
+
+uint64_t monotonicNs()
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+void HalBackend::delayMs(unsigned long ms)
+{
+	std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+void HalBackend::delayUs(unsigned long us)
+{
+	std::this_thread::sleep_for(std::chrono::microseconds(us));
+}
+
+size_t Print::write(const uint8_t *buffer, size_t size)
+{
+	size_t n = 0;
+	while (size--)
+		n += write(*buffer++);
+	return n;
+}
+
+size_t Print::printNumber(unsigned long n, int base)
+{
+	char buf[8 * sizeof(long) + 1];
+	char *p = buf + sizeof(buf) - 1;
+	*p = 0;
+	if (base < 2)
+		base = 10;
+	do
+	{
+		unsigned long d = n % base;
+		n /= base;
+		*--p = (char)(d < 10 ? '0' + d : 'A' + d - 10);
+	} while (n);
+	return write(p);
+}
+
+size_t Print::printSigned(long n, int base)
+{
+	if (base == DEC && n < 0)
+		return print('-') + printNumber((unsigned long)-n, base);
+	return printNumber((unsigned long)n, base);
+}
+
+size_t Print::print(double n, int digits)
+{
+	char buf[32];
+	snprintf(buf, sizeof(buf), "%.*f", digits, n);
+	return write(buf);
+}
+
+size_t HardwareSerial::write(uint8_t c)
+{
+	serialLine.push_back((char)c);
+	if (c == '\n')
+		flush();
+	return 1;
+}
+
+size_t HardwareSerial::write(const uint8_t *buffer, size_t size)
+{
+	for (size_t i = 0; i < size; i++)
+		write(buffer[i]);
+	return size;
+}
+
+void HardwareSerial::flush()
+{
+	if (serialLine.empty())
+		return;
+	std::lock_guard<std::mutex> lock(serialMutex);
+	fwrite(serialLine.data(), 1, serialLine.size(), stdout);
+	fflush(stdout);
+	serialLine.clear();
+}
+
+void SPIClass::beginTransaction(SPISettings)
+{
+	backend->lockBus();
+}
+
+void SPIClass::endTransaction()
+{
+	backend->unlockBus();
+}
+
+uint8_t SPIClass::transfer(uint8_t data)
+{
+	return backend->transfer(activeNss, data);
+}
+
+void pinMode(uint8_t pin, uint8_t mode)
+{
+	backend->pinMode(pin, mode);
+}
+
+void digitalWrite(uint8_t pin, uint8_t value)
+{
+	if (value == LOW && backend->isChipSelect(pin))
+		activeNss = pin;
+	backend->digitalWrite(pin, value);
+}
+
+int digitalRead(uint8_t pin)
+{
+	return backend->digitalRead(pin);
+}
+
+unsigned long millis()
+{
+	return (unsigned long)(monotonicNs() / 1000000ULL);
+}
+
+unsigned long micros()
+{
+	return (unsigned long)(monotonicNs() / 1000ULL);
+}
+
+void delay(unsigned long ms)
+{
+	backend->delayMs(ms);
+}
+
+void delayMicroseconds(unsigned int us)
+{
+	backend->delayUs(us);
+}
+
+void yield()
+{
+	std::this_thread::yield();
+}
+
+long random(long max)
+{
+	return max > 0 ? ::random() % max : 0;
+}
+
+long random(long min, long max)
+{
+	return min + random(max - min);
+}
+
+void randomSeed(unsigned long seed)
+{
+	srandom(seed);
+}
@@ -0,0 +1,57 @@
+// NAME: hal_backend.h
+//
+// DESC: Pluggable GPIO/SPI backend behind the Linux Arduino shim.
+//
+// This file is part of the PN5180 library for the Arduino environment.
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// Lesser General Public License for more details.
+//
+#ifndef HAL_BACKEND_H
+#define HAL_BACKEND_H
+
+#include <stdint.h>
+
+// Pins of one PN5180 (GPIO line numbers for spidev, any unique numbers for the simulator)
+struct ReaderPins
+{
+  uint8_t nss;
+  uint8_t busy;
+  uint8_t rst;
+};
+
+class HalBackend
+{
+public:
+  virtual ~HalBackend() {}
+
+  virtual void pinMode(uint8_t pin, uint8_t mode) = 0;
+  virtual void digitalWrite(uint8_t pin, uint8_t value) = 0;
+  virtual int digitalRead(uint8_t pin) = 0;
+  virtual bool isChipSelect(uint8_t pin) const = 0;
+  // One byte on the SPI device selected by chip select line `nss`
+  virtual uint8_t transfer(uint8_t nss, uint8_t data) = 0;
+
+  // Called around every SPI transaction; a backend with one shared bus locks it here
+  virtual void lockBus() {}
+  virtual void unlockBus() {}
+
+  // delay() and delayMicroseconds() of the library; the simulator may shorten them
+  virtual void delayMs(unsigned long ms);
+  virtual void delayUs(unsigned long us);
+  // Time the simulated card entered the field of `reader` (ns, CLOCK_MONOTONIC), 0 = unknown
+  virtual uint64_t fieldEnterNs(uint8_t reader) const { (void)reader; return 0; }
+};
+
+void setHalBackend(HalBackend *backend);
+HalBackend *getHalBackend();
+uint64_t monotonicNs();
+
+#endif /* HAL_BACKEND_H */
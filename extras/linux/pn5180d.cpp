@@ -0,0 +1,566 @@
+// NAME: pn5180d.cpp
+//
+// DESC: Демон считывателей PN5180 для Linux: поток на каждый PN5180ISO14443,
+//       события карт через lock-free кольца SPMC в потоки-обработчики.
+//
+// Этот файл является частью библиотеки PN5180 для среды Arduino.
+//
+// Эта библиотека является свободным программным обеспечением; вы можете распространять и/или
+// изменять её на условиях Стандартной Общественной Лицензии GNU (LGPL) версии 2.1
+// либо (по вашему выбору) любой более поздней версии.
+//
+// Эта библиотека распространяется в надежде, что она будет полезной,
+// но БЕЗ КАКИХ-ЛИБО ГАРАНТИЙ; даже без подразумеваемой гарантии
+// КОММЕРЧЕСКОЙ ЦЕННОСТИ или ПРИГОДНОСТИ ДЛЯ ОПРЕДЕЛЕННОЙ ЦЕЛИ. Подробнее см. в
+// Стандартной Общественной Лицензии GNU.
+//
+//
+
+#include <Arduino.h>
+#include <PN5180.h>
+#include <PN5180ISO14443.h>
+#include <PN5180MultiReader.h>
+#include <pthread.h>
+#include <sched.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "hal_backend.h"
+#include "sim_backend.h"
+#include "spidev_backend.h"
+#include "spmc_ring.h"
+
+#define DAEMON_MAX_READERS 16
+#define DAEMON_RING_SIZE 1024
+// Сколько циклов подряд без ответа, прежде чем считать карту ушедшей
+#define DAEMON_LEAVE_MISSES 2
+// Пустые проходы обработчика до засыпания
+#define DAEMON_IDLE_SPINS 64
+#define DAEMON_IDLE_SLEEP_US 50
+
+#define EVENT_ENTER 1
+#define EVENT_LEAVE 2
+
+struct CardEvent
+{
+	uint64_t fieldNs;  // карта вошла в поле (только симулятор), 0 — неизвестно
+	uint64_t detectNs; // UID прочитан
+	uint64_t pushNs;   // событие в кольце
+	uint8_t reader;
+	uint8_t type;
+	uint8_t uidLength;
+	uint8_t uid[10];
+};
+
+struct Options
+{
+	int readers;
+	int consumers;
+	bool sim;
+	const char *device;
+	uint32_t speedHz;
+	std::vector<ReaderPins> pins;
+	std::vector<int> workerCpus;
+	std::vector<int> consumerCpus;
+	double delayScale;
+	int duration; // с, 0 — до сигнала
+	bool bench;
+	bool quiet;
+	bool multi; // все считыватели в одном потоке через PN5180MultiReader, как на одной плате Arduino
+};
+
+struct alignas(SPMC_CACHE_LINE) WorkerStats
+{
+	uint64_t cycles;
+	uint64_t events;
+	uint64_t drops;
+	uint64_t collisions; // ATQA с коллизией (только --multi)
+	bool ok;
+};
+
+struct alignas(SPMC_CACHE_LINE) ConsumerStats
+{
+	uint64_t events;
+	std::vector<uint64_t> queueNs;
+	std::vector<uint64_t> detectNs;
+};
+
+static std::atomic<bool> running(true);
+static std::atomic<bool> stopRequested(false);
+static std::atomic<int> workersDone(0);
+// Одно кольцо на считыватель: у каждого кольца ровно один производитель
+static SpmcRing<CardEvent, DAEMON_RING_SIZE> rings[DAEMON_MAX_READERS];
+static WorkerStats workerStats[DAEMON_MAX_READERS];
+
+static void onSignal(int)
+{
+	stopRequested.store(true);
+}
+
+static void pinThread(int cpu)
+{
+	if (cpu < 0)
+		return;
+	cpu_set_t set;
+	CPU_ZERO(&set);
+	CPU_SET(cpu, &set);
+	int err = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+	if (err != 0)
+		fprintf(stderr, "CPU %d: %s\n", cpu, strerror(err));
+}
+
+static int cpuFor(const std::vector<int> &cpus, int index)
+{
+	return cpus.empty() ? -1 : cpus[index % cpus.size()];
+}
+
+static void pushEvent(uint8_t reader, uint8_t type, const uint8_t *uid, uint8_t uidLength, uint64_t detectNs)
+{
+	CardEvent event;
+	HalBackend *backend = getHalBackend();
+	event.fieldNs = (type == EVENT_ENTER) ? backend->fieldEnterNs(reader) : 0;
+	event.detectNs = detectNs;
+	event.reader = reader;
+	event.type = type;
+	event.uidLength = uidLength;
+	memcpy(event.uid, uid, sizeof(event.uid));
+	event.pushNs = monotonicNs();
+	if (rings[reader].push(event))
+		workerStats[reader].events++;
+	else
+		workerStats[reader].drops++;
+}
+
+/*
+ * Поток считывателя: свой PN5180ISO14443, свой readBuffer (thread_local),
+ * цикл WUPA/антиколлизия/HALT. Карта в HALT отвечает на WUPA следующего цикла,
+ * поэтому присутствие проверяется без повторного чтения данных.
+ */
+static void workerMain(uint8_t index, ReaderPins pins, int cpu)
+{
+	pinThread(cpu);
+	WorkerStats &stats = workerStats[index];
+	PN5180ISO14443 nfc(pins.nss, pins.busy, pins.rst);
+	uint8_t startError = nfc.fastStart();
+	if (startError != PN5180_START_OK || !nfc.setupRF())
+	{
+		fprintf(stderr, "reader %u: PN5180 not found (start error %u)\n", index, startError);
+		workersDone++;
+		return;
+	}
+	stats.ok = true;
+
+	bool present = false;
+	uint8_t misses = 0;
+	uint8_t current[10];
+	uint8_t currentLength = 0;
+	while (running.load(std::memory_order_relaxed))
+	{
+		uint8_t uid[10];
+		uint8_t uidLength = nfc.cardDetect(uid);
+		uint64_t now = monotonicNs();
+		stats.cycles++;
+		if (uidLength > 0)
+		{
+			nfc.mifareHalt();
+			misses = 0;
+			if (present && (uidLength != currentLength || memcmp(uid + 3, current + 3, uidLength) != 0))
+			{
+				pushEvent(index, EVENT_LEAVE, current, currentLength, now);
+				present = false;
+			}
+			if (!present)
+			{
+				memcpy(current, uid, sizeof(current));
+				currentLength = uidLength;
+				present = true;
+				pushEvent(index, EVENT_ENTER, current, currentLength, now);
+			}
+		}
+		else if (present && ++misses >= DAEMON_LEAVE_MISSES)
+		{
+			present = false;
+			pushEvent(index, EVENT_LEAVE, current, currentLength, now);
+		}
+	}
+	nfc.setRF_off();
+	workersDone++;
+}
+
+// Карта в поле одного считывателя: ENTER при первом чтении, LEAVE после DAEMON_LEAVE_MISSES пустых циклов
+struct Presence
+{
+	bool present;
+	uint8_t misses;
+	uint8_t uid[10];
+	uint8_t uidLength;
+	uint32_t timeouts; // PN5180ReaderStats::timeouts на прошлом проходе
+};
+
+struct MultiContext
+{
+	PN5180MultiReader *multi;
+	Presence presence[MULTIREADER_MAX_READERS];
+};
+
+static void onMultiCard(uint8_t reader, uint8_t *buffer, uint8_t uidLength, void *context)
+{
+	MultiContext &ctx = *(MultiContext *)context;
+	Presence &p = ctx.presence[reader];
+	uint64_t now = monotonicNs();
+	ctx.multi->getReader(reader).mifareHalt();
+	p.misses = 0;
+	if (p.present && (uidLength != p.uidLength || memcmp(buffer + 3, p.uid + 3, uidLength) != 0))
+	{
+		pushEvent(reader, EVENT_LEAVE, p.uid, p.uidLength, now);
+		p.present = false;
+	}
+	if (!p.present)
+	{
+		memcpy(p.uid, buffer, sizeof(p.uid));
+		p.uidLength = uidLength;
+		p.present = true;
+		pushEvent(reader, EVENT_ENTER, p.uid, p.uidLength, now);
+	}
+}
+
+/*
+ * Все считыватели в одном потоке через PN5180MultiReader: WUPA уходит на все PN5180,
+ * ответы проверяются pollRx() по очереди — так же, как на одной плате Arduino с общей шиной.
+ */
+static void multiWorkerMain(int readers, std::vector<ReaderPins> pins, int cpu)
+{
+	pinThread(cpu);
+	PN5180MultiReader multi;
+	MultiContext ctx;
+	memset(&ctx, 0, sizeof(ctx));
+	ctx.multi = &multi;
+	std::vector<std::unique_ptr<PN5180ISO14443> > chips;
+	for (int i = 0; i < readers; i++)
+	{
+		chips.emplace_back(new PN5180ISO14443(pins[i].nss, pins[i].busy, pins[i].rst));
+		uint8_t startError = chips[i]->fastStart();
+		if (startError != PN5180_START_OK || !chips[i]->setupRF() || multi.add(*chips[i]) < 0)
+		{
+			fprintf(stderr, "reader %d: PN5180 not found (start error %u)\n", i, startError);
+			workersDone += readers;
+			return;
+		}
+		workerStats[i].ok = true;
+	}
+	multi.setCardHandler(onMultiCard, &ctx);
+
+	while (running.load(std::memory_order_relaxed))
+	{
+		multi.service();
+		for (int r = 0; r < readers; r++)
+		{
+			const PN5180ReaderStats &st = multi.getStats(r);
+			Presence &p = ctx.presence[r];
+			workerStats[r].cycles = st.polls;
+			workerStats[r].collisions = st.collisions;
+			if (st.timeouts == p.timeouts)
+				continue;
+			p.timeouts = st.timeouts;
+			if (p.present && ++p.misses >= DAEMON_LEAVE_MISSES)
+			{
+				p.present = false;
+				pushEvent(r, EVENT_LEAVE, p.uid, p.uidLength, monotonicNs());
+			}
+		}
+	}
+	for (int r = 0; r < readers; r++)
+		chips[r]->setRF_off();
+	workersDone += readers;
+}
+
+static void printEvent(const CardEvent &event, uint64_t now)
+{
+	char uid[32];
+	for (uint8_t i = 0; i < event.uidLength; i++)
+		snprintf(uid + 2 * i, sizeof(uid) - 2 * i, "%02X", event.uid[3 + i]);
+	printf("reader %u %s %s queue=%lluus\n", event.reader, event.type == EVENT_ENTER ? "ENTER" : "LEAVE", uid,
+		   (unsigned long long)((now - event.pushNs) / 1000));
+}
+
+// Поток-обработчик: забирает события из всех колец, начиная со своего
+static void consumerMain(int index, int readers, int cpu, ConsumerStats *stats, bool print)
+{
+	pinThread(cpu);
+	int idle = 0;
+	int start = index % readers;
+	for (;;)
+	{
+		// Производители остановлены до начала прохода — после него кольца точно пусты
+		bool done = workersDone.load() == readers;
+		bool got = false;
+		for (int i = 0; i < readers; i++)
+		{
+			CardEvent event;
+			if (!rings[(start + i) % readers].pop(event))
+				continue;
+			uint64_t now = monotonicNs();
+			got = true;
+			stats->events++;
+			stats->queueNs.push_back(now - event.pushNs);
+			if (event.fieldNs != 0 && event.detectNs > event.fieldNs)
+				stats->detectNs.push_back(event.detectNs - event.fieldNs);
+			if (print)
+				printEvent(event, now);
+		}
+		if (got)
+		{
+			idle = 0;
+			continue;
+		}
+		// Выходим после пустого прохода, начатого уже после остановки всех производителей:
+		// событие, положенное между пустым проходом и workersDone++, не теряется
+		if (done)
+			break;
+		if (++idle > DAEMON_IDLE_SPINS)
+			usleep(DAEMON_IDLE_SLEEP_US);
+	}
+}
+
+static uint64_t percentile(std::vector<uint64_t> &v, double p)
+{
+	if (v.empty())
+		return 0;
+	size_t i = (size_t)(p * (v.size() - 1));
+	return v[i];
+}
+
+/*
+ * Один прогон: workers + consumers на текущем backend до истечения duration
+ * или сигнала; печатает сводку. Возвращает false, если ни один считыватель не запустился.
+ */
+static bool run(const Options &opt, int readers, bool printEvents)
+{
+	running.store(true);
+	workersDone.store(0);
+	for (int i = 0; i < readers; i++)
+		memset(&workerStats[i], 0, sizeof(workerStats[i]));
+
+	std::vector<ConsumerStats> consumerStats(opt.consumers);
+	std::vector<std::thread> consumers;
+	std::vector<std::thread> workers;
+	uint64_t startNs = monotonicNs();
+	std::vector<ReaderPins> pins;
+	for (int i = 0; i < readers; i++)
+		pins.push_back(opt.sim ? SimBackend::pinsFor(i) : opt.pins[i]);
+	if (opt.multi)
+		workers.push_back(std::thread(multiWorkerMain, readers, pins, cpuFor(opt.workerCpus, 0)));
+	else
+	{
+		for (int i = 0; i < readers; i++)
+			workers.push_back(std::thread(workerMain, (uint8_t)i, pins[i], cpuFor(opt.workerCpus, i)));
+	}
+	for (int i = 0; i < opt.consumers; i++)
+		consumers.push_back(std::thread(consumerMain, i, readers, cpuFor(opt.consumerCpus, i), &consumerStats[i], printEvents));
+
+	uint64_t endNs = startNs + (uint64_t)opt.duration * 1000000000ULL;
+	while (!stopRequested.load() && (opt.duration == 0 || monotonicNs() < endNs) && workersDone.load() < readers)
+		usleep(10000);
+	running.store(false);
+	for (size_t i = 0; i < workers.size(); i++)
+		workers[i].join();
+	for (size_t i = 0; i < consumers.size(); i++)
+		consumers[i].join();
+	double seconds = (monotonicNs() - startNs) / 1e9;
+
+	uint64_t cycles = 0, events = 0, drops = 0, collisions = 0;
+	int ok = 0;
+	for (int i = 0; i < readers; i++)
+	{
+		cycles += workerStats[i].cycles;
+		events += workerStats[i].events;
+		drops += workerStats[i].drops;
+		collisions += workerStats[i].collisions;
+		ok += workerStats[i].ok ? 1 : 0;
+	}
+	std::vector<uint64_t> queue, detect;
+	for (int i = 0; i < opt.consumers; i++)
+	{
+		queue.insert(queue.end(), consumerStats[i].queueNs.begin(), consumerStats[i].queueNs.end());
+		detect.insert(detect.end(), consumerStats[i].detectNs.begin(), consumerStats[i].detectNs.end());
+	}
+	std::sort(queue.begin(), queue.end());
+	std::sort(detect.begin(), detect.end());
+	printf("%7d %10.0f %10.0f %8llu %8.1f %8.1f %8.1f %9.1f %9.2f %9.2f\n", readers, cycles / seconds / (readers ? readers : 1),
+		   events / seconds, (unsigned long long)drops, percentile(queue, 0.5) / 1e3, percentile(queue, 0.99) / 1e3,
+		   percentile(queue, 0.999) / 1e3, (queue.empty() ? 0 : queue.back()) / 1e3, percentile(detect, 0.5) / 1e6,
+		   percentile(detect, 0.99) / 1e6);
+	if (opt.multi)
+		printf("        ATQA collisions: %llu (activation continued)\n", (unsigned long long)collisions);
+	fflush(stdout);
+	return ok > 0;
+}
+
+static void printHeader()
+{
+	printf("readers  cycles/s   events/s    drops  q50(us)  q99(us) q999(us)   qmax(us) det50(ms) det99(ms)\n");
+}
+
+static std::vector<int> parseList(const char *s)
+{
+	std::vector<int> list;
+	while (*s)
+	{
+		char *end;
+		long v = strtol(s, &end, 0);
+		if (end == s)
+			break;
+		list.push_back((int)v);
+		s = (*end == ',') ? end + 1 : end;
+	}
+	return list;
+}
+
+static void usage()
+{
+	fprintf(stderr,
+			"pn5180d [options]\n"
+			"  --backend sim|spidev     simulated chips (default) or /dev/spidev + GPIO\n"
+			"  --device PATH            spidev device (default /dev/spidev0.0)\n"
+			"  --speed HZ               SPI clock (default 7000000)\n"
+			"  --pins NSS,BUSY,RST,...  GPIO lines, three per reader (spidev)\n"
+			"  --readers N              number of readers (sim, 1..%d)\n"
+			"  --consumers N            consumer threads (default 2)\n"
+			"  --worker-cpus LIST       pin reader threads, e.g. 2,3\n"
+			"  --consumer-cpus LIST     pin consumer threads\n"
+			"  --delay-scale X          sim: scale of library delay() (default 1.0)\n"
+			"  --duration S             stop after S seconds (default: until SIGINT)\n"
+			"  --quiet                  do not print events\n"
+			"  --multi                  poll all readers from one thread with PN5180MultiReader\n"
+			"  --bench                  sim benchmark over 1, 2, 4, 8 readers\n",
+			DAEMON_MAX_READERS);
+}
+
+int main(int argc, char **argv)
+{
+	Options opt;
+	opt.readers = 1;
+	opt.consumers = 2;
+	opt.sim = true;
+	opt.device = "/dev/spidev0.0";
+	opt.speedHz = 7000000;
+	opt.delayScale = -1.0;
+	opt.duration = 0;
+	opt.bench = false;
+	opt.quiet = false;
+	opt.multi = false;
+
+	for (int i = 1; i < argc; i++)
+	{
+		const char *arg = argv[i];
+		const char *val = (i + 1 < argc) ? argv[i + 1] : 0;
+		if (!strcmp(arg, "--bench"))
+			opt.bench = true;
+		else if (!strcmp(arg, "--quiet"))
+			opt.quiet = true;
+		else if (!strcmp(arg, "--multi"))
+			opt.multi = true;
+		else if (val == 0)
+		{
+			usage();
+			return 2;
+		}
+		else if (!strcmp(arg, "--backend"))
+			opt.sim = strcmp(val, "spidev") != 0, i++;
+		else if (!strcmp(arg, "--device"))
+			opt.device = val, i++;
+		else if (!strcmp(arg, "--speed"))
+			opt.speedHz = strtoul(val, 0, 0), i++;
+		else if (!strcmp(arg, "--readers"))
+			opt.readers = atoi(val), i++;
+		else if (!strcmp(arg, "--consumers"))
+			opt.consumers = atoi(val), i++;
+		else if (!strcmp(arg, "--worker-cpus"))
+			opt.workerCpus = parseList(val), i++;
+		else if (!strcmp(arg, "--consumer-cpus"))
+			opt.consumerCpus = parseList(val), i++;
+		else if (!strcmp(arg, "--delay-scale"))
+			opt.delayScale = atof(val), i++;
+		else if (!strcmp(arg, "--duration"))
+			opt.duration = atoi(val), i++;
+		else if (!strcmp(arg, "--pins"))
+		{
+			std::vector<int> list = parseList(val);
+			for (size_t p = 0; p + 2 < list.size(); p += 3)
+			{
+				ReaderPins pins = {(uint8_t)list[p], (uint8_t)list[p + 1], (uint8_t)list[p + 2]};
+				opt.pins.push_back(pins);
+			}
+			i++;
+		}
+		else
+		{
+			usage();
+			return 2;
+		}
+	}
+	if (!opt.sim)
+		opt.readers = (int)opt.pins.size();
+	if (opt.readers < 1 || opt.readers > DAEMON_MAX_READERS || opt.consumers < 1 ||
+		(opt.multi && opt.readers > MULTIREADER_MAX_READERS))
+	{
+		usage();
+		return 2;
+	}
+
+	// Короткая пауза вокруг NSS: темп команд задаёт BUSY, ответ карты дожидается waitForRx()
+	PN5180::nssGuardUs = PN5180_NSS_GUARD_FAST_US;
+	signal(SIGINT, onSignal);
+	signal(SIGTERM, onSignal);
+
+	if (opt.bench)
+	{
+		// Короткие визиты карт — много событий; задержки библиотеки в реальном времени:
+		// сон между командами не даёт потокам делить ядро вхолостую
+		SimScenario scenario = {20, 60, 10, 30, 7, 5};
+		if (opt.delayScale < 0)
+			opt.delayScale = 1.0;
+		if (opt.duration == 0)
+			opt.duration = 3;
+		printHeader();
+		int maxReaders = opt.multi ? MULTIREADER_MAX_READERS : 8;
+		for (int readers = 1; readers <= maxReaders && !stopRequested.load(); readers *= 2)
+		{
+			SimBackend sim(readers, scenario, opt.delayScale);
+			setHalBackend(&sim);
+			run(opt, readers, false);
+			setHalBackend(0);
+		}
+		return 0;
+	}
+
+	bool ok;
+	if (opt.sim)
+	{
+		SimScenario scenario = {500, 2000, 500, 3000, 7, 5};
+		SimBackend sim(opt.readers, scenario, opt.delayScale < 0 ? 1.0 : opt.delayScale);
+		setHalBackend(&sim);
+		printHeader();
+		ok = run(opt, opt.readers, !opt.quiet);
+	}
+	else
+	{
+		SpidevBackend spidev(opt.device, opt.speedHz);
+		if (!spidev.isOpen())
+			return 1;
+		for (size_t i = 0; i < opt.pins.size(); i++)
+			spidev.addChipSelect(opt.pins[i].nss);
+		setHalBackend(&spidev);
+		printHeader();
+		ok = run(opt, opt.readers, !opt.quiet);
+	}
+	setHalBackend(0);
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,419 @@
+// NAME: sim_backend.cpp
+//
+// DESC: Модель PN5180 (хост-интерфейс SPI, BUSY, регистры, IRQ) и карт ISO14443A
+//       для проверки демона и бенчмарков без железа.
+//
+// Этот файл является частью библиотеки PN5180 для среды Arduino.
+//
+// Эта библиотека является свободным программным обеспечением; вы можете распространять и/или
+// изменять её на условиях Стандартной Общественной Лицензии GNU (LGPL) версии 2.1
+// либо (по вашему выбору) любой более поздней версии.
+//
+// Эта библиотека распространяется в надежде, что она будет полезной,
+// но БЕЗ КАКИХ-ЛИБО ГАРАНТИЙ; даже без подразумеваемой гарантии
+// КОММЕРЧЕСКОЙ ЦЕННОСТИ или ПРИГОДНОСТИ ДЛЯ ОПРЕДЕЛЕННОЙ ЦЕЛИ. Подробнее см. в
+// Стандартной Общественной Лицензии GNU.
+//
+
+#include <Arduino.h>
+#include <PN5180.h>
+#include <chrono>
+#include <random>
+#include <thread>
+#include "sim_backend.h"
+
+// Состояния карты ISO14443-3
+enum
+{
+	CARD_IDLE,
+	CARD_READY,
+	CARD_READY2, // после первого уровня каскада 7-байтового UID
+	CARD_ACTIVE,
+	CARD_HALT
+};
+
+/*
+ * Один PN5180. Вызывается только из потока своего считывателя, поэтому без блокировок;
+ * атомарно только время появления карты (его читает поток-потребитель).
+ */
+class SimChip
+{
+public:
+	SimChip(uint8_t index, const SimScenario &scenario, double delayScale)
+		: rng(index * 7919 + 1), scenario(scenario), delayScale(delayScale)
+	{
+		nssLow = false;
+		rxPending = false;
+		frameLen = 0;
+		responseLen = 0;
+		presented = 0;
+		enterNs = 0;
+		powerOn();
+		nextChangeNs = monotonicNs() + pick(scenario.gapMinMs, scenario.gapMaxMs) * 1000000ULL;
+		present = false;
+		cardState = CARD_IDLE;
+	}
+
+	void powerOn()
+	{
+		memset(regs, 0, sizeof(regs));
+		memset(eeprom, 0, sizeof(eeprom));
+		eeprom[PRODUCT_VERSION] = 0x00;
+		eeprom[PRODUCT_VERSION + 1] = 0x04;
+		eeprom[FIRMWARE_VERSION] = 0x00;
+		eeprom[FIRMWARE_VERSION + 1] = 0x04;
+		eeprom[EEPROM_VERSION] = 0x99;
+		regs[IRQ_STATUS] = IDLE_IRQ_STAT;
+	}
+
+	// BUSY: высокий, пока хост держит NSS после переданных байт
+	int busy() const
+	{
+		return (nssLow && frameLen > 0) ? HIGH : LOW;
+	}
+
+	// Опущенный NSS начинает кадр команды либо, если ответ ждёт, кадр чтения;
+	// подъём NSS выполняет команду или снимает прочитанный ответ
+	void select(bool low)
+	{
+		if (low)
+		{
+			nssLow = true;
+			frameLen = 0;
+			responsePos = 0;
+			return;
+		}
+		nssLow = false;
+		if (frameLen == 0)
+			return;
+		if (responseLen > 0)
+			responseLen = 0;
+		else
+			execute();
+		frameLen = 0;
+	}
+
+	uint8_t transfer(uint8_t data)
+	{
+		frameLen++;
+		if (responseLen > 0)
+			return (responsePos < responseLen) ? response[responsePos++] : 0xFF;
+		if (frameLen <= sizeof(frame))
+			frame[frameLen - 1] = data;
+		return 0xFF;
+	}
+
+	void reset()
+	{
+		powerOn();
+		responseLen = 0;
+		frameLen = 0;
+	}
+
+	uint64_t fieldEnter() const
+	{
+		return enterNs.load(std::memory_order_acquire);
+	}
+
+	uint64_t presented;
+
+private:
+	std::mt19937 rng;
+	SimScenario scenario;
+	bool nssLow;
+	uint8_t frame[272];
+	uint16_t frameLen;
+	uint8_t response[512];
+	uint16_t responseLen;
+	uint16_t responsePos;
+	uint32_t regs[0x40];
+	uint8_t eeprom[0x100];
+	uint8_t rx[64];
+	uint16_t rxLen;
+	double delayScale;
+	// Ответ карты ещё в эфире: в буфер приёма и IRQ_STATUS он попадёт в rxDueNs
+	uint8_t air[64];
+	uint16_t airLen;
+	bool airCollision;
+	bool rxPending;
+	uint64_t rxDueNs;
+
+	bool present;
+	uint64_t nextChangeNs;
+	std::atomic<uint64_t> enterNs;
+	uint8_t uid[7];
+	uint8_t cardState;
+
+	uint32_t pick(uint32_t lo, uint32_t hi)
+	{
+		return (hi > lo) ? lo + rng() % (hi - lo + 1) : lo;
+	}
+
+	// Карта входит в поле и уходит по сценарию
+	void updateField()
+	{
+		uint64_t now = monotonicNs();
+		if (now < nextChangeNs)
+			return;
+		present = !present;
+		if (present)
+		{
+			uid[0] = 0x04; // NXP
+			for (int i = 1; i < 7; i++)
+				uid[i] = rng() & 0xFF;
+			cardState = CARD_IDLE;
+			presented++;
+			enterNs.store(nextChangeNs, std::memory_order_release);
+			nextChangeNs += pick(scenario.dwellMinMs, scenario.dwellMaxMs) * 1000000ULL;
+		}
+		else
+		{
+			nextChangeNs += pick(scenario.gapMinMs, scenario.gapMaxMs) * 1000000ULL;
+		}
+		if (nextChangeNs < now)
+			nextChangeNs = now;
+	}
+
+	uint32_t reg32(const uint8_t *p) const
+	{
+		return p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+	}
+
+	void respond(const uint8_t *data, uint16_t len)
+	{
+		memcpy(response, data, len);
+		responseLen = len;
+		responsePos = 0;
+	}
+
+	void writeReg(uint8_t addr, uint32_t value)
+	{
+		if (addr == IRQ_CLEAR)
+			regs[IRQ_STATUS] &= ~value;
+		else if (addr < 0x40)
+			regs[addr] = value;
+	}
+
+	void execute()
+	{
+		receive();
+		switch (frame[0])
+		{
+		case 0x00: // WRITE_REGISTER
+			writeReg(frame[1], reg32(frame + 2));
+			break;
+		case 0x01: // WRITE_REGISTER_OR_MASK
+			writeReg(frame[1], (frame[1] < 0x40 ? regs[frame[1]] : 0) | reg32(frame + 2));
+			break;
+		case 0x02: // WRITE_REGISTER_AND_MASK
+			writeReg(frame[1], (frame[1] < 0x40 ? regs[frame[1]] : 0) & reg32(frame + 2));
+			break;
+		case 0x04: // READ_REGISTER
+		{
+			uint32_t v = (frame[1] < 0x40) ? regs[frame[1]] : 0;
+			if (frame[1] == RF_STATUS)
+				v = ((regs[SYSTEM_CONFIG] & 0x07) == 0x03) ? (1UL << 24) : 0; // WaitTransmit
+			uint8_t out[4] = {(uint8_t)v, (uint8_t)(v >> 8), (uint8_t)(v >> 16), (uint8_t)(v >> 24)};
+			respond(out, 4);
+			break;
+		}
+		case 0x06: // WRITE_EEPROM
+			memcpy(eeprom + frame[1], frame + 2, frameLen - 2);
+			break;
+		case 0x07: // READ_EEPROM
+			respond(eeprom + frame[1], frame[2]);
+			break;
+		case 0x09: // SEND_DATA
+			sendData(frame + 2, frameLen - 2, frame[1]);
+			break;
+		case 0x0A: // READ_DATA
+			respond(rx, sizeof(rx));
+			break;
+		case 0x0C: // MIFARE_AUTHENTICATE
+		{
+			uint8_t ok = 0;
+			respond(&ok, 1);
+			break;
+		}
+		case 0x16: // RF_ON
+			regs[IRQ_STATUS] |= TX_RFON_IRQ_STAT;
+			break;
+		case 0x17: // RF_OFF
+			regs[IRQ_STATUS] |= TX_RFOFF_IRQ_STAT;
+			break;
+		default: // LOAD_RF_CONFIG и прочее — без эффекта
+			break;
+		}
+	}
+
+	/*
+	 * Обмен с картой. Ответ приходит не сразу, а через время ожидания кадра
+	 * (1236 / fc) и время передачи (9 бит на байт, 128 / fc на бит) в масштабе
+	 * задержек: READ_DATA раньше этого вернёт прежний кадр, как у PN5180.
+	 */
+	void sendData(const uint8_t *data, uint16_t len, uint8_t validBits)
+	{
+		receive();
+		// Поле меняется только между активациями: REQA/WUPA начинает новый цикл
+		if (len == 1 && validBits == 7)
+			updateField();
+		airLen = present ? cardExchange(data, len, validBits) : 0;
+		// Вторая карта отвечает на REQA/WUPA тем же кадром: ATQA с коллизией битов
+		airCollision = airLen > 0 && len == 1 && validBits == 7 && rng() % 100 < scenario.atqaCollisionPercent;
+		regs[IRQ_STATUS] |= TX_IRQ_STAT;
+		uint64_t cycles = 1236 + (uint64_t)airLen * 9 * 128;
+		rxDueNs = monotonicNs() + (uint64_t)(cycles * 1000 / 13.56 * (delayScale > 0.0 ? delayScale : 0.0));
+		rxPending = true;
+		receive();
+	}
+
+	// Ответ, время которого пришло, — в буфер приёма, IRQ и RX_STATUS как у PN5180
+	void receive()
+	{
+		if (!rxPending || monotonicNs() < rxDueNs)
+			return;
+		rxPending = false;
+		rxLen = airLen;
+		if (rxLen > 0)
+		{
+			memcpy(rx, air, rxLen);
+			regs[IRQ_STATUS] |= RX_IRQ_STAT | RX_SOF_DET_IRQ_STAT;
+			regs[RX_STATUS] = rxLen;
+			if (airCollision)
+				regs[RX_STATUS] |= RX_COLLISION_DETECTED;
+		}
+		else
+		{
+			regs[RX_STATUS] = 0;
+			if (regs[TIMER1_CONFIG] & TIMER_CONFIG_ENABLE)
+				regs[IRQ_STATUS] |= TIMER1_IRQ_STAT;
+		}
+	}
+
+	uint16_t cardExchange(const uint8_t *data, uint16_t len, uint8_t validBits)
+	{
+		bool sevenByte = scenario.uidLength == 7;
+		if (len == 1 && validBits == 7 && (data[0] == 0x52 || (data[0] == 0x26 && cardState != CARD_HALT)))
+		{
+			cardState = CARD_READY;
+			air[0] = sevenByte ? 0x44 : 0x04;
+			air[1] = 0x00;
+			return 2;
+		}
+		if (len == 2 && data[0] == 0x50 && data[1] == 0x00)
+		{
+			cardState = CARD_HALT;
+			return 0;
+		}
+		if (len == 2 && data[1] == 0x20 && ((data[0] == 0x93 && cardState == CARD_READY) || (data[0] == 0x95 && cardState == CARD_READY2)))
+		{
+			const uint8_t *part = uid + ((data[0] == 0x95) ? 3 : 0);
+			if (data[0] == 0x93 && sevenByte)
+			{
+				air[0] = 0x88;
+				memcpy(air + 1, uid, 3);
+			}
+			else
+			{
+				memcpy(air, part, 4);
+			}
+			air[4] = air[0] ^ air[1] ^ air[2] ^ air[3];
+			return 5;
+		}
+		if (len == 7 && data[1] == 0x70 && ((data[0] == 0x93 && cardState == CARD_READY) || (data[0] == 0x95 && cardState == CARD_READY2)))
+		{
+			if (data[0] == 0x93 && sevenByte)
+			{
+				cardState = CARD_READY2;
+				air[0] = 0x04; // UID не полный
+			}
+			else
+			{
+				cardState = CARD_ACTIVE;
+				air[0] = 0x00; // Ultralight
+			}
+			return 1;
+		}
+		// Неожиданная команда: карта возвращается в IDLE (или остаётся в HALT)
+		if (cardState != CARD_HALT)
+			cardState = CARD_IDLE;
+		return 0;
+	}
+};
+
+SimBackend::SimBackend(uint8_t readers, const SimScenario &scenario, double delayScale)
+	: delayScale(delayScale)
+{
+	for (uint8_t i = 0; i < readers; i++)
+		chips.push_back(new SimChip(i, scenario, delayScale));
+}
+
+SimBackend::~SimBackend()
+{
+	for (size_t i = 0; i < chips.size(); i++)
+		delete chips[i];
+}
+
+ReaderPins SimBackend::pinsFor(uint8_t reader)
+{
+	ReaderPins pins = {(uint8_t)(3 * reader), (uint8_t)(3 * reader + 1), (uint8_t)(3 * reader + 2)};
+	return pins;
+}
+
+void SimBackend::pinMode(uint8_t, uint8_t)
+{
+}
+
+void SimBackend::digitalWrite(uint8_t pin, uint8_t value)
+{
+	SimChip *chip = chips[pin / 3];
+	if (pin % 3 == 0)
+	{
+		chip->select(value == LOW);
+	}
+	else if (pin % 3 == 2 && value == HIGH)
+	{
+		chip->reset();
+	}
+}
+
+int SimBackend::digitalRead(uint8_t pin)
+{
+	return (pin % 3 == 1) ? chips[pin / 3]->busy() : LOW;
+}
+
+bool SimBackend::isChipSelect(uint8_t pin) const
+{
+	return pin % 3 == 0 && pin / 3 < chips.size();
+}
+
+uint8_t SimBackend::transfer(uint8_t nss, uint8_t data)
+{
+	return chips[nss / 3]->transfer(data);
+}
+
+// Масштаб задержек библиотеки: 0 — без ожидания (бенчмарк очереди событий)
+void SimBackend::delayMs(unsigned long ms)
+{
+	delayUs(ms * 1000);
+}
+
+void SimBackend::delayUs(unsigned long us)
+{
+	if (delayScale <= 0.0)
+		return;
+	std::this_thread::sleep_for(std::chrono::microseconds((uint64_t)(us * delayScale)));
+}
+
+uint64_t SimBackend::fieldEnterNs(uint8_t reader) const
+{
+	return chips[reader]->fieldEnter();
+}
+
+uint64_t SimBackend::cardsPresented() const
+{
+	uint64_t n = 0;
+	for (size_t i = 0; i < chips.size(); i++)
+		n += chips[i]->presented;
+	return n;
+}
@@ -0,0 +1,63 @@
+// NAME: sim_backend.h
+//
+// DESC: Simulated PN5180 chips with ISO14443A cards for tests and benchmarks.
+//
+// This file is part of the PN5180 library for the Arduino environment.
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// Lesser General Public License for more details.
+//
+#ifndef SIM_BACKEND_H
+#define SIM_BACKEND_H
+
+#include <stdint.h>
+#include <atomic>
+#include <vector>
+#include "hal_backend.h"
+
+// Card traffic in front of one simulated reader: a new card every gap, staying for dwell
+struct SimScenario
+{
+  uint32_t dwellMinMs;
+  uint32_t dwellMaxMs;
+  uint32_t gapMinMs;
+  uint32_t gapMaxMs;
+  uint8_t uidLength; // 4 or 7
+  uint8_t atqaCollisionPercent; // ATQA answers flagged as a bit collision (a second card in the field)
+};
+
+class SimChip;
+
+class SimBackend : public HalBackend
+{
+public:
+  // Reader i uses pins 3*i (NSS), 3*i+1 (BUSY), 3*i+2 (RST), see pinsFor()
+  SimBackend(uint8_t readers, const SimScenario &scenario, double delayScale);
+  ~SimBackend();
+
+  static ReaderPins pinsFor(uint8_t reader);
+
+  void pinMode(uint8_t pin, uint8_t mode);
+  void digitalWrite(uint8_t pin, uint8_t value);
+  int digitalRead(uint8_t pin);
+  bool isChipSelect(uint8_t pin) const;
+  uint8_t transfer(uint8_t nss, uint8_t data);
+  void delayMs(unsigned long ms);
+  void delayUs(unsigned long us);
+  uint64_t fieldEnterNs(uint8_t reader) const;
+
+  uint64_t cardsPresented() const;
+
+private:
+  std::vector<SimChip *> chips;
+  double delayScale;
+};
+
+#endif /* SIM_BACKEND_H */
@@ -0,0 +1,157 @@
+// NAME: spidev_backend.cpp
+//
+// DESC: Доступ к PN5180 через Linux spidev (SPI_NO_CS) и GPIO sysfs.
+//
+// Этот файл является частью библиотеки PN5180 для среды Arduino.
+//
+// Эта библиотека является свободным программным обеспечением; вы можете распространять и/или
+// изменять её на условиях Стандартной Общественной Лицензии GNU (LGPL) версии 2.1
+// либо (по вашему выбору) любой более поздней версии.
+//
+// Эта библиотека распространяется в надежде, что она будет полезной,
+// но БЕЗ КАКИХ-ЛИБО ГАРАНТИЙ; даже без подразумеваемой гарантии
+// КОММЕРЧЕСКОЙ ЦЕННОСТИ или ПРИГОДНОСТИ ДЛЯ ОПРЕДЕЛЕННОЙ ЦЕЛИ. Подробнее см. в
+// Стандартной Общественной Лицензии GNU.
+//
+//
+
+#include <Arduino.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <linux/spi/spidev.h>
+#include "spidev_backend.h"
+
+SpidevBackend::SpidevBackend(const char *device, uint32_t speedHz)
+	: speedHz(speedHz)
+{
+	for (int i = 0; i < SPIDEV_MAX_GPIO; i++)
+	{
+		gpioFd[i] = -1;
+		chipSelect[i] = false;
+	}
+	spiFd = open(device, O_RDWR);
+	if (spiFd < 0)
+	{
+		perror(device);
+		return;
+	}
+	// NSS управляется через GPIO: транзакция PN5180 длиннее одного ioctl
+	uint8_t mode = SPI_MODE_0 | SPI_NO_CS;
+	uint8_t bits = 8;
+	if (ioctl(spiFd, SPI_IOC_WR_MODE, &mode) < 0 || ioctl(spiFd, SPI_IOC_WR_BITS_PER_WORD, &bits) < 0 || ioctl(spiFd, SPI_IOC_WR_MAX_SPEED_HZ, &speedHz) < 0)
+	{
+		perror("spidev ioctl");
+		close(spiFd);
+		spiFd = -1;
+	}
+}
+
+SpidevBackend::~SpidevBackend()
+{
+	for (int i = 0; i < SPIDEV_MAX_GPIO; i++)
+		if (gpioFd[i] >= 0)
+			close(gpioFd[i]);
+	if (spiFd >= 0)
+		close(spiFd);
+}
+
+bool SpidevBackend::isOpen() const
+{
+	return spiFd >= 0;
+}
+
+void SpidevBackend::addChipSelect(uint8_t pin)
+{
+	chipSelect[pin] = true;
+}
+
+/*
+ * Экспорт линии через /sys/class/gpio и открытие её value.
+ * Файл держится открытым: чтение BUSY в цикле ожидания — один pread().
+ */
+int SpidevBackend::openGpio(uint8_t pin, bool output)
+{
+	char path[64];
+	int fd = open("/sys/class/gpio/export", O_WRONLY);
+	if (fd >= 0)
+	{
+		int n = snprintf(path, sizeof(path), "%u", pin);
+		if (write(fd, path, n) < 0)
+		{
+			// уже экспортирована
+		}
+		close(fd);
+	}
+	snprintf(path, sizeof(path), "/sys/class/gpio/gpio%u/direction", pin);
+	fd = open(path, O_WRONLY);
+	if (fd >= 0)
+	{
+		const char *dir = output ? "out" : "in";
+		if (write(fd, dir, strlen(dir)) < 0)
+			perror(path);
+		close(fd);
+	}
+	snprintf(path, sizeof(path), "/sys/class/gpio/gpio%u/value", pin);
+	fd = open(path, output ? O_RDWR : O_RDONLY);
+	if (fd < 0)
+		perror(path);
+	return fd;
+}
+
+void SpidevBackend::pinMode(uint8_t pin, uint8_t mode)
+{
+	if (gpioFd[pin] >= 0)
+		close(gpioFd[pin]);
+	gpioFd[pin] = openGpio(pin, mode == OUTPUT);
+}
+
+void SpidevBackend::digitalWrite(uint8_t pin, uint8_t value)
+{
+	if (gpioFd[pin] < 0)
+		return;
+	char c = (value == LOW) ? '0' : '1';
+	if (pwrite(gpioFd[pin], &c, 1, 0) < 0)
+		perror("gpio write");
+}
+
+int SpidevBackend::digitalRead(uint8_t pin)
+{
+	char c = '0';
+	if (gpioFd[pin] < 0 || pread(gpioFd[pin], &c, 1, 0) != 1)
+		return LOW;
+	return (c == '1') ? HIGH : LOW;
+}
+
+bool SpidevBackend::isChipSelect(uint8_t pin) const
+{
+	return chipSelect[pin];
+}
+
+uint8_t SpidevBackend::transfer(uint8_t, uint8_t data)
+{
+	uint8_t rx = 0xFF;
+	struct spi_ioc_transfer tr;
+	memset(&tr, 0, sizeof(tr));
+	tr.tx_buf = (unsigned long)&data;
+	tr.rx_buf = (unsigned long)&rx;
+	tr.len = 1;
+	tr.speed_hz = speedHz;
+	tr.bits_per_word = 8;
+	if (ioctl(spiFd, SPI_IOC_MESSAGE(1), &tr) < 1)
+		perror("spidev transfer");
+	return rx;
+}
+
+// Транзакция библиотеки (beginTransaction..endTransaction) захватывает общую шину целиком
+void SpidevBackend::lockBus()
+{
+	bus.lock();
+}
+
+void SpidevBackend::unlockBus()
+{
+	bus.unlock();
+}
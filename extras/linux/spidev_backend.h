@@ -0,0 +1,56 @@
+// NAME: spidev_backend.h
+//
+// DESC: Linux spidev + sysfs GPIO backend for PN5180 boards on a shared SPI bus.
+//
+// This file is part of the PN5180 library for the Arduino environment.
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// Lesser General Public License for more details.
+//
+#ifndef SPIDEV_BACKEND_H
+#define SPIDEV_BACKEND_H
+
+#include <stdint.h>
+#include <mutex>
+#include "hal_backend.h"
+
+#define SPIDEV_MAX_GPIO 256
+
+class SpidevBackend : public HalBackend
+{
+public:
+  // device: e.g. /dev/spidev0.0 (opened with SPI_NO_CS, NSS lines are GPIOs)
+  SpidevBackend(const char *device, uint32_t speedHz);
+  ~SpidevBackend();
+
+  bool isOpen() const;
+  // Marks a GPIO line as chip select of one reader
+  void addChipSelect(uint8_t pin);
+
+  void pinMode(uint8_t pin, uint8_t mode);
+  void digitalWrite(uint8_t pin, uint8_t value);
+  int digitalRead(uint8_t pin);
+  bool isChipSelect(uint8_t pin) const;
+  uint8_t transfer(uint8_t nss, uint8_t data);
+  void lockBus();
+  void unlockBus();
+
+private:
+  int spiFd;
+  uint32_t speedHz;
+  int gpioFd[SPIDEV_MAX_GPIO];
+  bool chipSelect[SPIDEV_MAX_GPIO];
+  // All readers share one SPI controller: one library transaction owns it at a time
+  std::recursive_mutex bus;
+
+  int openGpio(uint8_t pin, bool output);
+};
+
+#endif /* SPIDEV_BACKEND_H */
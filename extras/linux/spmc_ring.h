@@ -0,0 +1,94 @@
+// NAME: spmc_ring.h
+//
+// DESC: Bounded lock-free single-producer/multi-consumer ring.
+//
+// This file is part of the PN5180 library for the Arduino environment.
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// Lesser General Public License for more details.
+//
+#ifndef SPMC_RING_H
+#define SPMC_RING_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <atomic>
+
+#define SPMC_CACHE_LINE 64
+
+/*
+ * Every slot carries a sequence number (Vyukov bounded queue): the producer
+ * publishes slot i by setting seq = i + 1, a consumer claims it with one CAS on
+ * head and releases it with seq = i + Size. The producer never touches head and
+ * never waits; a full ring makes push() fail so a slow consumer cannot stall a reader.
+ * Size must be a power of two.
+ */
+template <typename T, size_t Size>
+class SpmcRing
+{
+public:
+  SpmcRing() : head(0), tail(0)
+  {
+    static_assert((Size & (Size - 1)) == 0, "Size must be a power of two");
+    for (size_t i = 0; i < Size; i++)
+      slots[i].seq.store(i, std::memory_order_relaxed);
+  }
+
+  // Producer thread only
+  bool push(const T &item)
+  {
+    size_t pos = tail.load(std::memory_order_relaxed);
+    Slot &slot = slots[pos & (Size - 1)];
+    if (slot.seq.load(std::memory_order_acquire) != pos)
+      return false; // full
+    slot.item = item;
+    slot.seq.store(pos + 1, std::memory_order_release);
+    tail.store(pos + 1, std::memory_order_relaxed);
+    return true;
+  }
+
+  // Any thread
+  bool pop(T &item)
+  {
+    size_t pos = head.load(std::memory_order_relaxed);
+    for (;;)
+    {
+      Slot &slot = slots[pos & (Size - 1)];
+      size_t seq = slot.seq.load(std::memory_order_acquire);
+      intptr_t diff = (intptr_t)seq - (intptr_t)(pos + 1);
+      if (diff == 0)
+      {
+        if (head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+        {
+          item = slot.item;
+          slot.seq.store(pos + Size, std::memory_order_release);
+          return true;
+        }
+      }
+      else if (diff < 0)
+        return false; // empty
+      else
+        pos = head.load(std::memory_order_relaxed);
+    }
+  }
+
+private:
+  struct Slot
+  {
+    std::atomic<size_t> seq;
+    T item;
+  };
+
+  alignas(SPMC_CACHE_LINE) std::atomic<size_t> head;
+  alignas(SPMC_CACHE_LINE) std::atomic<size_t> tail;
+  alignas(SPMC_CACHE_LINE) Slot slots[Size];
+};
+
+#endif /* SPMC_RING_H */
@@ -19,8 +19,11 @@
 #ifndef DEBUG_H
 #define DEBUG_H
 
+// Text output of the library, see pn5180Log in PN5180.h
+#define PN5180LOG (*pn5180Log)
+
 #ifdef DEBUG
-#define PN5180DEBUG(msg) Serial.print(msg)
+#define PN5180DEBUG(msg) pn5180Log->print(msg)
 #else
 #define PN5180DEBUG(msg)
 #endif
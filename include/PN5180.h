@@ -21,6 +21,24 @@
 
 #include <SPI.h>
 
+// Storage class of the shared receive buffer; thread_local when readers run in separate threads (Linux build)
+#ifndef PN5180_THREAD_LOCAL
+#define PN5180_THREAD_LOCAL
+#endif
+// Host copy of the receive buffer for readData(int). The PN5180 holds 508 bytes; on AVR
+// the copy is sized for the ISO-DEP FSD announced there (ISODEP_FSDI), longer frames are not read.
+#ifndef PN5180_READ_BUFFER_SIZE
+#if defined(__AVR__)
+#define PN5180_READ_BUFFER_SIZE (128)
+#else
+#define PN5180_READ_BUFFER_SIZE (508)
+#endif
+#endif
+
+// Text output of the library (version banner, errors, debug); Serial by default.
+// A sketch may point it at a PN5180TxChannel so that printing never waits for the UART.
+extern Print *pn5180Log;
+
 // PN5180 Registers
 #define SYSTEM_CONFIG (0x00)
 #define IRQ_ENABLE (0x01)
@@ -36,9 +54,22 @@
 #define TX_CONFIG (0x18)
 #define CRC_TX_CONFIG (0x19)
 #define RF_STATUS (0x1d)
+#define AGC_CONFIG (0x1e)
+#define AGC_VALUE (0x1f)
+#define RF_CONTROL_TX (0x20)
 #define SYSTEM_STATUS (0x24)
 #define TEMP_CONTROL (0x25)
 #define AGC_REF_CONFIG (0x26)
+#define DPC_CONFIG (0x27)
+// AGC_REF_CONFIG: TX driver gear (used directly without DPC, as the start gear with DPC)
+// and the AGC reference the dynamic power control regulates to
+#define AGC_REF_CONFIG_REF_MASK (0x3FFUL)
+#define AGC_REF_CONFIG_GEAR_SHIFT (10)
+#define AGC_REF_CONFIG_GEAR_MASK (0xFUL << AGC_REF_CONFIG_GEAR_SHIFT)
+#define AGC_VALUE_MASK (0x3FFUL)
+// TEMP_CONTROL: TEMP_DELTA selects the threshold of the die temperature sensor
+// (0: 85 C, 1: 115 C, 2: 125 C, 3: 135 C); above it TEMPSENS_ERROR is raised and the field is switched off
+#define TEMP_CONTROL_DELTA_MASK (0x03UL)
 #define PN5180_COMMAND 0x00 // 0x00 is the command register, used for direct commands
 
 
@@ -48,6 +79,26 @@
 #define FIRMWARE_VERSION (0x12)
 #define EEPROM_VERSION (0x14)
 #define IRQ_PIN_CONFIG (0x1A)
+#define MISO_PULLUP_ENABLE (0x1B)
+#define MFC_AUTH_TIMEOUT (0x32)
+#define LPCD_REFERENCE_VALUE (0x34)
+#define LPCD_FIELD_ON_TIME (0x36)
+#define LPCD_THRESHOLD (0x37)
+#define LPCD_REFVAL_GPO_CONTROL (0x38)
+#define LPCD_GPO_TOGGLE_BEFORE_FIELD_ON (0x39)
+#define LPCD_GPO_TOGGLE_AFTER_FIELD_OFF (0x3A)
+#define DPC_CONTROL (0x59)
+#define DPC_TIME (0x5A)
+#define DPC_XI (0x5C)
+#define AGC_CONTROL (0x5D)
+
+// MFC_AUTHENTICATE key types and result codes
+#define MIFARE_KEY_A (0x60)
+#define MIFARE_KEY_B (0x61)
+#define MIFARE_AUTH_OK (0x00)
+#define MIFARE_AUTH_FAILED (0x01)
+#define MIFARE_AUTH_TIMEOUT (0x02)
+#define MIFARE_AUTH_ERROR (0xFF) // SPI or parameter error, not reported by the PN5180
 
 enum PN5180TransceiveStat
 {
@@ -69,10 +120,62 @@ enum PN5180TransceiveStat
 #define RFON_DET_IRQ_STAT (1 << 7)         // RF Field ON detection IRQ
 #define TX_RFOFF_IRQ_STAT (1 << 8)         // RF Field OFF in PCD IRQ
 #define TX_RFON_IRQ_STAT (1 << 9)          // RF Field ON in PCD IRQ
+#define RF_ACTIVE_ERROR_IRQ_STAT (1 << 10) // RF active error IRQ (active communication)
 #define RX_SOF_DET_IRQ_STAT (1 << 14)      // RF SOF Detection IRQ
+#define TEMPSENS_ERROR_IRQ_STAT (1UL << 16) // Temperature sensor error IRQ (overheat, RF switched off)
 #define GENERAL_ERROR_IRQ_STAT (1UL << 17) // General error IRQ
+#define HV_ERROR_IRQ_STAT (1UL << 18)      // EEPROM high voltage / supply error IRQ
+#define TIMER1_IRQ_STAT (1UL << 12)        // Timer 1 expired IRQ
 #define LPCD_IRQ_STAT (1UL << 19)          // LPCD Detection IRQ
 
+// PN5180 TIMERx_CONFIG
+#define TIMER_CONFIG_ENABLE (1UL << 0)
+#define TIMER_CONFIG_MODE_RELOAD (1UL << 1)       // 0 = single shot
+#define TIMER_CONFIG_PRESCALE_SHIFT (2)           // bits 4..2: 13.56 MHz / 2^n, n = 0..5
+#define TIMER_CONFIG_START_NOW (1UL << 9)
+#define TIMER_CONFIG_START_ON_TX_ENDED (1UL << 13)
+#define TIMER_CONFIG_STOP_ON_RX_STARTED (1UL << 17)
+#define TIMER_RELOAD_MAX (0x000FFFFFUL)           // 20 bit reload value
+#define TIMER_PRESCALE_MAX (5)
+
+#define PN5180_RX_PENDING (-2) // pollRx(): no response yet
+#define PN5180_RX_COLLISION (-3) // pollRx(): bit collision, several cards answered at once
+
+// Start-up: reset() and fastStart() result codes
+#define PN5180_START_OK (0)
+#define PN5180_START_BUSY_STUCK (1)  // BUSY never low after reset: no supply or wiring
+#define PN5180_START_NO_IDLE (2)     // no IDLE_IRQ before the boot deadline
+#define PN5180_START_SPI_ERROR (3)   // EEPROM read did not complete
+#define PN5180_START_BAD_VERSION (4) // PRODUCT_VERSION is not 4.x: MISO stuck or another chip
+#define PN5180_RESET_PULSE_US (10)   // RESET_N low time, datasheet minimum
+#define PN5180_BOOT_TIMEOUT_MS (10)  // boot takes about 2.5 ms
+#define PN5180_RF_SWITCH_TIMEOUT_MS (10) // RF_ON/RF_OFF: TX_RFON/TX_RFOFF within this time
+
+// Pause after NSS goes low (half of it after NSS goes high), microseconds.
+// BUSY paces the SPI commands and waitForRx() waits for the card's answer before every
+// READ_DATA, so a short guard is enough; the default keeps the historical 2 ms / 1 ms.
+#ifndef PN5180_NSS_GUARD_US
+#define PN5180_NSS_GUARD_US (2000)
+#endif
+#define PN5180_NSS_GUARD_FAST_US (10)
+// Pause between IRQ_STATUS reads in waitForRx() (the IRQ pin is not wired), microseconds
+#ifndef PN5180_RX_POLL_US
+#define PN5180_RX_POLL_US (50)
+#endif
+
+// PN5180 RX_STATUS
+#define RX_BYTES_RECEIVED_MASK (0x000001FFUL)
+#define RX_NUM_LAST_BITS_MASK (0x0000E000UL) // valid bits in the last byte, 0 = all 8
+#define RX_NUM_LAST_BITS_SHIFT (13)
+#define RX_DATA_INTEGRITY_ERROR (1UL << 16) // CRC or parity error
+#define RX_PROTOCOL_ERROR (1UL << 17)       // Framing or length error
+#define RX_COLLISION_DETECTED (1UL << 18)   // Bit collision
+
+class PN5180;
+// Called after every successful LOAD_RF_CONFIG with the object that loaded it: the
+// configuration overwrites registers changed on top of it (TX gear, thresholds)
+typedef void (*PN5180RFConfigHook)(PN5180 &nfc, void *context);
+
 class PN5180
 {
 private:
@@ -81,7 +184,18 @@ private:
   uint8_t PN5180_RST;
 
   SPISettings PN5180_SPI_SETTINGS;
-  static uint8_t readBuffer[508];
+  static PN5180_THREAD_LOCAL uint8_t readBuffer[PN5180_READ_BUFFER_SIZE];
+
+  uint8_t rfTxConfig; // last loaded RF configuration, 0xFF = unknown
+  uint8_t rfRxConfig;
+  uint32_t rxTimeoutRemaining; // carrier cycles left after the current TIMER1 period
+  uint32_t rxTimeoutMs;        // software safety bound for waitForRx()
+  uint32_t rxStart;            // millis() at startRxTimeout()
+  uint8_t versions[6];         // EEPROM 0x10..0x15, read by fastStart()
+  bool rfOn;                   // field switched on by setRF_on()
+  static PN5180RFConfigHook rfConfigHook; // shared by all PN5180 objects on the bus
+  static void *rfConfigContext;
+  bool armTimer1(uint32_t carrierCycles, uint32_t startMode);
 
 public:
   PN5180(uint8_t SSpin, uint8_t BUSYpin, uint8_t RSTpin);
@@ -117,25 +231,42 @@ public:
   uint8_t readRFResponse(uint8_t *buffer, uint8_t maxLen);
   /* cmd 0x0B */
   bool switchToLPCD(uint16_t wakeupCounterInMs);
+  /* cmd 0x0C */
+  uint8_t mifareAuthenticate(uint8_t blockno, uint8_t keyType, const uint8_t *key, const uint8_t *uid);
   /* cmd 0x11 */
   bool loadRFConfig(uint8_t txConf, uint8_t rxConf);
+  bool switchRFConfig(uint8_t txConf, uint8_t rxConf);
+  /* cmd 0x12 */
+  bool updateRFConfig(uint8_t conf, uint8_t reg, uint32_t value);
+  void invalidateRFConfig();
+  // One hook for all objects (Discovery loads Type B/F/V through objects of their own); 0 = none
+  static void setRFConfigHook(PN5180RFConfigHook hook, void *context = 0);
 
   /* cmd 0x16 */
   bool setRF_on();
   /* cmd 0x17 */
   bool setRF_off();
+  bool isRFOn() const;
+  // The PN5180 switched the field off itself (TEMPSENS_ERROR): no RF_OFF, no TX_RFOFF_IRQ to wait for
+  void markRFOff();
 
   /*
    * Helper functions
    */
 public:
-  void reset();
+  uint8_t reset();
   uint8_t commandTimeout = 50;
+  static uint16_t nssGuardUs; // shared by all PN5180 objects on the bus
   uint32_t getIRQStatus();
   bool clearIRQStatus(uint32_t irqMask);
   void showIRQStatus(uint32_t irqStatus);
   PN5180TransceiveStat getTransceiveState();
   bool transceiveCommand(uint8_t *sendBuffer, size_t sendBufferLen, uint8_t *recvBuffer = 0, size_t recvBufferLen = 0);
+  bool startRxTimeout(uint32_t carrierCycles);
+  int16_t pollRx();
+  int16_t waitForRx();
+  uint8_t fastStart();
+  const uint8_t *getVersions() const;
   bool PN5180_Start();
   /*
    * Private methods, called within an SPI transaction
@@ -0,0 +1,95 @@
+// NAME: PN5180Allowlist.h
+//
+// DESC: UID allowlist with O(1) lookup: minimal perfect hash plus 32-bit
+//       fingerprints, stored in flash (PROGMEM) or external storage.
+//
+// This file is part of the PN5180 library for the Arduino environment.
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// Lesser General Public License for more details.
+//
+#ifndef PN5180ALLOWLIST_H
+#define PN5180ALLOWLIST_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/*
+ * Image layout (little endian), built on the host by extras/host/build_allowlist:
+ *
+ *   'P' 'N' 'A' 'L' | version | 0 | count (2) | buckets (2) | seed (2) | disp[buckets] (2 each) | fp[count] (4 each)
+ *
+ * A key is the UID length followed by the UID (4, 7 or 10 bytes).
+ * h = hash(key, seed << 16) selects the bucket (upper 16 bits) and is the fingerprint.
+ * disp[bucket] with bit 15 set is the slot itself (buckets with one key), otherwise
+ * the slot is hash(key, (seed << 16) + disp + 1) reduced to count. The UID is listed
+ * if fp[slot] == h: a UID not in the list passes with probability 2^-32.
+ * About 4.5 bytes per UID, two hashes and two storage reads per lookup.
+ */
+#define PN5180_ALLOWLIST_VERSION (1)
+#define PN5180_ALLOWLIST_HEADER_LEN (12)
+#define PN5180_ALLOWLIST_MAX_COUNT (32767)
+#define PN5180_ALLOWLIST_BUCKET_KEYS (4) // average keys per bucket
+#define PN5180_ALLOWLIST_DIRECT (0x8000)
+
+static inline uint32_t pn5180AllowlistHash(const uint8_t *uid, uint8_t uidLength, uint32_t seed)
+{
+  uint32_t h = 0x811C9DC5UL ^ (seed * 0x9E3779B9UL);
+  h = (h ^ uidLength) * 0x01000193UL;
+  for (uint8_t i = 0; i < uidLength; i++)
+    h = (h ^ uid[i]) * 0x01000193UL;
+  h ^= h >> 16;
+  h *= 0x85EBCA6BUL;
+  h ^= h >> 13;
+  h *= 0xC2B2AE35UL;
+  h ^= h >> 16;
+  return h;
+}
+
+// Maps the upper 16 bits of a hash to 0..range-1 without a division
+static inline uint16_t pn5180AllowlistReduce(uint32_t h, uint16_t range)
+{
+  return (uint16_t)(((h >> 16) * (uint32_t)range) >> 16);
+}
+
+// External storage (SPI flash, SD card, I2C EEPROM): read len bytes at offset into buffer
+typedef bool (*PN5180AllowlistReader)(uint32_t offset, uint8_t *buffer, uint8_t len, void *context);
+
+class PN5180Allowlist
+{
+private:
+  PN5180AllowlistReader reader;
+  void *context;
+  const uint8_t *data;
+  bool progmem;
+  uint16_t count;
+  uint16_t buckets;
+  uint16_t seed;
+
+  bool read(uint32_t offset, uint8_t *buffer, uint8_t len);
+  bool parseHeader();
+
+public:
+  PN5180Allowlist();
+
+  // Image in RAM
+  bool beginMemory(const uint8_t *image);
+#ifndef PN5180_ALLOWLIST_HOST
+  // Image in PROGMEM (the first 64 KB of flash on AVR)
+  bool beginProgmem(const uint8_t *image);
+#endif
+  bool begin(PN5180AllowlistReader reader, void *context = 0);
+
+  // uid as returned by activateTypeA()/cardDetect() from buffer[3]
+  bool contains(const uint8_t *uid, uint8_t uidLength);
+  uint16_t getCount() const;
+};
+
+#endif /* PN5180ALLOWLIST_H */
@@ -0,0 +1,103 @@
+// NAME: PN5180CardTracker.h
+//
+// DESC: Tracks cards present in the field: one enter event per card,
+//       one leave event after it has been missing long enough.
+//
+// This file is part of the PN5180 library for the Arduino environment.
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// Lesser General Public License for more details.
+//
+#ifndef PN5180CARDTRACKER_H
+#define PN5180CARDTRACKER_H
+
+#include <Arduino.h>
+
+// Hash table size, a power of two; also the maximum number of tracked cards
+#ifndef TRACKER_SLOTS
+#if defined(__AVR__)
+#define TRACKER_SLOTS (8)
+#else
+#define TRACKER_SLOTS (32)
+#endif
+#endif
+#define TRACKER_DWELL_MS (0)          // seen this long before enter, 0 = on the first read
+#define TRACKER_DEBOUNCE_POLLS (3)    // missing in this many polls in a row ...
+#define TRACKER_DEBOUNCE_MS (300)     // ... and for this long before leave
+
+// seen() results
+#define TRACKER_NEW (0)     // enter reported now: handle the card
+#define TRACKER_PRESENT (1) // already reported, a repeated read
+#define TRACKER_DWELL (2)   // not reported yet, dwell time not reached
+#define TRACKER_FULL (3)    // no free slot, the card is not tracked
+
+// Callback events
+#define TRACKER_EVENT_ENTER (0)
+#define TRACKER_EVENT_LEAVE (1)
+
+struct PN5180TrackedCard
+{
+  uint8_t state; // internal: empty, dwell, present
+  uint8_t technology;
+  uint8_t uidLength;
+  uint8_t uid[10];
+  uint8_t misses;     // polls in a row without this card
+  uint32_t firstSeen; // millis()
+  uint32_t lastSeen;
+};
+
+struct PN5180TrackerStats
+{
+  uint32_t reads;      // seen() calls
+  uint32_t duplicates; // reads of a card already reported
+  uint16_t enters;
+  uint16_t leaves;
+  uint16_t flybys;     // gone before the dwell time
+  uint16_t full;       // not tracked, table full
+  uint8_t maxProbe;    // longest probe sequence seen
+};
+
+typedef void (*PN5180TrackerCallback)(uint8_t event, const PN5180TrackedCard &card, void *context);
+
+class PN5180CardTracker
+{
+private:
+  PN5180TrackedCard slots[TRACKER_SLOTS];
+  PN5180TrackerCallback callback;
+  void *context;
+  uint16_t dwellMs;
+  uint8_t debouncePolls;
+  uint16_t debounceMs;
+  uint8_t count;
+  PN5180TrackerStats stats;
+
+  static uint8_t hash(uint8_t technology, const uint8_t *uid, uint8_t uidLength);
+  int8_t find(uint8_t technology, const uint8_t *uid, uint8_t uidLength, uint8_t *freeSlot);
+  void remove(uint8_t slot);
+
+public:
+  PN5180CardTracker(PN5180TrackerCallback callback = 0, void *context = 0);
+
+  void setDwell(uint16_t ms);
+  void setDebounce(uint8_t polls, uint16_t ms);
+
+  // A card read in the current poll; returns TRACKER_*
+  uint8_t seen(uint8_t technology, const uint8_t *uid, uint8_t uidLength);
+  // Once per poll, after seen(): ages the cards not read in this poll, reports leave
+  void endPoll();
+  // Forgets all cards, reporting leave for those that entered
+  void clear();
+
+  uint8_t getCount() const;
+  const PN5180TrackerStats &getStats() const;
+  void resetStats();
+};
+
+#endif /* PN5180CARDTRACKER_H */
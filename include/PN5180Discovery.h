@@ -0,0 +1,102 @@
+// NAME: PN5180Discovery.h
+//
+// DESC: Multi-technology (NFC-A/B/F/V) polling loop for the PN5180.
+//
+// This file is part of the PN5180 library for the Arduino environment.
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// Lesser General Public License for more details.
+//
+#ifndef PN5180DISCOVERY_H
+#define PN5180DISCOVERY_H
+
+#include "PN5180ISO14443.h"
+#include "PN5180FeliCa.h"
+#include "PN5180ISO15693.h"
+
+#define PN5180_TECH_A (0)
+#define PN5180_TECH_B (1)
+#define PN5180_TECH_F (2)
+#define PN5180_TECH_V (3)
+#define PN5180_TECH_COUNT (4)
+#define PN5180_TECH_NONE (0xFF)
+
+#ifndef DISCOVERY_RECENT_CYCLES
+#define DISCOVERY_RECENT_CYCLES (4) // a technology that found a card this recently is polled first
+#endif
+#ifndef DISCOVERY_FIELD_GUARD_US
+#define DISCOVERY_FIELD_GUARD_US (5100) // field gating: unmodulated field before the first command (NFC Forum)
+#endif
+
+// Card found by the discovery loop
+struct PN5180DiscoveryResult
+{
+  uint8_t technology; // PN5180_TECH_*
+  uint8_t uidLength;
+  uint8_t uid[10];  // A: UID, B: PUPI, F: IDm, V: UID (LSB first)
+  uint8_t data[16]; // A: ATQA, SAK, UID (cardDetect layout), B: ATQB, F: PMm
+  uint32_t ttfu;    // time to first UID, ms
+};
+
+// Discovery statistics, times in milliseconds
+struct PN5180DiscoveryStats
+{
+  uint32_t cycles;     // completed polling cycles
+  uint32_t polls;      // single technology polls
+  uint32_t rfSwitches; // RF configuration changes between technologies
+  uint16_t found[PN5180_TECH_COUNT];
+  uint32_t ttfuSum[PN5180_TECH_COUNT];
+  uint32_t ttfuLast;
+  uint32_t ttfuMin;
+  uint32_t ttfuMax;
+  // Field gating, times in microseconds: RF_ON plus guard time, the latency each cycle adds
+  uint32_t fieldCycles;
+  uint32_t fieldUpSum;
+  uint32_t fieldUpMax;
+  uint32_t fieldUpLast;
+  uint16_t fieldErrors; // RF_ON without TX_RFON_IRQ
+};
+
+class PN5180Discovery
+{
+private:
+  PN5180ISO14443 &nfcA; // Type A and Type B
+  PN5180FeliCa *nfcF;
+  PN5180ISO15693 *nfcV;
+  uint8_t weight[PN5180_TECH_COUNT];
+  uint32_t lastFound[PN5180_TECH_COUNT]; // cycle number + 1 of the last card, 0 = never
+  uint8_t recentCycles;
+  uint8_t currentTech;
+  bool measuring;
+  bool gating;
+  uint16_t guardUs;
+  uint32_t ttfuStart;
+  PN5180DiscoveryStats stats;
+
+  PN5180 &device(uint8_t tech);
+  bool pollTechnology(uint8_t tech, PN5180DiscoveryResult *result);
+  bool fieldUp();
+
+public:
+  PN5180Discovery(PN5180ISO14443 &nfcA, PN5180FeliCa *nfcF = 0, PN5180ISO15693 *nfcV = 0);
+
+  void setWeight(uint8_t tech, uint8_t pollsPerCycle);
+  void setRecentCycles(uint8_t cycles);
+  // Field off between polls, on guardUs before the first REQA/WUPA of a cycle
+  void setFieldGating(bool enabled, uint16_t guardUs = DISCOVERY_FIELD_GUARD_US);
+  bool poll(PN5180DiscoveryResult *result);
+  void restart();
+
+  uint8_t getTechnology() const;
+  const PN5180DiscoveryStats &getStats() const;
+  void resetStats();
+};
+
+#endif /* PN5180DISCOVERY_H */
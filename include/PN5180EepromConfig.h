@@ -0,0 +1,120 @@
+// NAME: PN5180EepromConfig.h
+//
+// DESC: Typed EEPROM configuration profiles: one bulk read, diff against
+//       the desired profile, write back only the bytes that differ.
+//
+// This file is part of the PN5180 library for the Arduino environment.
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// Lesser General Public License for more details.
+//
+#ifndef PN5180EEPROMCONFIG_H
+#define PN5180EEPROMCONFIG_H
+
+#include "PN5180.h"
+
+// Managed fields, bit numbers in PN5180EepromProfile::fields.
+// Ordered by EEPROM address, the serialized form uses this order too.
+#define EECFG_IRQ_PIN_CONFIG (0)
+#define EECFG_MISO_PULLUP_ENABLE (1)
+#define EECFG_MFC_AUTH_TIMEOUT (2)
+#define EECFG_LPCD_REFERENCE_VALUE (3)
+#define EECFG_LPCD_FIELD_ON_TIME (4)
+#define EECFG_LPCD_THRESHOLD (5)
+#define EECFG_LPCD_REFVAL_GPO_CONTROL (6)
+#define EECFG_LPCD_GPO_TOGGLE_BEFORE_FIELD_ON (7)
+#define EECFG_LPCD_GPO_TOGGLE_AFTER_FIELD_OFF (8)
+#define EECFG_DPC_CONTROL (9)
+#define EECFG_DPC_TIME (10)
+#define EECFG_DPC_XI (11)
+#define EECFG_AGC_CONTROL (12)
+#define EECFG_FIELD_COUNT (13)
+#define EECFG_ALL_FIELDS ((uint16_t)((1u << EECFG_FIELD_COUNT) - 1))
+
+// EEPROM window covered by the bulk read (IRQ_PIN_CONFIG .. AGC_CONTROL+1)
+#define EECFG_FIRST_ADDR IRQ_PIN_CONFIG
+#define EECFG_WINDOW_LEN (AGC_CONTROL + 2 - IRQ_PIN_CONFIG)
+
+// Serialized profile: 'P' '5' version mask(2) values... fletcher16(2)
+#define EECFG_BLOB_VERSION (1)
+#define EECFG_BLOB_MAX_LEN (5 + 17 + 2)
+
+// apply() results
+#define EECFG_OK (0)
+#define EECFG_READ_ERROR (1)
+#define EECFG_WRITE_ERROR (2)
+#define EECFG_VERIFY_ERROR (3)
+
+// Multi-byte values are little endian, as stored in the EEPROM.
+// Only fields with their bit set in 'fields' are compared, written and serialized.
+struct PN5180EepromProfile
+{
+  uint16_t fields;
+  uint8_t irqPinConfig;           // bit 0: IRQ pin active high
+  uint8_t misoPullupEnable;
+  uint16_t mfcAuthTimeout;        // ms
+  uint16_t lpcdReferenceValue;
+  uint8_t lpcdFieldOnTime;
+  uint8_t lpcdThreshold;
+  uint8_t lpcdRefvalGpoControl;
+  uint8_t lpcdGpoToggleBeforeFieldOn;
+  uint8_t lpcdGpoToggleAfterFieldOff;
+  uint8_t dpcControl;
+  uint16_t dpcTime;
+  uint8_t dpcXi;
+  uint16_t agcControl;
+};
+
+struct PN5180EepromDiff
+{
+  uint16_t fields; // managed fields whose bytes differ
+  uint8_t bytes;   // number of differing bytes
+};
+
+struct PN5180EepromStats
+{
+  uint16_t reads;         // bulk reads
+  uint16_t applies;       // apply() calls
+  uint16_t upToDate;      // apply() calls that had nothing to write
+  uint16_t writeCommands; // WRITE_EEPROM commands issued
+  uint16_t bytesWritten;
+};
+
+class PN5180EepromConfig
+{
+private:
+  PN5180 &nfc;
+  PN5180EepromStats stats;
+
+  bool readWindow(uint8_t *window);
+  static uint16_t overlay(const uint8_t *window, const PN5180EepromProfile &profile,
+                          uint8_t *desired, uint8_t &bytes);
+
+public:
+  PN5180EepromConfig(PN5180 &nfc);
+
+  // Reads all managed fields with one READ_EEPROM; profile.fields = EECFG_ALL_FIELDS
+  bool read(PN5180EepromProfile &profile);
+  // Compares the EEPROM against the managed fields of the profile
+  bool diff(const PN5180EepromProfile &profile, PN5180EepromDiff &result);
+  // Writes only differing bytes (adjacent ones in one command) and verifies by re-reading
+  uint8_t apply(const PN5180EepromProfile &profile, PN5180EepromDiff *result = NULL);
+
+  const PN5180EepromStats &getStats() const;
+  void resetStats();
+
+  // Portable binary form for fleet provisioning; returns the length, 0 if the buffer is too small
+  static uint8_t serialize(const PN5180EepromProfile &profile, uint8_t *buffer, uint8_t size);
+  // Returns false on bad magic, version, length or checksum
+  static bool deserialize(const uint8_t *buffer, uint8_t len, PN5180EepromProfile &profile);
+  static void print(const PN5180EepromProfile &profile, Print &out);
+};
+
+#endif /* PN5180EEPROMCONFIG_H */
@@ -0,0 +1,84 @@
+// NAME: PN5180Events.h
+//
+// DESC: Compact binary card event frames for the host link.
+//
+// This file is part of the PN5180 library for the Arduino environment.
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// Lesser General Public License for more details.
+//
+#ifndef PN5180EVENTS_H
+#define PN5180EVENTS_H
+
+#include <stdint.h>
+
+/*
+ * Frame layout (all multi-byte fields little endian unless noted):
+ *
+ *   SOF | LEN | SEQ | TYPE | PAYLOAD[LEN] | CRC16
+ *
+ * SOF is 0xA5, SEQ increments by one per frame (wraps at 255), CRC16 is
+ * CRC-16/CCITT-FALSE (poly 0x1021, init 0xFFFF) over LEN..PAYLOAD, low byte first.
+ * The host resynchronises on the next SOF after a CRC error, so stray text
+ * printed by the library on the same port only costs the frames it overlaps.
+ *
+ * Payloads:
+ *   HELLO        version, productVersion[2]                 (sent once after start)
+ *   CARD_ENTER   tech, uidLength, uid[uidLength], Type A only: ATQA[2], SAK
+ *   CARD_LEAVE   tech, uidLength, uid[uidLength]
+ *   APDU_RESULT  index, SW1, SW2, responseLength (uint16)
+ *   ERROR        code, detail (uint32): IRQ_STATUS for ERROR_IRQ, PN5180_START_* code for
+ *                ERROR_START, last SW for ERROR_SESSION
+ */
+#define PN5180_EVENT_SOF (0xA5)
+#define PN5180_EVENT_VERSION (1)
+#define PN5180_EVENT_HEADER_LEN (4)
+#define PN5180_EVENT_CRC_LEN (2)
+#define PN5180_EVENT_MAX_PAYLOAD (24)
+#define PN5180_EVENT_MAX_FRAME (PN5180_EVENT_HEADER_LEN + PN5180_EVENT_MAX_PAYLOAD + PN5180_EVENT_CRC_LEN)
+
+#define PN5180_EVENT_HELLO (0x00)
+#define PN5180_EVENT_CARD_ENTER (0x01)
+#define PN5180_EVENT_CARD_LEAVE (0x02)
+#define PN5180_EVENT_APDU_RESULT (0x03)
+#define PN5180_EVENT_ERROR (0x04)
+
+// ERROR codes
+#define PN5180_EVENT_ERROR_IRQ (0x01)     // unexpected IRQ_STATUS, reader is reset
+#define PN5180_EVENT_ERROR_START (0x02)   // PN5180 not detected at start
+#define PN5180_EVENT_ERROR_SESSION (0x03) // ISO-DEP session aborted
+
+uint16_t pn5180EventCrc(const uint8_t *data, uint16_t len, uint16_t crc = 0xFFFF);
+
+#ifndef PN5180_EVENTS_PROTOCOL_ONLY
+#include <Arduino.h>
+
+class PN5180EventWriter
+{
+private:
+  Print &out;
+  uint8_t seq;
+
+public:
+  PN5180EventWriter(Print &out);
+
+  bool send(uint8_t type, const uint8_t *payload, uint8_t len);
+
+  bool hello(const uint8_t *productVersion);
+  // buffer in the activateTypeA() layout: ATQA[0..1], SAK[2], UID from [3]
+  bool cardEnterTypeA(const uint8_t *buffer, uint8_t uidLength);
+  bool cardEnter(uint8_t technology, const uint8_t *uid, uint8_t uidLength);
+  bool cardLeave(uint8_t technology, const uint8_t *uid, uint8_t uidLength);
+  bool apduResult(uint8_t index, uint16_t sw, uint16_t responseLength);
+  bool error(uint8_t code, uint32_t detail);
+};
+#endif
+
+#endif /* PN5180EVENTS_H */
@@ -0,0 +1,74 @@
+// NAME: PN5180FeliCa.h
+//
+// DESC: FeliCa (NFC-F) protocol on NXP Semiconductors PN5180 module for Arduino.
+//
+// This file is part of the PN5180 library for the Arduino environment.
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// Lesser General Public License for more details.
+//
+#ifndef PN5180FELICA_H
+#define PN5180FELICA_H
+
+#include "PN5180.h"
+
+// FeliCa RF configurations (LOAD_RF_CONFIG)
+#define FELICA_TX_CONFIG_212 (0x08)
+#define FELICA_RX_CONFIG_212 (0x88)
+#define FELICA_TX_CONFIG_424 (0x09)
+#define FELICA_RX_CONFIG_424 (0x89)
+
+#define FELICA_BITRATE_212 (0)
+#define FELICA_BITRATE_424 (1)
+
+#define FELICA_IDM_LEN (8)
+#define FELICA_PMM_LEN (8)
+#define FELICA_BLOCK_SIZE (16)
+#define FELICA_MAX_BLOCKS (15)            // blocks per Read Without Encryption, bounded by the 254 byte frame
+#define FELICA_SYSTEM_CODE_ANY (0xFFFF)   // wildcard system code for SENSF_REQ
+#define FELICA_SERVICE_RANDOM_RO (0x000B) // common read-only random service
+
+// Time slots for SENSF_REQ (TSN = slots - 1)
+#define FELICA_SLOTS_1 (0x00)
+#define FELICA_SLOTS_2 (0x01)
+#define FELICA_SLOTS_4 (0x03)
+#define FELICA_SLOTS_8 (0x07)
+#define FELICA_SLOTS_16 (0x0F)
+
+enum FeliCaResult
+{
+  FELICA_OK = 0,
+  FELICA_NO_CARD = -1,
+  FELICA_RX_ERROR = -2,          // CRC, framing or unexpected response
+  FELICA_STATUS_ERROR = -3,      // card answered with status flags != 0
+  FELICA_INVALID_PARAMETER = -4, // not sent to the card
+  FELICA_PN5180_ERROR = -5
+};
+
+class PN5180FeliCa : public PN5180
+{
+
+public:
+  PN5180FeliCa(uint8_t SSpin, uint8_t BUSYpin, uint8_t RSTpin);
+
+private:
+  FeliCaResult issueCommand(uint8_t *cmd, uint8_t cmdLen, uint8_t responseCode, uint8_t **result, int16_t *resultLen, uint32_t timeoutCycles);
+
+public:
+  bool setupRF(uint8_t bitRate = FELICA_BITRATE_212);
+
+  FeliCaResult poll(uint16_t systemCode, uint8_t timeSlots, uint8_t *idm, uint8_t *pmm);
+  uint8_t pollMultiple(uint16_t systemCode, uint8_t *idms, uint8_t *pmms, uint8_t maxCards, uint8_t polls = 8);
+
+  FeliCaResult readWithoutEncryption(const uint8_t *idm, const uint8_t *pmm, uint16_t serviceCode, const uint16_t *blockNumbers,
+                                     uint8_t numBlocks, uint8_t *blockData, uint16_t *statusFlags = 0);
+};
+
+#endif /* PN5180FELICA_H */
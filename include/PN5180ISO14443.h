@@ -21,6 +21,87 @@
 
 #include "PN5180.h"
 
+// MIFARE Classic key-trial engine limits
+#define MIFARE_CLASSIC_MAX_KEYS (16)      // max. number of keys in the trial list
+#define MIFARE_CLASSIC_KEY_CACHE_SIZE (8) // number of remembered UIDs
+#define MIFARE_CLASSIC_RANDOM_UID (0x08)  // UID0 of a 4-byte random ID (RID), new on every activation
+#define MIFARE_CLASSIC_RESPONSE_TIMEOUT_CYCLES (67800UL) // 5 ms: READ data, ACK to the write command
+#define MIFARE_CLASSIC_WRITE_TIMEOUT_CYCLES (135600UL)   // 10 ms: ACK after the block is programmed
+#define MIFARE_CLASSIC_ACK_BITS (4)
+
+// MIFARE Ultralight / NTAG (NFC Forum Type 2)
+#define MIFARE_UL_PAGE_SIZE (4)
+#define MIFARE_UL_FAST_READ_MAX_PAGES (PN5180_READ_BUFFER_SIZE / MIFARE_UL_PAGE_SIZE) // 127 with the full 508 bytes
+#define MIFARE_UL_RESPONSE_TIMEOUT_CYCLES (67800UL)  // 5 ms until the response starts
+#define MIFARE_UL_WRITE_TIMEOUT_CYCLES (135600UL)    // 10 ms, page programming time included
+#define MIFARE_UL_ACK (0x0A)
+
+// ISO14443-4 (ISO-DEP) block protocol
+#define ISODEP_PCB_I_BLOCK (0x02)
+#define ISODEP_PCB_R_ACK (0xA2)
+#define ISODEP_PCB_R_NAK (0xB2)
+#define ISODEP_PCB_S_DESELECT (0xC2)
+#define ISODEP_PCB_S_WTX (0xF2)
+#define ISODEP_PCB_BLOCK_NUMBER (0x01)
+#define ISODEP_PCB_NAD_FOLLOWING (0x04)
+#define ISODEP_PCB_CID_FOLLOWING (0x08)
+#define ISODEP_PCB_CHAINING (0x10)
+#define ISODEP_PCB_R_NAK_BIT (0x10)
+#define ISODEP_MAX_RETRIES (2)          // retransmissions of the same block
+#if defined(__AVR__)
+#define ISODEP_FSDI (7)                 // FSD = 128 bytes announced in RATS, fits PN5180_READ_BUFFER_SIZE
+#else
+#define ISODEP_FSDI (8)                 // FSD = 256 bytes announced in RATS
+#endif
+#ifndef ISODEP_TX_BUFFER_SIZE
+#if defined(__AVR__)
+#define ISODEP_TX_BUFFER_SIZE (64)      // max. transmitted frame without CRC, limited by RAM
+#else
+#define ISODEP_TX_BUFFER_SIZE (254)
+#endif
+#endif
+#define ISODEP_FWT_BASE_US (302UL)      // 256 * 16 / fc, SFGT = 302 us * 2^SFGI
+#define ISODEP_FWT_BASE_CYCLES (4096UL) // 256 * 16, FWT = 4096 / fc * 2^FWI
+#define ISODEP_SFGT_DELTA_US (29UL)     // 384 / fc = 28.3 us, delta SFGT = 384 / fc * 2^SFGI
+#define ISODEP_FWT_DELTA_CYCLES (49152UL) // PCD tolerance added to every FWT
+#define ISODEP_FWT_ACTIVATION_CYCLES (65536UL) // frame waiting time for ATS; PPS uses the FWT from the ATS
+
+// ISO14443A RF configurations (LOAD_RF_CONFIG), 106/212/424/848 kbit/s follow consecutively
+#define ISO14443A_TX_CONFIG_106 (0x00)
+#define ISO14443A_RX_CONFIG_106 (0x80)
+#define ISO14443A_RESPONSE_TIMEOUT_CYCLES (4096UL) // ATQA, UID and SAK start 1172 or 1236 / fc after the command
+
+// ISO14443B RF configuration (LOAD_RF_CONFIG), 106 kbit/s
+#define ISO14443B_TX_CONFIG_106 (0x04)
+#define ISO14443B_RX_CONFIG_106 (0x84)
+#define ISO14443B_ATQB_LEN (11)                  // PUPI(4) + application data(4) + protocol info(3)
+#define ISO14443B_FWT_ATQB_CYCLES (7680UL + 4096UL) // FWT(ATQB) = 7680 / fc, plus margin
+
+// ISO14443-4 bit rates (DSI/DRI)
+#define ISO14443_BITRATE_106 (0)
+#define ISO14443_BITRATE_212 (1)
+#define ISO14443_BITRATE_424 (2)
+#define ISO14443_BITRATE_848 (3)
+
+// Parsed Answer To Select (ISO14443-4, 5.2)
+struct PN5180ATS
+{
+  uint8_t tl;
+  uint8_t t0;
+  uint8_t ta; // TA(1): bit rate capability, 0 if absent
+  uint8_t tb; // TB(1): FWI/SFGI, 0 if absent
+  uint8_t tc; // TC(1): NAD/CID support
+  uint8_t fsci;
+  uint16_t fsc; // max. frame size accepted by the card, incl. CRC
+  uint8_t fwi;
+  uint8_t sfgi;
+  uint8_t historicalLen; // may exceed sizeof(historical), the rest is truncated
+  uint8_t historical[16];
+};
+
+// Receives response fragments of an ISO-DEP exchange, return false to abort
+typedef bool (*PN5180DataSink)(const uint8_t *data, uint16_t len, void *context);
+
 class PN5180ISO14443 : public PN5180
 {
 
@@ -30,15 +111,57 @@ public:
 private:
   uint16_t rxBytesReceived();
 
+  // MIFARE Classic key-trial state
+  struct MifareKeyCacheEntry
+  {
+    uint16_t uidHash; // hash of the full UID
+    uint8_t keyIndex; // 0xFF = empty entry
+  };
+  const uint8_t (*mfcKeys)[6];
+  uint8_t mfcKeyCount;
+  uint8_t mfcKeyHits[MIFARE_CLASSIC_MAX_KEYS];
+  MifareKeyCacheEntry mfcKeyCache[MIFARE_CLASSIC_KEY_CACHE_SIZE];
+  uint8_t mfcKeyCacheNext;
+  uint8_t mifareClassicReadSectorBlocks(uint8_t sector, uint8_t *buffer);
+  static uint16_t mifareClassicUidHash(const uint8_t *uid, uint8_t uidLength);
+  bool exchangeTypeA(uint8_t *cmd, uint8_t len, uint8_t *response, uint8_t responseLen);
+  bool mifareClassicWaitAck();
+
+  // ISO-DEP session state
+  bool isoDepActive;
+  uint8_t isoDepBlockNumber;
+  bool isoDepCidEnabled;
+  uint8_t isoDepCid;
+  bool isoDepNadEnabled;
+  uint8_t isoDepNad;
+  uint8_t isoDepFwi;
+  uint16_t isoDepFsc;
+  PN5180ATS ats;
+  int16_t isoDepTransceiveBlock(uint8_t *frame, uint16_t frameLen, uint8_t wtxm, uint8_t **rx);
+  uint8_t isoDepBuildHeader(uint8_t *frame, uint8_t pcb, bool withNad);
+  uint16_t isoDepBuildIBlock(uint8_t *frame, const uint8_t *apdu, uint32_t apduLen, uint32_t *txPos);
+
 public:
   // Mifare TypeA
   uint8_t activateTypeA(uint8_t *buffer, uint8_t kind);
+  bool prepareTypeA();
+  uint8_t activateTypeASelect(uint8_t *buffer);
 
   bool mifareBlockRead(uint8_t blockno, uint8_t *buffer);
   uint8_t mifareUltralightWrite(uint8_t block, uint8_t *data4);
   bool mifareHalt();
   // bool mifareUltralightPwdAuth(uint8_t *pwd, uint8_t *pack_out);
 
+  // Mifare Classic
+  static uint8_t mifareClassicSectorFirstBlock(uint8_t sector);
+  static uint8_t mifareClassicSectorBlockCount(uint8_t sector);
+  uint8_t mifareClassicAuthenticate(uint8_t blockno, uint8_t keyType, const uint8_t *key, const uint8_t *uid, uint8_t uidLength);
+  bool mifareClassicBlockRead(uint8_t blockno, uint8_t *buffer);
+  bool mifareClassicBlockWrite(uint8_t blockno, const uint8_t *data16);
+  bool mifareClassicReadSector(uint8_t sector, uint8_t keyType, const uint8_t *key, const uint8_t *uid, uint8_t uidLength, uint8_t *buffer);
+  void mifareClassicSetKeys(const uint8_t (*keys)[6], uint8_t count);
+  int8_t mifareClassicReadSectorAnyKey(uint8_t sector, uint8_t keyType, const uint8_t *uid, uint8_t uidLength, uint8_t *buffer);
+
   /*
    * Helper functions
    */
@@ -50,9 +173,23 @@ public:
   bool mifare_UL_EV1_GetVersion(uint8_t *versionBuffer);
   bool mifare_UL_EV1_ReadSig(uint8_t *sigBuffer);
   bool mifare_UL_EV1_PwdAuth(uint8_t *pwd, uint8_t *pack);
-  void sendRATS();
-  void sendSelectAID(uint8_t fwt_ats);
-  bool sendWaitAWhile(uint8_t *response, size_t len);
+  uint8_t *mifareUltralightFastRead(uint8_t startPage, uint8_t endPage, uint16_t *len);
+  bool mifareUltralightWritePage(uint8_t page, const uint8_t *data4);
+
+  // TypeB
+  bool activateTypeB(uint8_t *atqb, uint8_t kind = 1, uint8_t cid = 0);
+
+  // ISO14443-4 (ISO-DEP)
+  static bool parseATS(const uint8_t *data, uint8_t len, PN5180ATS *ats);
+  bool sendRATS(uint8_t cid = 0);
+  const PN5180ATS &getATS() const;
+  uint8_t sendPPS(uint8_t maxBitRate = ISO14443_BITRATE_848);
+  void isoDepSetNAD(bool enabled, uint8_t nad);
+  bool exchange(const uint8_t *apdu, uint32_t apduLen, PN5180DataSink sink, void *context, uint32_t *respLen = 0);
+  bool exchange(const uint8_t *apdu, uint16_t apduLen, uint8_t *resp, uint16_t *respLen);
+  bool deselect();
+  bool isIsoDepActive() const;
+  bool sendSelectAID();
 
 };
 
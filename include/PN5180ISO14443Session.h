@@ -0,0 +1,101 @@
+// NAME: PN5180ISO14443Session.h
+//
+// DESC: Persistent ISO14443-4 (ISO-DEP) session with APDU batches.
+//
+// This file is part of the PN5180 library for the Arduino environment.
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// Lesser General Public License for more details.
+//
+#ifndef PN5180ISO14443SESSION_H
+#define PN5180ISO14443SESSION_H
+
+#include "PN5180ISO14443.h"
+
+#define APDU_SW_ANY (0x0000) // do not check the status word
+#define APDU_SW_OK (0x9000)
+
+// HCE (phone host card emulation) select with retry schedule
+#define HCE_PENDING (0)  // waiting for the next SELECT retry
+#define HCE_SELECTED (1) // application answered 90 00
+#define HCE_FAILED (2)   // phone left the field, rejected the AID or retry budget exhausted
+#ifndef HCE_RETRY_BUDGET_MS
+#define HCE_RETRY_BUDGET_MS (8000UL) // give up if the phone stays locked longer
+#endif
+
+// Statistics of HCE selects, times in milliseconds
+struct PN5180HceStats
+{
+  uint16_t sessions;      // hceBegin() calls
+  uint16_t selected;      // sessions ending in HCE_SELECTED
+  uint16_t failed;        // sessions ending in HCE_FAILED
+  uint16_t firstTry;      // selected without a single retry
+  uint32_t retries;       // SELECT retries after 6A 82
+  uint32_t unlockTimeMin; // time from first SELECT to 90 00, retried sessions only
+  uint32_t unlockTimeMax;
+  uint32_t unlockTimeSum;
+  uint16_t answerTimeMin; // duration of a single SELECT exchange
+  uint16_t answerTimeMax;
+  uint32_t answerTimeSum;
+  uint32_t answers;
+};
+
+// One command of an APDU batch
+struct PN5180Apdu
+{
+  const uint8_t *data;
+  uint16_t len;
+  uint16_t expectedSW; // APDU_SW_ANY to accept every status word
+};
+
+// Called for every response of a batch, return false to abort the batch
+typedef bool (*PN5180ApduCallback)(uint8_t index, const uint8_t *resp, uint16_t len, uint16_t sw, void *context);
+
+class PN5180ISO14443Session
+{
+private:
+  PN5180ISO14443 &nfc;
+  bool opened;
+  uint8_t bitRate;
+  uint16_t lastSW;
+
+  // HCE select state
+  const uint8_t *hceAid;
+  uint8_t hceAidLen;
+  uint8_t hceAttempt;
+  uint32_t hceStart;
+  uint32_t hceNextTry;
+  bool hcePending;
+  PN5180HceStats hceStats;
+  uint8_t hceFinish(uint8_t result);
+
+public:
+  PN5180ISO14443Session(PN5180ISO14443 &nfc);
+
+  bool open(uint8_t cid = 0, uint8_t maxBitRate = ISO14443_BITRATE_848);
+  bool attach();
+  bool isOpen() const;
+  uint8_t getBitRate() const;
+  uint16_t getLastSW() const;
+
+  bool transmit(const uint8_t *apdu, uint16_t apduLen, uint8_t *resp, uint16_t *respLen);
+  uint8_t runBatch(const PN5180Apdu *apdus, uint8_t count, uint8_t *resp, uint16_t respSize,
+                   PN5180ApduCallback callback = 0, void *context = 0);
+  void close();
+
+  bool isLikelyHCE() const;
+  void hceBegin(const uint8_t *aid, uint8_t aidLen);
+  uint8_t hcePoll(uint8_t *resp, uint16_t *respLen);
+  bool hceIsPending() const;
+  const PN5180HceStats &getHceStats() const;
+  void resetHceStats();
+};
+
+#endif /* PN5180ISO14443SESSION_H */
@@ -0,0 +1,76 @@
+// NAME: PN5180ISO15693.h
+//
+// DESC: ISO15693 protocol on NXP Semiconductors PN5180 module for Arduino.
+//
+// This file is part of the PN5180 library for the Arduino environment.
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// Lesser General Public License for more details.
+//
+#ifndef PN5180ISO15693_H
+#define PN5180ISO15693_H
+
+#include "PN5180.h"
+
+// ISO15693 RF configuration (LOAD_RF_CONFIG): ASK100, 26 kbit/s
+#define ISO15693_TX_CONFIG (0x0D)
+#define ISO15693_RX_CONFIG (0x8D)
+
+// Request flags
+#define ISO15693_FLAG_HIGH_DATA_RATE (0x02)
+#define ISO15693_FLAG_INVENTORY (0x04)
+#define ISO15693_FLAG_ADDRESSED (0x20) // non-inventory requests
+#define ISO15693_FLAG_ONE_SLOT (0x20)  // inventory requests
+#define ISO15693_FLAG_OPTION (0x40)
+
+#define ISO15693_UID_LEN (8)
+#define ISO15693_MAX_MASK_DEPTH (16) // pending collision masks during one inventory
+
+enum ISO15693ErrorCode
+{
+  EC_NO_CARD = -1,
+  ISO15693_EC_OK = 0,
+  ISO15693_EC_NOT_SUPPORTED = 0x01,
+  ISO15693_EC_NOT_RECOGNIZED = 0x02,
+  ISO15693_EC_OPTION_NOT_SUPPORTED = 0x03,
+  ISO15693_EC_UNKNOWN_ERROR = 0x0f,
+  ISO15693_EC_BLOCK_NOT_AVAILABLE = 0x10,
+  ISO15693_EC_BLOCK_ALREADY_LOCKED = 0x11,
+  ISO15693_EC_BLOCK_IS_LOCKED = 0x12,
+  ISO15693_EC_BLOCK_NOT_PROGRAMMED = 0x13,
+  ISO15693_EC_BLOCK_NOT_LOCKED = 0x14,
+  ISO15693_EC_RX_ERROR = 0x7e,         // CRC, framing or collision
+  ISO15693_EC_INVALID_PARAMETER = 0x7f // not sent by the tag
+};
+
+class PN5180ISO15693 : public PN5180
+{
+
+public:
+  PN5180ISO15693(uint8_t SSpin, uint8_t BUSYpin, uint8_t RSTpin);
+
+private:
+  ISO15693ErrorCode issueCommand(uint8_t *cmd, uint8_t cmdLen, uint8_t **result, int16_t *resultLen, uint32_t timeoutCycles);
+  int8_t inventoryRound(const uint8_t *mask, uint8_t maskLen, bool oneSlot, uint8_t *uids, uint8_t maxUids, uint8_t *numUids,
+                        uint16_t *collisionSlots);
+
+public:
+  bool setupRF();
+
+  ISO15693ErrorCode getInventory(uint8_t *uid);
+  uint8_t getInventoryMultiple(uint8_t *uids, uint8_t maxUids, bool *complete = 0);
+
+  ISO15693ErrorCode getSystemInfo(const uint8_t *uid, uint8_t *blockSize, uint16_t *numBlocks);
+  ISO15693ErrorCode readSingleBlock(const uint8_t *uid, uint8_t blockNo, uint8_t *blockData, uint8_t blockSize);
+  ISO15693ErrorCode writeSingleBlock(const uint8_t *uid, uint8_t blockNo, const uint8_t *blockData, uint8_t blockSize);
+  ISO15693ErrorCode readMultipleBlocks(const uint8_t *uid, uint8_t blockNo, uint8_t numBlocks, uint8_t *blockData, uint8_t blockSize);
+};
+
+#endif /* PN5180ISO15693_H */
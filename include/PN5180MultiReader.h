@@ -0,0 +1,73 @@
+// NAME: PN5180MultiReader.h
+//
+// DESC: Several PN5180 readers on one SPI bus with interleaved response waits.
+//
+// This file is part of the PN5180 library for the Arduino environment.
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// Lesser General Public License for more details.
+//
+#ifndef PN5180MULTIREADER_H
+#define PN5180MULTIREADER_H
+
+#include "PN5180ISO14443.h"
+
+#ifndef MULTIREADER_MAX_READERS
+#define MULTIREADER_MAX_READERS (4)
+#endif
+#define MULTIREADER_ATQA_TIMEOUT_CYCLES (4096UL) // ATQA starts 1172 / fc after WUPA
+
+// Per-reader statistics, times in microseconds
+struct PN5180ReaderStats
+{
+  uint32_t polls;      // WUPA sent
+  uint32_t cards;      // cards activated
+  uint32_t timeouts;   // no ATQA
+  uint32_t collisions; // ATQA with a bit collision (several cards), activation continued
+  uint32_t errors;     // ATQA CRC/protocol error, activation or SPI failure
+  uint32_t waitTime;   // time between WUPA and the end of the response wait
+  uint32_t maxGap;     // longest time between two service() visits
+};
+
+// Called after a card was activated on reader `reader`; buffer has the activateTypeA() layout
+typedef void (*PN5180CardHandler)(uint8_t reader, uint8_t *buffer, uint8_t uidLength, void *context);
+
+class PN5180MultiReader
+{
+private:
+  PN5180ISO14443 *readers[MULTIREADER_MAX_READERS];
+  uint8_t state[MULTIREADER_MAX_READERS];
+  uint32_t started[MULTIREADER_MAX_READERS];    // micros() at WUPA
+  uint32_t lastVisit[MULTIREADER_MAX_READERS];  // micros() of the previous service() visit
+  uint32_t pausedUntil[MULTIREADER_MAX_READERS]; // millis()
+  PN5180ReaderStats stats[MULTIREADER_MAX_READERS];
+  uint8_t count;
+  uint8_t next; // first reader of the next service() pass
+  PN5180CardHandler handler;
+  void *context;
+
+  void step(uint8_t r);
+
+public:
+  PN5180MultiReader();
+
+  int8_t add(PN5180ISO14443 &reader);
+  uint8_t getCount() const;
+  PN5180ISO14443 &getReader(uint8_t r);
+  void setCardHandler(PN5180CardHandler handler, void *context = 0);
+  void pause(uint8_t r, uint32_t ms);
+
+  void service();
+
+  const PN5180ReaderStats &getStats(uint8_t r) const;
+  void resetStats();
+};
+
+#endif /* PN5180MULTIREADER_H */
@@ -0,0 +1,106 @@
+// NAME: PN5180NDEF.h
+//
+// DESC: Incremental NDEF TLV and record parser.
+//
+// This file is part of the PN5180 library for the Arduino environment.
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// Lesser General Public License for more details.
+//
+#ifndef PN5180NDEF_H
+#define PN5180NDEF_H
+
+#include <stdint.h>
+
+// Record header flags
+#define NDEF_FLAG_MB (0x80) // message begin
+#define NDEF_FLAG_ME (0x40) // message end
+#define NDEF_FLAG_CF (0x20) // chunked record
+#define NDEF_FLAG_SR (0x10) // short record, 1 byte payload length
+#define NDEF_FLAG_IL (0x08) // ID length present
+#define NDEF_TNF_MASK (0x07)
+
+// Type name formats
+#define NDEF_TNF_EMPTY (0x00)
+#define NDEF_TNF_WELL_KNOWN (0x01) // "U" URI, "T" text, "Sp" smart poster
+#define NDEF_TNF_MIME (0x02)       // e.g. "text/vcard"
+#define NDEF_TNF_URI (0x03)
+#define NDEF_TNF_EXTERNAL (0x04)
+#define NDEF_TNF_UNKNOWN (0x05)
+#define NDEF_TNF_UNCHANGED (0x06)
+
+// TLV blocks of Type 1/2 tags
+#define NDEF_TLV_NULL (0x00)
+#define NDEF_TLV_LOCK_CONTROL (0x01)
+#define NDEF_TLV_MEMORY_CONTROL (0x02)
+#define NDEF_TLV_MESSAGE (0x03)
+#define NDEF_TLV_PROPRIETARY (0xFD)
+#define NDEF_TLV_TERMINATOR (0xFE)
+
+#ifndef NDEF_MAX_TYPE_LEN
+#define NDEF_MAX_TYPE_LEN (16) // longer record types are truncated in NDEFRecord::type
+#endif
+
+// Parser events
+#define NDEF_EVENT_RECORD_BEGIN (0) // header, type and ID parsed
+#define NDEF_EVENT_PAYLOAD (1)      // next slice of the payload
+#define NDEF_EVENT_RECORD_END (2)
+
+// Parser status
+#define NDEF_PARSE_MORE (0)    // waiting for more data
+#define NDEF_PARSE_DONE (1)    // last record (ME) or terminator TLV reached
+#define NDEF_PARSE_ERROR (2)   // malformed data
+#define NDEF_PARSE_ABORTED (3) // callback returned false
+
+struct NDEFRecord
+{
+  uint8_t index; // record number within the message
+  uint8_t flags; // MB, ME, CF, SR, IL and TNF
+  uint8_t typeLength;
+  uint8_t idLength;
+  uint32_t payloadLength;
+  uint32_t payloadOffset; // offset of the current payload slice
+  uint8_t type[NDEF_MAX_TYPE_LEN];
+};
+
+// Called for every parser event. Payload slices point into the caller's input buffer.
+// Return false to stop parsing.
+typedef bool (*NDEFRecordCallback)(uint8_t event, const NDEFRecord &record, const uint8_t *data, uint16_t len, void *context);
+
+class NDEFParser
+{
+private:
+  NDEFRecordCallback callback;
+  void *context;
+  bool tlv;
+  uint8_t tlvState;
+  uint8_t tlvType;
+  uint16_t tlvRemaining;
+  uint8_t msgState;
+  uint8_t lengthBytes;
+  uint32_t fieldRemaining;
+  uint8_t typePos;
+  uint8_t status;
+  NDEFRecord record;
+
+  uint16_t feedMessage(const uint8_t *data, uint16_t len);
+  bool startPayload();
+  bool endRecord();
+
+public:
+  NDEFParser();
+
+  void begin(NDEFRecordCallback callback, void *context, bool tlv);
+  uint8_t feed(const uint8_t *data, uint16_t len);
+  uint8_t getStatus() const;
+  uint32_t bytesExpected() const;
+};
+
+#endif /* PN5180NDEF_H */
@@ -0,0 +1,63 @@
+// NAME: PN5180NDEFType2.h
+//
+// DESC: NDEF on NFC Forum Type 2 tags (MIFARE Ultralight, NTAG).
+//
+// This file is part of the PN5180 library for the Arduino environment.
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// Lesser General Public License for more details.
+//
+#ifndef PN5180NDEFTYPE2_H
+#define PN5180NDEFTYPE2_H
+
+#include "PN5180ISO14443.h"
+#include "PN5180NDEF.h"
+
+#define NDEF_T2_CC_PAGE (3)
+#define NDEF_T2_DATA_PAGE (4)
+#define NDEF_T2_MAGIC (0xE1)
+#ifndef NDEF_T2_FIRST_READ_PAGES
+#define NDEF_T2_FIRST_READ_PAGES (16) // CC and the start of the TLV area, fits the smallest EV1/NTAG
+#endif
+#ifndef NDEF_T2_READ_PAGES
+#define NDEF_T2_READ_PAGES (16) // next read when the remaining length is not known yet
+#endif
+
+class PN5180NDEFType2
+{
+private:
+  PN5180ISO14443 &nfc;
+  uint8_t cc[4];
+  bool ccValid;
+  NDEFParser parser;
+
+  // Writer state: 8 bytes of page staging regardless of the message size
+  uint16_t writeLength;
+  uint16_t writePayload;
+  uint16_t writePos; // bytes staged from the start of the data area
+  uint8_t firstPage[MIFARE_UL_PAGE_SIZE];
+  uint8_t page[MIFARE_UL_PAGE_SIZE];
+  bool writing;
+  bool stageByte(uint8_t b);
+
+public:
+  PN5180NDEFType2(PN5180ISO14443 &nfc);
+
+  bool readCC();
+  uint16_t getCapacity() const;
+  bool isWritable() const;
+  uint8_t read(NDEFRecordCallback callback, void *context);
+
+  bool beginWrite(uint16_t messageLength);
+  bool write(const uint8_t *data, uint16_t len);
+  bool endWrite();
+};
+
+#endif /* PN5180NDEFTYPE2_H */
@@ -0,0 +1,73 @@
+// NAME: PN5180NDEFType4.h
+//
+// DESC: NDEF on NFC Forum Type 4 tags and HCE phones (ISO-DEP file access).
+//
+// This file is part of the PN5180 library for the Arduino environment.
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// Lesser General Public License for more details.
+//
+#ifndef PN5180NDEFTYPE4_H
+#define PN5180NDEFTYPE4_H
+
+#include "PN5180ISO14443.h"
+#include "PN5180NDEF.h"
+
+#define NDEF_T4_CC_FILE (0xE103)
+#define NDEF_T4_CC_LEN (15)
+#define NDEF_T4_MAX_LE (255) // short APDUs only
+#ifndef NDEF_T4_MAX_LC
+#if defined(__AVR__)
+#define NDEF_T4_MAX_LC (32) // UPDATE BINARY data per command, limited by stack
+#else
+#define NDEF_T4_MAX_LC (128)
+#endif
+#endif
+
+class PN5180NDEFType4
+{
+private:
+  PN5180ISO14443 &nfc;
+  bool selected;
+  uint16_t mle; // max. R-APDU data size from the CC
+  uint16_t mlc; // max. C-APDU data size from the CC
+  uint16_t fileId;
+  uint16_t maxFileSize;
+  uint8_t readAccess;
+  uint8_t writeAccess;
+  uint16_t lastSW;
+
+  // Writer state
+  bool writing;
+  uint16_t writeLength;
+  uint16_t writeOffset;
+
+  bool command(const uint8_t *apdu, uint16_t apduLen, PN5180DataSink sink, void *context, uint16_t *dataLen);
+  bool selectFile(uint16_t id);
+  bool readBinary(uint16_t offset, uint8_t len, PN5180DataSink sink, void *context);
+  bool updateBinary(uint16_t offset, const uint8_t *data, uint8_t len);
+
+public:
+  PN5180NDEFType4(PN5180ISO14443 &nfc);
+
+  bool select();
+  uint16_t getMaxMessageSize() const;
+  bool isWritable() const;
+  uint16_t getLastSW() const;
+
+  bool readRaw(PN5180DataSink sink, void *context, uint16_t *messageLength = 0);
+  uint8_t read(NDEFRecordCallback callback, void *context);
+
+  bool beginWrite(uint16_t messageLength);
+  bool write(const uint8_t *data, uint16_t len);
+  bool endWrite();
+};
+
+#endif /* PN5180NDEFTYPE4_H */
@@ -0,0 +1,82 @@
+// NAME: PN5180Recovery.h
+//
+// DESC: Targeted recovery from unexpected IRQ_STATUS values.
+//
+// This file is part of the PN5180 library for the Arduino environment.
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// Lesser General Public License for more details.
+//
+#ifndef PN5180RECOVERY_H
+#define PN5180RECOVERY_H
+
+#include "PN5180ISO14443.h"
+
+// Causes decoded from IRQ_STATUS (and RX_STATUS)
+#define RECOVERY_CAUSE_NONE (0)
+#define RECOVERY_CAUSE_COLLISION (1)  // RX_STATUS: collision, CRC/parity or framing error
+#define RECOVERY_CAUSE_GENERAL (2)    // GENERAL_ERROR without a received frame
+#define RECOVERY_CAUSE_RF_OFF (3)     // field switched off behind our back (TX_RFOFF)
+#define RECOVERY_CAUSE_RF_ACTIVE (4)  // RF_ACTIVE_ERROR
+#define RECOVERY_CAUSE_TEMP (5)       // TEMPSENS_ERROR, the PN5180 switched the field off
+#define RECOVERY_CAUSE_HV (6)         // HV_ERROR or a readback that cannot be a real status
+#define RECOVERY_CAUSE_UNKNOWN (7)    // unexpected status without error bits
+#define RECOVERY_CAUSE_COUNT (8)
+
+// Actions, cheapest first
+#define RECOVERY_ACTION_NONE (0)
+#define RECOVERY_ACTION_CLEAR (1) // clear IRQ_STATUS
+#define RECOVERY_ACTION_IDLE (2)  // + transceive state machine to Idle
+#define RECOVERY_ACTION_RF (3)    // + RF off, reload RF configuration, RF on
+#define RECOVERY_ACTION_RESET (4) // fastStart() (reset, version check), setupRF()
+#define RECOVERY_ACTION_COUNT (5)
+
+// The same action repeated this often within the window escalates to the next one.
+// TEMP never escalates: the field stays off until PN5180Thermal::rest() has waited.
+#define RECOVERY_ESCALATE_COUNT (3)
+#define RECOVERY_ESCALATE_WINDOW_MS (1000)
+
+// Times in microseconds
+struct PN5180RecoveryStats
+{
+  uint16_t causes[RECOVERY_CAUSE_COUNT];
+  uint16_t actions[RECOVERY_ACTION_COUNT];
+  uint32_t timeSum[RECOVERY_ACTION_COUNT];
+  uint32_t timeMax[RECOVERY_ACTION_COUNT];
+  uint16_t escalations; // action raised by repetition or failed verification
+  uint16_t failures;    // even the reset did not bring the PN5180 back (for TEMP: the IRQ clear failed)
+};
+
+class PN5180Recovery
+{
+private:
+  PN5180ISO14443 &nfc;
+  PN5180RecoveryStats stats;
+  uint8_t lastCause;
+  uint8_t lastAction;
+  uint8_t repeats;   // recoveries of lastCause within the window
+  uint32_t lastTime; // millis() of the previous recovery
+
+  bool apply(uint8_t action);
+
+public:
+  PN5180Recovery(PN5180ISO14443 &nfc);
+
+  uint8_t classify(uint32_t irqStatus);
+  static uint8_t actionFor(uint8_t cause);
+  // Returns the action that restored the reader (RECOVERY_ACTION_NONE if nothing was needed)
+  uint8_t recover(uint32_t irqStatus);
+
+  uint8_t getLastCause() const;
+  const PN5180RecoveryStats &getStats() const;
+  void resetStats();
+};
+
+#endif /* PN5180RECOVERY_H */
@@ -0,0 +1,100 @@
+// NAME: PN5180Thermal.h
+//
+// DESC: Thermal manager: watches the die temperature sensor, stretches the
+//       poll interval (field off while waiting) and lowers the TX driver gear
+//       (a lower gear is a weaker driver) as the reader heats up, restores
+//       full performance after cooling down.
+//
+// This file is part of the PN5180 library for the Arduino environment.
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// Lesser General Public License for more details.
+//
+#ifndef PN5180THERMAL_H
+#define PN5180THERMAL_H
+
+#include "PN5180.h"
+
+// Levels: 0 = full performance, each TEMPSENS_ERROR raises the level by one
+#define THERMAL_LEVELS (4)
+#define THERMAL_SAMPLE_MS (1000)    // one time series sample per interval
+#define THERMAL_COOLDOWN_MS (30000) // without TEMPSENS_ERROR this long: one level down
+#ifndef THERMAL_TEMP_DELTA
+#define THERMAL_TEMP_DELTA (0)      // TEMP_CONTROL shutdown threshold, 0 = the lowest temperature
+#endif
+// The sensor is not a warning: at the threshold the PN5180 switches the field off
+// itself. With the default THERMAL_TEMP_DELTA even level 0 runs with the lowest
+// shutdown threshold, so the first TEMPSENS_ERROR comes well before the die limit.
+#if defined(__AVR__)
+#define THERMAL_SERIES_LEN (16)
+#else
+#define THERMAL_SERIES_LEN (64)
+#endif
+
+struct PN5180ThermalSample
+{
+  uint16_t time;  // s since begin()
+  uint8_t level;
+  uint8_t duty;   // field on, % of the sample interval
+  uint8_t alarms; // TEMPSENS_ERROR seen in the interval
+};
+
+class PN5180Thermal
+{
+private:
+  PN5180 &nfc;
+  uint8_t level;
+  uint8_t baseGear;  // TX driver gear of the loaded RF configuration, read after every load
+  bool dirty;        // sensor threshold or gear must be written again
+  bool fieldCut;     // TEMPSENS_ERROR: the sensor switched the field off, rest() switches it on
+  uint32_t startTime;
+  uint32_t levelTime;  // millis() of the last level change or alarm
+  uint32_t sampleTime; // start of the current sample interval
+  uint32_t offTime;    // field off in the current interval, ms
+  uint8_t alarms;
+  uint16_t totalAlarms;
+  PN5180ThermalSample series[THERMAL_SERIES_LEN];
+  uint8_t seriesHead;  // next slot
+  uint8_t seriesCount;
+
+  bool applyConfig();
+  bool applyGear(PN5180 &chip, bool readBase);
+  static void onRFConfigLoaded(PN5180 &chip, void *context);
+  void setLevel(uint8_t newLevel, uint32_t now);
+  void takeSample(uint32_t now);
+
+public:
+  PN5180Thermal(PN5180 &nfc);
+
+  // After setupRF(): programs the sensor threshold and the TX gear; registers the
+  // PN5180 RF configuration hook, so the gear survives every LOAD_RF_CONFIG
+  bool begin();
+  // Called with the IRQ_STATUS read in loop() (no extra SPI); returns true on a level change.
+  // A TEMPSENS_ERROR is only recorded: PN5180Recovery clears the IRQ and leaves the field
+  // off, rest() switches it back on after the pause of the new level.
+  bool update(uint32_t irqStatus);
+  // The PN5180 was reset: program threshold and gear again
+  void invalidate();
+  // Pause between polls for the current level with the field off, then the field on again
+  // (also after the sensor cut it, without waiting for RF_OFF); wait() keeps the sketch serviced
+  void rest(void (*wait)(unsigned long ms));
+
+  uint8_t getLevel() const;
+  uint16_t pollInterval() const; // ms
+  uint8_t gear() const;
+  uint16_t getAlarms() const;
+  // Samples oldest first; index < getSampleCount()
+  uint8_t getSampleCount() const;
+  const PN5180ThermalSample &getSample(uint8_t index) const;
+  // CSV: time_s,level,duty_pct,alarms
+  void printSeries(Print &out) const;
+};
+
+#endif /* PN5180THERMAL_H */
@@ -0,0 +1,75 @@
+// NAME: PN5180Tuning.h
+//
+// DESC: On-device RF calibration: sweeps the TX driver gear, measures AGC
+//       with and without a reference card and the activation time, and
+//       stores the best setting in the PN5180 EEPROM.
+//
+// This file is part of the PN5180 library for the Arduino environment.
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// Lesser General Public License for more details.
+//
+#ifndef PN5180TUNING_H
+#define PN5180TUNING_H
+
+#include "PN5180ISO14443.h"
+#include "PN5180EepromConfig.h"
+
+#define DPC_CONTROL_ENABLE (0x01) // EEPROM DPC_CONTROL bit 0
+
+#define PN5180_TUNE_GEARS (16)
+#ifndef PN5180_TUNE_ATTEMPTS
+#define PN5180_TUNE_ATTEMPTS (8) // activations per gear with the reference card
+#endif
+#define PN5180_TUNE_SETTLE_MS (2) // AGC settling after a gear change
+
+// Times in microseconds
+struct PN5180TuningStep
+{
+  uint16_t agcIdle;   // AGC without a card
+  uint16_t agcCard;   // AGC with the reference card
+  uint8_t successes;  // activations out of PN5180_TUNE_ATTEMPTS
+  uint32_t timeSum;   // sum over successful activations
+  uint32_t timeMax;
+};
+
+class PN5180Tuning
+{
+private:
+  PN5180ISO14443 &nfc;
+  PN5180TuningStep steps[PN5180_TUNE_GEARS];
+  uint32_t savedRefConfig;
+  uint8_t attempts;  // 0 until measureCard()
+  bool idleMeasured;
+
+  bool selectGear(uint8_t gear);
+  bool readAgc(uint16_t *agc);
+  bool restore();
+
+public:
+  PN5180Tuning(PN5180ISO14443 &nfc);
+
+  // Step 1: field on, no card; records the unloaded AGC for every gear
+  bool measureIdle();
+  // True when a card answers WUPA with the current settings
+  bool cardPresent();
+  // Step 2: reference card in place; AGC, success rate and activation time for every gear
+  bool measureCard(uint8_t attempts = PN5180_TUNE_ATTEMPTS);
+  // Gear with the most activations, then the shortest mean time, then the largest AGC change;
+  // -1 if the card was never activated
+  int8_t best() const;
+  const PN5180TuningStep &getStep(uint8_t gear) const;
+  // Stores the gear and the unloaded AGC as DPC reference in the ISO14443A RF configuration
+  // (UPDATE_RF_CONFIG) and enables DPC in the EEPROM; returns an EECFG_* code
+  uint8_t store(int8_t gear);
+  void print(Print &out) const;
+};
+
+#endif /* PN5180TUNING_H */
@@ -0,0 +1,95 @@
+// NAME: PN5180TxRing.h
+//
+// DESC: Non-blocking output ring in front of the serial port.
+//
+// This file is part of the PN5180 library for the Arduino environment.
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// Lesser General Public License for more details.
+//
+#ifndef PN5180TXRING_H
+#define PN5180TXRING_H
+
+#include <Arduino.h>
+
+#ifndef PN5180_TX_RING_SIZE
+#if defined(__AVR__)
+#define PN5180_TX_RING_SIZE (128)
+#else
+#define PN5180_TX_RING_SIZE (1024)
+#endif
+#endif
+// Space kept for high priority output: low priority writes stop at this much free space
+#define PN5180_TX_RESERVE (PN5180_TX_RING_SIZE / 4)
+
+#define PN5180_TX_LOW (0)  // log text, dropped line by line on overflow
+#define PN5180_TX_HIGH (1) // events, dropped only when the ring is full, whole writes at a time
+
+struct PN5180TxStats
+{
+  uint32_t bytes;           // accepted into the ring
+  uint16_t droppedLines;    // low priority lines cut or lost
+  uint16_t droppedMessages; // high priority writes lost
+  uint32_t droppedBytes;
+  uint16_t maxUsed;
+};
+
+/*
+ * Output is queued and moved to the port only as far as availableForWrite()
+ * allows, so a write never waits for the UART. The port's own buffer is
+ * refilled on every write and by service(), which loop() should call often.
+ */
+class PN5180TxRing
+{
+private:
+  Print &out;
+  uint8_t buffer[PN5180_TX_RING_SIZE];
+  uint16_t head; // next byte to write
+  uint16_t tail; // next byte to send
+  PN5180TxStats stats;
+
+public:
+  PN5180TxRing(Print &out);
+
+  uint16_t used() const;
+  uint16_t available() const;
+  bool put(uint8_t c, uint8_t priority);
+  bool put(const uint8_t *data, uint16_t len);
+
+  void service();
+  // Blocks until everything queued is handed to the port
+  void flush();
+
+  const PN5180TxStats &getStats() const;
+  void resetStats();
+
+  friend class PN5180TxChannel;
+};
+
+// Print front end of one priority
+class PN5180TxChannel : public Print
+{
+private:
+  PN5180TxRing &ring;
+  uint8_t priority;
+  bool midLine;  // bytes of the current line already queued
+  bool dropping; // rest of the current line is discarded
+
+public:
+  PN5180TxChannel(PN5180TxRing &ring, uint8_t priority);
+
+  size_t write(uint8_t c);
+  size_t write(const uint8_t *data, size_t len);
+  using Print::write;
+  int availableForWrite();
+  void flush();
+};
+
+#endif /* PN5180TXRING_H */
@@ -0,0 +1,364 @@
+// Generated by extras/host/build_allowlist, do not edit.
+// 256 UIDs, 1164 bytes.
+
+#include <Arduino.h>
+
+static const uint8_t allowlistBench[1164] PROGMEM = {
+  0x50, 0x4E, 0x41, 0x4C, 0x01, 0x00, 0x00, 0x01, 0x40, 0x00, 0x00, 0x00,
+  0x01, 0x00, 0x13, 0x00, 0x0B, 0x00, 0x12, 0x00, 0x35, 0x00, 0x00, 0x00,
+  0x1A, 0x00, 0x17, 0x00, 0x01, 0x00, 0x10, 0x00, 0x10, 0x00, 0x87, 0x01,
+  0x1D, 0x00, 0x2D, 0x00, 0x60, 0x00, 0x60, 0x00, 0x00, 0x00, 0x1E, 0x00,
+  0x92, 0x00, 0x2C, 0x00, 0x5B, 0x00, 0x00, 0x00, 0x26, 0x00, 0x2F, 0x00,
+  0x01, 0x00, 0x01, 0x00, 0x00, 0x00, 0x20, 0x00, 0x03, 0x00, 0x00, 0x00,
+  0x3C, 0x00, 0x1F, 0x00, 0x82, 0x00, 0x08, 0x00, 0xB6, 0x80, 0x04, 0x00,
+  0x38, 0x00, 0x7F, 0x00, 0x7A, 0x00, 0x2E, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0xB9, 0x00, 0x49, 0x01, 0x61, 0x00, 0xF0, 0x00, 0xC5, 0x01, 0x4E, 0x03,
+  0x81, 0x08, 0x01, 0x00, 0x15, 0x00, 0x5D, 0x00, 0xB7, 0x80, 0xD0, 0x02,
+  0x26, 0x24, 0x03, 0x00, 0x12, 0x00, 0x01, 0x00, 0x08, 0x00, 0xE3, 0x00,
+  0x00, 0x00, 0xFC, 0x0D, 0x0A, 0x00, 0x81, 0x04, 0x1F, 0x49, 0x9B, 0x13,
+  0x0F, 0xA0, 0xB4, 0x2C, 0x95, 0x90, 0xE6, 0xA2, 0x7D, 0x8C, 0x80, 0x16,
+  0x5A, 0xE6, 0xEB, 0x90, 0xA6, 0x38, 0xFD, 0x4C, 0x47, 0x92, 0x90, 0x01,
+  0x61, 0xBE, 0xE7, 0x4D, 0x30, 0x75, 0x11, 0x0B, 0x7B, 0xC9, 0x59, 0x5D,
+  0xED, 0x6A, 0x83, 0x01, 0x1B, 0x12, 0x7A, 0x6D, 0xFB, 0x06, 0xE1, 0x25,
+  0x5B, 0x07, 0xCC, 0x96, 0xAA, 0xC1, 0x21, 0xF2, 0xD5, 0xFA, 0xC9, 0x7C,
+  0x1F, 0x6A, 0xF1, 0xD6, 0x83, 0x99, 0xC6, 0xF1, 0xD7, 0xBD, 0x1E, 0x3C,
+  0x3B, 0x88, 0xA0, 0x2A, 0xDE, 0xCA, 0x34, 0xAF, 0x62, 0x58, 0xC7, 0xE9,
+  0x44, 0xA3, 0x30, 0x21, 0xC9, 0x70, 0xF6, 0x87, 0xD9, 0x0E, 0xE6, 0xED,
+  0xDC, 0x2F, 0xE5, 0x28, 0x5D, 0x03, 0x6B, 0x34, 0x0D, 0x85, 0x14, 0x06,
+  0xD2, 0xA1, 0x9C, 0x73, 0xDB, 0xF8, 0x30, 0x85, 0xFE, 0x93, 0xF8, 0x59,
+  0x8C, 0x66, 0x04, 0x38, 0xED, 0x4C, 0x21, 0x87, 0xE8, 0x55, 0x1C, 0x7E,
+  0xA4, 0x11, 0x59, 0x0A, 0x6C, 0x83, 0x42, 0x09, 0x50, 0xFA, 0xC0, 0x53,
+  0xA3, 0x90, 0x58, 0xC8, 0x77, 0xC6, 0xA9, 0x1B, 0x07, 0xAC, 0xB7, 0xFD,
+  0x59, 0xA2, 0x82, 0x78, 0x7E, 0xC9, 0xBC, 0x95, 0xEC, 0x52, 0xD5, 0xA1,
+  0x3B, 0x19, 0x64, 0x17, 0x5A, 0x69, 0x84, 0x48, 0x9C, 0x1B, 0x47, 0x26,
+  0x57, 0xED, 0x2B, 0xA0, 0xE9, 0x95, 0x8F, 0x4A, 0x5E, 0x80, 0xD4, 0x8E,
+  0x44, 0xB3, 0x85, 0x01, 0xE8, 0xEB, 0xF8, 0x7A, 0xBE, 0x9E, 0xB4, 0xF0,
+  0xF3, 0xB1, 0xEE, 0x75, 0x57, 0x0B, 0xC3, 0xA2, 0xC7, 0xE4, 0x0A, 0x65,
+  0xE7, 0xF7, 0xDD, 0xA3, 0x8A, 0x5A, 0xBE, 0xE4, 0xB1, 0xDB, 0xAB, 0x21,
+  0x36, 0x25, 0x44, 0xCB, 0x6B, 0xE0, 0x3E, 0xC9, 0x79, 0x6A, 0xBC, 0x30,
+  0xAB, 0xB9, 0xFC, 0xC8, 0x8A, 0x0D, 0x67, 0x0D, 0xBD, 0x2F, 0xBA, 0x05,
+  0x1D, 0xDB, 0xBC, 0x7B, 0x21, 0xDD, 0x53, 0x92, 0x53, 0xA5, 0x6E, 0x42,
+  0xC2, 0x99, 0xD1, 0x47, 0x01, 0x6E, 0x4C, 0x42, 0x8D, 0xD2, 0x44, 0x25,
+  0x01, 0xAD, 0xD4, 0xDD, 0xFC, 0xC2, 0x34, 0xF7, 0xCC, 0x36, 0x82, 0xA3,
+  0x59, 0xB0, 0x25, 0x70, 0xF0, 0x64, 0xB5, 0xF5, 0x5B, 0x7D, 0xF3, 0x63,
+  0xEF, 0x3A, 0x78, 0x8F, 0xEB, 0xF5, 0x1E, 0x3F, 0xA3, 0xBE, 0x82, 0xC3,
+  0x9E, 0xF6, 0xE9, 0x1E, 0x47, 0x1F, 0xA6, 0x92, 0xDB, 0x3B, 0x54, 0xB0,
+  0x33, 0xA7, 0x55, 0x96, 0xEA, 0x8C, 0x06, 0xF9, 0x58, 0xE4, 0x07, 0x94,
+  0x64, 0xDB, 0xE7, 0x00, 0xEC, 0x67, 0x86, 0x2F, 0xAE, 0x28, 0x42, 0xD6,
+  0x9D, 0xDD, 0xE7, 0x05, 0x44, 0x76, 0x71, 0xB1, 0x50, 0xC6, 0xCC, 0xE9,
+  0xC5, 0x37, 0x6D, 0x65, 0x6E, 0xFB, 0x97, 0xEA, 0x08, 0x14, 0x7E, 0xC5,
+  0x12, 0xED, 0xA6, 0x46, 0x8E, 0x36, 0x92, 0xCD, 0xAA, 0x64, 0xAC, 0x1B,
+  0x9D, 0xE5, 0xE0, 0x3E, 0x7D, 0xFD, 0x7C, 0x77, 0x0A, 0x3F, 0x23, 0xC5,
+  0x24, 0x9B, 0x81, 0x3B, 0x21, 0x71, 0xE7, 0xFB, 0xD8, 0x80, 0xA4, 0xE6,
+  0x32, 0x09, 0xB8, 0xBA, 0xB0, 0x0F, 0x6F, 0x9E, 0xFC, 0xCA, 0xF4, 0x0D,
+  0x0E, 0x6A, 0x89, 0x33, 0x8D, 0x56, 0x4C, 0x91, 0x3F, 0xDA, 0xAB, 0xB0,
+  0x81, 0xBC, 0x63, 0xE1, 0x59, 0xA2, 0x5C, 0xC5, 0x6D, 0x18, 0x2B, 0x7C,
+  0x8E, 0xFC, 0x5A, 0x85, 0x6E, 0xC7, 0xE5, 0xE6, 0xD6, 0x3D, 0xF4, 0x62,
+  0x74, 0xDA, 0xF2, 0xA9, 0xED, 0x75, 0xCD, 0x22, 0x62, 0xBE, 0xEA, 0x87,
+  0xE7, 0x43, 0x0E, 0x57, 0x5B, 0x0E, 0x34, 0x60, 0x0A, 0xE4, 0x0E, 0xAB,
+  0x12, 0x6A, 0xEE, 0x76, 0x8E, 0x50, 0x0A, 0x74, 0xC9, 0xBE, 0x4E, 0x82,
+  0xDA, 0x67, 0x28, 0xFC, 0x82, 0x77, 0x55, 0x55, 0x55, 0x44, 0x13, 0x96,
+  0xA0, 0x77, 0x47, 0x03, 0xC9, 0xF3, 0x8B, 0x79, 0x8B, 0x1D, 0x3C, 0x26,
+  0xF5, 0xDC, 0xEE, 0x16, 0x33, 0x1A, 0x56, 0x14, 0x56, 0x47, 0xA1, 0x6D,
+  0xC8, 0x54, 0x9E, 0xF3, 0xE7, 0x78, 0x6F, 0xA0, 0xFB, 0xA4, 0x06, 0xE2,
+  0x46, 0xC4, 0x2A, 0x43, 0x9D, 0xC9, 0xA7, 0x9C, 0x96, 0x14, 0x91, 0x3E,
+  0xAC, 0xB8, 0x30, 0xE7, 0x93, 0x13, 0x05, 0x14, 0x5A, 0x25, 0xC5, 0x60,
+  0x26, 0xA2, 0xFC, 0xB4, 0xD4, 0xF6, 0x62, 0x57, 0x3C, 0x50, 0x08, 0x8F,
+  0x3F, 0x38, 0x63, 0x77, 0x27, 0x96, 0x6C, 0xF2, 0x15, 0x61, 0xED, 0x98,
+  0x7A, 0x6B, 0xED, 0x4D, 0x95, 0xC2, 0xDE, 0x60, 0x4A, 0xC8, 0x47, 0xDE,
+  0x13, 0x00, 0x41, 0x63, 0x9C, 0xA8, 0x5C, 0x02, 0x8D, 0x68, 0x15, 0x06,
+  0xF9, 0x36, 0x26, 0xFB, 0xA3, 0x32, 0x2C, 0xED, 0x8B, 0x8D, 0xEA, 0x61,
+  0x4A, 0x61, 0x05, 0x01, 0x45, 0x92, 0x21, 0x37, 0x7A, 0x7A, 0x9C, 0xC6,
+  0x47, 0xFC, 0xAD, 0xF8, 0x1E, 0x03, 0x64, 0x37, 0xC9, 0x9E, 0xC6, 0xD8,
+  0x07, 0x5B, 0xE4, 0x7D, 0x27, 0xA8, 0x23, 0x5B, 0x3F, 0x77, 0x63, 0x1B,
+  0xED, 0x30, 0x9F, 0xB6, 0x3F, 0xA1, 0x69, 0xC6, 0xB3, 0x3B, 0xA3, 0x76,
+  0x32, 0xFB, 0x5A, 0xCF, 0xEE, 0x99, 0x98, 0xBC, 0xBB, 0x96, 0x5A, 0xC4,
+  0xCE, 0x28, 0x81, 0xAB, 0x27, 0x13, 0x08, 0xF8, 0x14, 0xCA, 0x53, 0x55,
+  0x28, 0x46, 0x87, 0xE7, 0x69, 0x7D, 0xA6, 0xDD, 0x7D, 0x4B, 0x89, 0x9E,
+  0x7A, 0x63, 0x0C, 0x3A, 0x03, 0x6E, 0xC2, 0xEF, 0x62, 0x9C, 0xDC, 0x14,
+  0xC3, 0x22, 0xBD, 0xE3, 0x91, 0xE5, 0xBA, 0x88, 0xAD, 0x6C, 0x89, 0xD1,
+  0xE8, 0xD8, 0x43, 0xE4, 0x54, 0x76, 0x8E, 0x18, 0x1E, 0xED, 0x64, 0x53,
+  0x48, 0x68, 0x94, 0xDB, 0xBA, 0x7C, 0x35, 0x80, 0xA7, 0x08, 0x4D, 0xF0,
+  0x2B, 0x39, 0x1F, 0xE8, 0x0F, 0xF9, 0xFB, 0xF6, 0xB3, 0xD4, 0x98, 0x3A,
+  0x6A, 0x0E, 0xD0, 0x4F, 0x8F, 0xB2, 0x6F, 0x64, 0x82, 0x34, 0x23, 0xF1,
+  0x83, 0x82, 0x3E, 0xF2, 0xA5, 0xFE, 0xE2, 0x70, 0xAB, 0x0E, 0x6B, 0x09,
+  0xEC, 0x70, 0x6A, 0xCE, 0xB4, 0xF2, 0x03, 0x27, 0x93, 0x0C, 0xC7, 0xB7,
+  0x10, 0x9E, 0x54, 0xA9, 0xBA, 0xA0, 0x13, 0x0C, 0x2A, 0x9E, 0x59, 0x49,
+  0xC6, 0x51, 0xCE, 0x6F, 0x82, 0x42, 0xB4, 0x07, 0xEA, 0xB3, 0x40, 0x87,
+  0x89, 0xC2, 0x47, 0xBC, 0x37, 0x2A, 0x60, 0xE8, 0x89, 0x8C, 0xCB, 0x32,
+  0x64, 0x29, 0x3B, 0xD5, 0x1E, 0x88, 0xDF, 0xF2, 0x04, 0xCA, 0x85, 0xE6,
+  0xB8, 0x49, 0xC8, 0x01, 0x7E, 0x36, 0x8D, 0x30, 0x93, 0x12, 0x2C, 0xAF,
+  0xBE, 0xDF, 0x6F, 0x2A, 0x0B, 0xF6, 0x79, 0xFC, 0x1E, 0xAD, 0x45, 0xE2,
+  0x5F, 0x42, 0x5F, 0x17, 0x5E, 0x07, 0x29, 0x20, 0x61, 0x8C, 0x2E, 0x78,
+  0xC4, 0x0A, 0x09, 0xB1, 0x71, 0xBC, 0x2C, 0x1C, 0x17, 0x1D, 0xC5, 0x54,
+  0xD8, 0x16, 0x4C, 0x91, 0xA3, 0xBC, 0x2F, 0x4F, 0xE4, 0x18, 0x8D, 0xE9,
+  0xE8, 0xAC, 0x89, 0x64, 0xAE, 0x56, 0x5A, 0x65, 0x06, 0x80, 0xAD, 0x6C,
+  0xFE, 0x14, 0x24, 0xBA, 0xEE, 0xE7, 0x01, 0x99, 0x43, 0x10, 0xF1, 0x9C,
+  0xBA, 0xE2, 0x73, 0xC2, 0x4E, 0xBC, 0x97, 0x72, 0xDE, 0x41, 0x5A, 0x75,
+  0xB0, 0xE3, 0xAC, 0xDE, 0xFB, 0xB6, 0x76, 0x5E, 0x23, 0xD3, 0x95, 0x64,
+  0x28, 0xD6, 0xD7, 0x36, 0x85, 0x31, 0xC1, 0x13, 0x75, 0xF0, 0xD6, 0xDD,
+  0x0B, 0x4D, 0x03, 0x80, 0x19, 0xCA, 0xFF, 0x28, 0x24, 0x40, 0xF0, 0xC6,
+  0x09, 0x5B, 0x5F, 0x56, 0xBE, 0x8A, 0xC0, 0x99, 0x50, 0x96, 0xEA, 0xCB,
+  0x3A, 0xA4, 0x59, 0x9E, 0xF9, 0xBB, 0x6C, 0x20, 0xE5, 0xE6, 0xC8, 0xE0,
+  0xD1, 0x35, 0xB2, 0x35, 0xB3, 0x63, 0x8D, 0xE1, 0x21, 0x5C, 0x85, 0xDE,
+};
+
+static const uint16_t allowlistBenchKeyCount = 256;
+static const uint8_t allowlistBenchKeys[256][11] PROGMEM = {
+  {0x04, 0x1C, 0xE7, 0xB6, 0xAA, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+  {0x07, 0x04, 0x2F, 0x5E, 0x14, 0xE5, 0x25, 0x6D, 0x00, 0x00, 0x00},
+  {0x04, 0x60, 0xD1, 0xBA, 0xE5, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+  {0x07, 0x04, 0x1E, 0x8A, 0xEA, 0xC7, 0x14, 0x82, 0x00, 0x00, 0x00},
+  {0x04, 0x9A, 0x44, 0x7E, 0x33, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+  {0x04, 0xCD, 0xD5, 0x1F, 0xF4, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+  {0x07, 0x04, 0xB4, 0x6F, 0x8C, 0xAE, 0xA1, 0x5E, 0x00, 0x00, 0x00},
+  {0x04, 0x71, 0xEE, 0x13, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+  {0x07, 0x04, 0x7C, 0x8A, 0x6D, 0xC0, 0x20, 0x94, 0x00, 0x00, 0x00},
+  {0x07, 0x04, 0xB0, 0xBF, 0xBF, 0x82, 0x64, 0x0D, 0x00, 0x00, 0x00},
+  {0x07, 0x04, 0xE8, 0xC2, 0x83, 0xC8, 0x3A, 0x17, 0x00, 0x00, 0x00},
+  {0x07, 0x04, 0x1A, 0x48, 0x70, 0x9C, 0xA9, 0xC8, 0x00, 0x00, 0x00},
+  {0x07, 0x04, 0x23, 0x89, 0x2E, 0xD3, 0x22, 0xA0, 0x00, 0x00, 0x00},
+  {0x04, 0x56, 0xD1, 0xBA, 0x83, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+  {0x07, 0x04, 0x78, 0xF7, 0xA0, 0x5A, 0xA7, 0xC2, 0x00, 0x00, 0x00},
+  {0x0A, 0x88, 0x3F, 0xBB, 0xB6, 0x01, 0xB1, 0xBA, 0xB6, 0xC5, 0x67},
+  {0x04, 0x8A, 0x97, 0x89, 0xEA, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+  {0x04, 0x78, 0x8A, 0xBA, 0x89, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+  {0x07, 0x04, 0x38, 0x06, 0xE1, 0x01, 0x6F, 0x21, 0x00, 0x00, 0x00},
+  {0x04, 0x6E, 0xD0, 0xA4, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+  {0x07, 0x04, 0xD5, 0xA4, 0x7A, 0x83, 0x21, 0xA5, 0x00, 0x00, 0x00},
+  {0x07, 0x04, 0xF8, 0x44, 0x6D, 0x60, 0xA4, 0x21, 0x00, 0x00, 0x00},
+  {0x04, 0x01, 0x51, 0x58, 0xDC, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+  {0x07, 0x04, 0x24, 0x46, 0xA5, 0x2F, 0xC1, 0x62, 0x00, 0x00, 0x00},
+  {0x04, 0x5D, 0x3E, 0x2C, 0xCF, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+  {0x07, 0x04, 0x85, 0x33, 0x0D, 0x01, 0x90, 0x73, 0x00, 0x00, 0x00},
+  {0x04, 0x95, 0x6C, 0x13, 0xE9, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+  {0x04, 0x20, 0x02, 0x1A, 0x4E, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+  {0x07, 0x04, 0x8B, 0xAD, 0x6B, 0x17, 0xB5, 0xA7, 0x00, 0x00, 0x00},
+  {0x04, 0xD8, 0x13, 0x34, 0xD7, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+  {0x07, 0x04, 0x26, 0x6E, 0xCB, 0x98, 0xCA, 0x41, 0x00, 0x00, 0x00},
+  {0x04, 0xA1, 0xF9, 0xB1, 0xE3, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+  {0x0A, 0x83, 0xBB, 0x60, 0xF1, 0x8D, 0x40, 0xE6, 0x7C, 0x2D, 0x75},
+  {0x07, 0x04, 0x49, 0x75, 0x99, 0xC1, 0xA4, 0x1C, 0x00, 0x00, 0x00},
+  {0x04, 0x9B, 0xF0, 0xAC, 0xBC, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+  {0x04, 0x38, 0xB2, 0x7D, 0x1C, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+  {0x07, 0x04, 0x18, 0x98, 0x47, 0x33, 0xAD, 0xB9, 0x00, 0x00, 0x00},
+  {0x07, 0x04, 0xBD, 0x63, 0x0A, 0xEC, 0xBE, 0x0A, 0x00, 0x00, 0x00},
+  {0x07, 0x04, 0x5C, 0xC6, 0xA0, 0xDE, 0x4E, 0xFB, 0x00, 0x00, 0x00},
+  {0x07, 0x04, 0x8D, 0xB2, 0x8F, 0x1C, 0xEF, 0x2A, 0x00, 0x00, 0x00},
+  {0x07, 0x04, 0x1B, 0x1A, 0xE0, 0xB7, 0x10, 0x4A, 0x00, 0x00, 0x00},
+  {0x07, 0x04, 0xA0, 0xEA, 0x5E, 0xB7, 0x6D, 0x11, 0x00, 0x00, 0x00},
+  {0x04, 0x08, 0x2E, 0xAD, 0x1C, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+  {0x04, 0x7D, 0xA5, 0x22, 0x47, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+  {0x07, 0x04, 0xAF, 0xFD, 0x33, 0xC7, 0x5A, 0x5E, 0x00, 0x00, 0x00},
+  {0x04, 0x15, 0x8B, 0x25, 0x69, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+  {0x07, 0x04, 0xA2, 0x7A, 0x5C, 0x97, 0x4C, 0x95, 0x00, 0x00, 0x00},
+  {0x04, 0xEB, 0x3E, 0xCE, 0xAE, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+  {0x04, 0x58, 0x88, 0x4F, 0xDC, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+  {0x07, 0x04, 0xF9, 0x85, 0x24, 0x93, 0xED, 0x93, 0x00, 0x00, 0x00},
+  {0x0A, 0x1E, 0xE2, 0x04, 0xA6, 0xD3, 0xFC, 0xA8, 0xC0, 0x5F, 0xD1},
+  {0x07, 0x04, 0xC3, 0xF3, 0x92, 0x96, 0x5C, 0xC1, 0x00, 0x00, 0x00},
+  {0x0A, 0xCC, 0x58, 0x05, 0xA5, 0xB0, 0x2C, 0x4B, 0x29, 0xC2, 0xC1},
+  {0x04, 0x2B, 0xDC, 0x6F, 0xEE, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+  {0x04, 0x4D, 0xA9, 0x0F, 0x9C, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+  {0x04, 0x33, 0xCD, 0x26, 0x47, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+  {0x04, 0x03, 0x0C, 0x56, 0xAC, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+  {0x07, 0x04, 0xCF, 0x74, 0xCE, 0x03, 0xD4, 0x14, 0x00, 0x00, 0x00},
+  {0x0A, 0xA7, 0xD7, 0xC6, 0xD1, 0xCC, 0x4E, 0xA7, 0x00, 0xE6, 0x03},
+  {0x04, 0x73, 0x64, 0xAA, 0x17, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+  {0x07, 0x04, 0x3E, 0xC0, 0x1D, 0xB7, 0xB3, 0x33, 0x00, 0x00, 0x00},
+  {0x07, 0x04, 0xCD, 0x7B, 0xA2, 0xD6, 0x91, 0x38, 0x00, 0x00, 0x00},
+  {0x04, 0xC5, 0x90, 0xC4, 0x7B, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+  {0x04, 0x01, 0xE1, 0x6F, 0xD7, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+  {0x04, 0xB8, 0xA4, 0x60, 0x0B, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+  {0x04, 0x28, 0xD3, 0x67, 0x2D, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+  {0x04, 0xED, 0x76, 0xD7, 0x30, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+  {0x04, 0xB3, 0x85, 0xF8, 0xBF, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+  {0x07, 0x04, 0x44, 0x35, 0x45, 0xE7, 0x00, 0xCC, 0x00, 0x00, 0x00},
+  {0x07, 0x04, 0x1D, 0x58, 0x04, 0xE7, 0x08, 0xAC, 0x00, 0x00, 0x00},
+  {0x07, 0x04, 0xA1, 0x46, 0x62, 0xE4, 0x55, 0x7D, 0x00, 0x00, 0x00},
+  {0x07, 0x04, 0xA9, 0x03, 0x8E, 0x71, 0x41, 0xF6, 0x00, 0x00, 0x00},
+  {0x0A, 0x99, 0x30, 0x92, 0x53, 0xD5, 0x3E, 0x2E, 0xF4, 0x07, 0x80},
+  {0x07, 0x04, 0x82, 0xC0, 0x20, 0x1A, 0x12, 0x0F, 0x00, 0x00, 0x00},
+  {0x0A, 0x2E, 0x04, 0x15, 0xC3, 0xAA, 0x7E, 0xFD, 0x67, 0x62, 0x88},
+  {0x0A, 0xAD, 0x1A, 0x2C, 0xC2, 0x8F, 0x49, 0x36, 0xE8, 0x8B, 0xFE},
+  {0x07, 0x04, 0xD8, 0x0A, 0x03, 0x11, 0xED, 0x1B, 0x00, 0x00, 0x00},
+  {0x07, 0x04, 0x01, 0x55, 0xAF, 0x46, 0xED, 0xA3, 0x00, 0x00, 0x00},
+  {0x07, 0x04, 0xA2, 0x4D, 0xFC, 0xC3, 0x1E, 0x3B, 0x00, 0x00, 0x00},
+  {0x04, 0xEE, 0xB9, 0x2F, 0xF2, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+  {0x04, 0x67, 0x47, 0xAF, 0xD3, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+  {0x07, 0x04, 0x8E, 0x47, 0xB0, 0x25, 0x18, 0x3B, 0x00, 0x00, 0x00},
+  {0x04, 0x98, 0x4C, 0x5E, 0x65, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+  {0x07, 0x04, 0x8E, 0x84, 0x0C, 0x32, 0x8F, 0xC4, 0x00, 0x00, 0x00},
+  {0x07, 0x04, 0x89, 0x80, 0x5E, 0x32, 0x1F, 0x80, 0x00, 0x00, 0x00},
+  {0x04, 0xA4, 0x67, 0x53, 0x61, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+  {0x07, 0x04, 0x29, 0xD6, 0xA9, 0xF3, 0xDC, 0x35, 0x00, 0x00, 0x00},
+  {0x04, 0xFB, 0x7E, 0xF9, 0x64, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+  {0x07, 0x04, 0x3E, 0x12, 0x8A, 0x69, 0x39, 0xA8, 0x00, 0x00, 0x00},
+  {0x07, 0x04, 0x19, 0x17, 0x13, 0x5F, 0x1B, 0x19, 0x00, 0x00, 0x00},
+  {0x04, 0xF2, 0x60, 0x4D, 0x39, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+  {0x07, 0x04, 0xBB, 0xB2, 0x7B, 0x5F, 0xB4, 0xDB, 0x00, 0x00, 0x00},
+  {0x07, 0x04, 0x75, 0x6A, 0x9B, 0xD6, 0x39, 0x8B, 0x00, 0x00, 0x00},
+  {0x04, 0x09, 0xC0, 0x80, 0x52, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+  {0x0A, 0xAC, 0x16, 0x2A, 0x3E, 0x34, 0x9C, 0xDA, 0x52, 0xDC, 0x3B},
+  {0x07, 0x04, 0xD8, 0x64, 0xF7, 0x44, 0x9D, 0xB8, 0x00, 0x00, 0x00},
+  {0x04, 0x0C, 0xAC, 0x95, 0x20, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+  {0x07, 0x04, 0x02, 0xA2, 0x43, 0x23, 0xCF, 0x66, 0x00, 0x00, 0x00},
+  {0x04, 0xF0, 0xCA, 0x84, 0x0E, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+  {0x07, 0x04, 0x6D, 0x0B, 0x98, 0x66, 0x5A, 0xBC, 0x00, 0x00, 0x00},
+  {0x07, 0x04, 0x37, 0x45, 0x09, 0xB9, 0xC3, 0x19, 0x00, 0x00, 0x00},
+  {0x07, 0x04, 0x80, 0x1A, 0xD3, 0x9C, 0x20, 0xDA, 0x00, 0x00, 0x00},
+  {0x07, 0x04, 0x56, 0xE6, 0xC1, 0xA6, 0xB8, 0xD8, 0x00, 0x00, 0x00},
+  {0x07, 0x04, 0x04, 0x4C, 0xE8, 0x87, 0x6D, 0xC5, 0x00, 0x00, 0x00},
+  {0x07, 0x04, 0xC1, 0x97, 0x1A, 0xB9, 0x44, 0xF9, 0x00, 0x00, 0x00},
+  {0x0A, 0xF7, 0x2F, 0xCE, 0xEC, 0xA7, 0x6D, 0xBF, 0x99, 0xCA, 0xF6},
+  {0x07, 0x04, 0x0A, 0xBC, 0xE6, 0x33, 0xEB, 0x8D, 0x00, 0x00, 0x00},
+  {0x0A, 0x57, 0x01, 0xAC, 0x87, 0x7D, 0x32, 0x98, 0x51, 0x9F, 0xE4},
+  {0x07, 0x04, 0x55, 0xE1, 0x9D, 0xE0, 0x05, 0x3E, 0x00, 0x00, 0x00},
+  {0x07, 0x04, 0x65, 0x38, 0x02, 0x14, 0xC8, 0xE3, 0x00, 0x00, 0x00},
+  {0x07, 0x04, 0x55, 0x37, 0xA2, 0x1E, 0x59, 0x57, 0x00, 0x00, 0x00},
+  {0x07, 0x04, 0x24, 0x1B, 0x7C, 0xC2, 0x98, 0x75, 0x00, 0x00, 0x00},
+  {0x07, 0x04, 0x85, 0xAA, 0xB4, 0x85, 0x1A, 0x54, 0x00, 0x00, 0x00},
+  {0x07, 0x04, 0x60, 0x2B, 0xC8, 0xE4, 0x48, 0x52, 0x00, 0x00, 0x00},
+  {0x0A, 0x11, 0xF5, 0x2A, 0x3A, 0x37, 0xE4, 0x63, 0x9A, 0xF1, 0x79},
+  {0x04, 0x16, 0xA1, 0x06, 0xC9, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+  {0x07, 0x04, 0x7E, 0xA3, 0x34, 0x63, 0x1F, 0x4A, 0x00, 0x00, 0x00},
+  {0x07, 0x04, 0x74, 0x76, 0x07, 0x97, 0x4B, 0x48, 0x00, 0x00, 0x00},
+  {0x04, 0xD1, 0xD4, 0x63, 0xE4, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+  {0x0A, 0xC9, 0xD0, 0x64, 0x78, 0x54, 0xEE, 0xAD, 0x8B, 0x27, 0xB8},
+  {0x04, 0xFB, 0x82, 0xF1, 0xEC, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+  {0x04, 0x4B, 0x77, 0xCA, 0xD3, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+  {0x04, 0x07, 0xDE, 0x49, 0xB8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+  {0x04, 0x23, 0x60, 0xDD, 0x5D, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+  {0x07, 0x04, 0x6C, 0x34, 0x7A, 0x6A, 0xF9, 0x27, 0x00, 0x00, 0x00},
+  {0x07, 0x04, 0x54, 0x2D, 0x8D, 0x62, 0x29, 0x43, 0x00, 0x00, 0x00},
+  {0x04, 0x3E, 0xF3, 0x69, 0x9F, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+  {0x07, 0x04, 0x84, 0xFC, 0xF3, 0xA0, 0xB5, 0x7F, 0x00, 0x00, 0x00},
+  {0x07, 0x04, 0x41, 0x28, 0x1E, 0xF0, 0x1A, 0xA6, 0x00, 0x00, 0x00},
+  {0x04, 0x21, 0xCE, 0x4A, 0xF2, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+  {0x07, 0x04, 0x29, 0x37, 0x6F, 0xF0, 0xDB, 0x41, 0x00, 0x00, 0x00},
+  {0x04, 0x57, 0x62, 0x5A, 0x38, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+  {0x04, 0x19, 0xD2, 0x40, 0x2B, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+  {0x04, 0xC3, 0x56, 0x23, 0xCA, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+  {0x04, 0x05, 0x80, 0xF8, 0xC4, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+  {0x0A, 0x67, 0x38, 0x7B, 0xD3, 0xA1, 0x46, 0xEC, 0x1E, 0x33, 0x5F},
+  {0x07, 0x04, 0x3F, 0x7D, 0x51, 0xF6, 0xDA, 0xD0, 0x00, 0x00, 0x00},
+  {0x07, 0x04, 0x01, 0x9B, 0xE6, 0xF9, 0xF9, 0xBF, 0x00, 0x00, 0x00},
+  {0x07, 0x04, 0xA4, 0xC0, 0xC7, 0xA9, 0x3B, 0x45, 0x00, 0x00, 0x00},
+  {0x04, 0x72, 0x2D, 0xBF, 0xAA, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+  {0x04, 0xDC, 0xCD, 0x05, 0xC0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+  {0x07, 0x04, 0x38, 0xE2, 0x18, 0xC6, 0xE1, 0x09, 0x00, 0x00, 0x00},
+  {0x04, 0xFC, 0x21, 0x70, 0x3B, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+  {0x04, 0x4B, 0xC1, 0x57, 0x8E, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+  {0x04, 0x15, 0x58, 0x0F, 0x3A, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+  {0x07, 0x04, 0xE6, 0x4F, 0xF7, 0xA5, 0x0A, 0x7B, 0x00, 0x00, 0x00},
+  {0x07, 0x04, 0xC7, 0x54, 0xA5, 0x19, 0x9C, 0xAD, 0x00, 0x00, 0x00},
+  {0x07, 0x04, 0x32, 0x24, 0x63, 0x5E, 0xA8, 0x83, 0x00, 0x00, 0x00},
+  {0x07, 0x04, 0x11, 0x40, 0x45, 0x47, 0x2C, 0x4B, 0x00, 0x00, 0x00},
+  {0x07, 0x04, 0xA4, 0xE3, 0x2F, 0x75, 0x88, 0xFE, 0x00, 0x00, 0x00},
+  {0x04, 0xFD, 0xB8, 0x19, 0x19, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+  {0x04, 0xD3, 0xFB, 0x81, 0xD9, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+  {0x07, 0x04, 0x98, 0xD9, 0x4A, 0x4E, 0xC0, 0x53, 0x00, 0x00, 0x00},
+  {0x07, 0x04, 0xB7, 0xEA, 0xB6, 0xC8, 0xE0, 0xB3, 0x00, 0x00, 0x00},
+  {0x0A, 0xED, 0x28, 0xE2, 0xFE, 0x32, 0x1C, 0xDD, 0xD3, 0x2F, 0xB9},
+  {0x07, 0x04, 0x29, 0x73, 0x80, 0x21, 0xF9, 0x96, 0x00, 0x00, 0x00},
+  {0x04, 0xF0, 0xDC, 0xE8, 0xA7, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+  {0x07, 0x04, 0x24, 0xBB, 0x6E, 0xDD, 0x90, 0x2D, 0x00, 0x00, 0x00},
+  {0x07, 0x04, 0xA2, 0x2C, 0xFD, 0x35, 0xAA, 0x1D, 0x00, 0x00, 0x00},
+  {0x04, 0xE0, 0xBB, 0x8C, 0x62, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+  {0x07, 0x04, 0x58, 0x1C, 0xA2, 0x44, 0xF3, 0x10, 0x00, 0x00, 0x00},
+  {0x04, 0x5C, 0xBC, 0xD9, 0x59, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+  {0x07, 0x04, 0x8C, 0xDB, 0x2B, 0x50, 0xFD, 0xC7, 0x00, 0x00, 0x00},
+  {0x04, 0x5E, 0xC6, 0xE0, 0xEB, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+  {0x07, 0x04, 0x8D, 0x86, 0xA0, 0xEB, 0x2D, 0x5A, 0x00, 0x00, 0x00},
+  {0x07, 0x04, 0x6F, 0x24, 0x06, 0x2F, 0x61, 0x7E, 0x00, 0x00, 0x00},
+  {0x04, 0xDD, 0x99, 0xAC, 0xD9, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+  {0x04, 0x05, 0x39, 0x3C, 0x77, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+  {0x04, 0xF5, 0x52, 0xD8, 0x69, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+  {0x07, 0x04, 0x49, 0x7E, 0xA3, 0x98, 0xA0, 0x3D, 0x00, 0x00, 0x00},
+  {0x04, 0x31, 0x7C, 0x54, 0x6D, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+  {0x07, 0x04, 0x4A, 0x16, 0x7D, 0xE5, 0x0A, 0xEC, 0x00, 0x00, 0x00},
+  {0x04, 0xDF, 0x7B, 0xAA, 0xD9, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+  {0x07, 0x04, 0xF6, 0xDB, 0x94, 0x24, 0x6F, 0x74, 0x00, 0x00, 0x00},
+  {0x07, 0x04, 0xF0, 0xA7, 0x2E, 0x4D, 0xCA, 0xDD, 0x00, 0x00, 0x00},
+  {0x04, 0x1E, 0xB5, 0x16, 0x25, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+  {0x07, 0x04, 0xCE, 0x85, 0x9B, 0x1E, 0xC6, 0x4B, 0x00, 0x00, 0x00},
+  {0x0A, 0x1C, 0x83, 0x06, 0xF0, 0x72, 0xAF, 0xFB, 0x3D, 0x99, 0x40},
+  {0x04, 0x3D, 0x10, 0x64, 0xAD, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+  {0x07, 0x04, 0x13, 0x33, 0xC9, 0xB0, 0x5B, 0x90, 0x00, 0x00, 0x00},
+  {0x07, 0x04, 0x27, 0x10, 0xDA, 0x79, 0x44, 0xB0, 0x00, 0x00, 0x00},
+  {0x04, 0x4C, 0x16, 0x3C, 0x27, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+  {0x0A, 0x3D, 0x75, 0xE5, 0x35, 0xAC, 0x3E, 0x0C, 0x78, 0x2C, 0x57},
+  {0x04, 0xE2, 0xF6, 0x6B, 0xF9, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+  {0x07, 0x04, 0x22, 0xC1, 0x72, 0x9E, 0x15, 0x9B, 0x00, 0x00, 0x00},
+  {0x07, 0x04, 0xA3, 0x5A, 0x68, 0x51, 0x3D, 0xC9, 0x00, 0x00, 0x00},
+  {0x04, 0x4E, 0x60, 0x4B, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+  {0x0A, 0xC4, 0x44, 0x12, 0x4C, 0xA5, 0x05, 0xE2, 0x64, 0xB9, 0x15},
+  {0x07, 0x04, 0x48, 0x61, 0xBB, 0xC1, 0xC8, 0x72, 0x00, 0x00, 0x00},
+  {0x07, 0x04, 0x37, 0xE4, 0x1E, 0x6D, 0x7B, 0xEA, 0x00, 0x00, 0x00},
+  {0x04, 0x1A, 0x66, 0xA2, 0x0D, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+  {0x04, 0x7E, 0x49, 0xE8, 0xFC, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+  {0x07, 0x04, 0x0C, 0x88, 0x65, 0x07, 0xD0, 0x72, 0x00, 0x00, 0x00},
+  {0x07, 0x04, 0xB5, 0xBD, 0xD0, 0x97, 0x65, 0x11, 0x00, 0x00, 0x00},
+  {0x04, 0x56, 0x8C, 0x96, 0x25, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+  {0x04, 0xF3, 0x08, 0xB3, 0x81, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+  {0x04, 0xD5, 0x9D, 0x87, 0xB0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+  {0x07, 0x04, 0x5F, 0x01, 0x2F, 0xE4, 0xFA, 0xF4, 0x00, 0x00, 0x00},
+  {0x04, 0x52, 0xB6, 0x85, 0x66, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+  {0x07, 0x04, 0xFF, 0x12, 0x46, 0x19, 0x04, 0x7A, 0x00, 0x00, 0x00},
+  {0x07, 0x04, 0xDF, 0xF6, 0x71, 0xFC, 0xE7, 0x6C, 0x00, 0x00, 0x00},
+  {0x04, 0x9E, 0xEB, 0x6F, 0xD8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+  {0x04, 0x4B, 0xBC, 0x6E, 0x75, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+  {0x07, 0x04, 0xCB, 0x66, 0xFD, 0x36, 0x49, 0xA2, 0x00, 0x00, 0x00},
+  {0x07, 0x04, 0x46, 0x25, 0xB8, 0x7C, 0xEC, 0xCD, 0x00, 0x00, 0x00},
+  {0x07, 0x04, 0x02, 0xDC, 0xBE, 0x32, 0xC6, 0xBD, 0x00, 0x00, 0x00},
+  {0x07, 0x04, 0x45, 0x26, 0x85, 0x20, 0xEB, 0xB2, 0x00, 0x00, 0x00},
+  {0x07, 0x04, 0xC4, 0x9D, 0x0F, 0xFC, 0x31, 0x02, 0x00, 0x00, 0x00},
+  {0x07, 0x04, 0x8E, 0x1B, 0xCC, 0x06, 0xFF, 0x57, 0x00, 0x00, 0x00},
+  {0x07, 0x04, 0x4C, 0x53, 0xCD, 0x50, 0x15, 0x18, 0x00, 0x00, 0x00},
+  {0x07, 0x04, 0xB0, 0x20, 0x05, 0x3C, 0xE7, 0x13, 0x00, 0x00, 0x00},
+  {0x07, 0x04, 0x6A, 0x72, 0x86, 0x78, 0xFC, 0xC8, 0x00, 0x00, 0x00},
+  {0x07, 0x04, 0x2C, 0x41, 0x77, 0x04, 0xE7, 0xEB, 0x00, 0x00, 0x00},
+  {0x04, 0x5E, 0x7D, 0x58, 0x1C, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+  {0x04, 0x51, 0x90, 0x29, 0x3A, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+  {0x04, 0xD6, 0xBD, 0x3A, 0xDB, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+  {0x04, 0xA8, 0x58, 0x74, 0xCE, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+  {0x07, 0x04, 0x8D, 0xD0, 0xA2, 0x1D, 0x65, 0x02, 0x00, 0x00, 0x00},
+  {0x07, 0x04, 0xBF, 0x30, 0x6F, 0x2B, 0x54, 0xB9, 0x00, 0x00, 0x00},
+  {0x0A, 0x1D, 0x48, 0xB9, 0xDD, 0xAD, 0xD2, 0x6D, 0xDB, 0x94, 0xE9},
+  {0x07, 0x04, 0x3C, 0xF3, 0xDB, 0x1F, 0xFF, 0x90, 0x00, 0x00, 0x00},
+  {0x07, 0x04, 0x04, 0x2D, 0xB9, 0xB8, 0x3E, 0x14, 0x00, 0x00, 0x00},
+  {0x04, 0xB2, 0x67, 0xF7, 0x34, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+  {0x07, 0x04, 0x82, 0xAA, 0x50, 0x39, 0x3A, 0x9B, 0x00, 0x00, 0x00},
+  {0x07, 0x04, 0x64, 0x0B, 0x75, 0x37, 0xCE, 0x58, 0x00, 0x00, 0x00},
+  {0x04, 0x6A, 0x41, 0xD8, 0x0D, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+  {0x07, 0x04, 0xE4, 0x57, 0x90, 0x42, 0x86, 0x83, 0x00, 0x00, 0x00},
+  {0x04, 0xFB, 0x44, 0x55, 0x9B, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+  {0x04, 0x58, 0x9F, 0x2A, 0xB9, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+  {0x04, 0x8F, 0x38, 0xF5, 0xCD, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+  {0x07, 0x04, 0xD6, 0x19, 0xAF, 0x33, 0x2E, 0x4D, 0x00, 0x00, 0x00},
+  {0x07, 0x04, 0xBB, 0x68, 0x36, 0xB7, 0x66, 0xB3, 0x00, 0x00, 0x00},
+  {0x07, 0x04, 0x3A, 0x3C, 0xDD, 0xB2, 0x6C, 0xD1, 0x00, 0x00, 0x00},
+  {0x07, 0x04, 0xD5, 0x3D, 0x74, 0x11, 0x8C, 0xEC, 0x00, 0x00, 0x00},
+  {0x04, 0x38, 0x48, 0x4B, 0x6C, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+  {0x04, 0x3B, 0x45, 0x8A, 0x41, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+  {0x04, 0xF6, 0xE7, 0x46, 0x20, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+  {0x07, 0x04, 0xA2, 0xD5, 0x2D, 0xDD, 0xD3, 0xD0, 0x00, 0x00, 0x00},
+  {0x04, 0xA7, 0xA1, 0xD0, 0x0C, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+  {0x04, 0xC0, 0xB9, 0x18, 0xFC, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+  {0x04, 0x61, 0x0A, 0x7C, 0xBB, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+  {0x04, 0xEE, 0x55, 0xAC, 0x30, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+  {0x07, 0x04, 0xAC, 0x7C, 0x12, 0x6F, 0x38, 0xB4, 0x00, 0x00, 0x00},
+  {0x04, 0xE1, 0xDC, 0x4D, 0xAE, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+  {0x04, 0x61, 0xFF, 0xE1, 0x1A, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+  {0x07, 0x04, 0x79, 0x39, 0xC4, 0x5C, 0x9D, 0x60, 0x00, 0x00, 0x00},
+  {0x04, 0x7C, 0xEE, 0xD9, 0xAC, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+  {0x04, 0x9A, 0x97, 0xEA, 0x22, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+  {0x07, 0x04, 0x79, 0x7D, 0x18, 0xFB, 0xBF, 0x2F, 0x00, 0x00, 0x00},
+  {0x07, 0x04, 0x5B, 0x75, 0x62, 0x34, 0xBD, 0xA3, 0x00, 0x00, 0x00},
+  {0x07, 0x04, 0xF0, 0x0F, 0xC6, 0xC6, 0xD8, 0x72, 0x00, 0x00, 0x00},
+  {0x04, 0xD5, 0x7D, 0x56, 0xB4, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+  {0x04, 0x7F, 0x7C, 0x7F, 0xF2, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+  {0x07, 0x04, 0xC8, 0x01, 0x0B, 0x13, 0xE9, 0x8E, 0x00, 0x00, 0x00},
+  {0x07, 0x04, 0xF5, 0x33, 0xF7, 0x1D, 0x2F, 0x7C, 0x00, 0x00, 0x00},
+  {0x04, 0x18, 0x7E, 0x63, 0x4F, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+};
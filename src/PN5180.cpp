@@ -34,14 +34,18 @@
 #define PN5180_SEND_DATA                (0x09)
 #define PN5180_READ_DATA                (0x0A)
 #define PN5180_SWITCH_MODE              (0x0B)
+#define PN5180_MIFARE_AUTHENTICATE      (0x0C)
 #define PN5180_LOAD_RF_CONFIG           (0x11)
+#define PN5180_UPDATE_RF_CONFIG         (0x12)
 #define PN5180_RF_ON                    (0x16)
 #define PN5180_RF_OFF                   (0x17)
 
-#define DEBUG
-
-uint8_t PN5180::readBuffer[508];
+PN5180_THREAD_LOCAL uint8_t PN5180::readBuffer[PN5180_READ_BUFFER_SIZE];
 uint8_t productVersion[2];
+uint16_t PN5180::nssGuardUs = PN5180_NSS_GUARD_US;
+PN5180RFConfigHook PN5180::rfConfigHook = 0;
+void *PN5180::rfConfigContext = 0;
+Print *pn5180Log = &Serial;
 
 PN5180::PN5180(uint8_t SSpin, uint8_t BUSYpin, uint8_t RSTpin) {
   PN5180_NSS = SSpin;
@@ -56,6 +60,14 @@ PN5180::PN5180(uint8_t SSpin, uint8_t BUSYpin, uint8_t RSTpin) {
    */
   // Настройки для PN5180: 7Мбит/с, старший бит первым, SPI_MODE0 (CPOL=0, CPHA=0)
   PN5180_SPI_SETTINGS = SPISettings(1000000, MSBFIRST, SPI_MODE0);
+
+  rfTxConfig = 0xFF;
+  rfRxConfig = 0xFF;
+  rxTimeoutRemaining = 0;
+  rxTimeoutMs = 0;
+  rxStart = 0;
+  memset(versions, 0, sizeof(versions));
+  rfOn = false;
 }
 
 void PN5180::begin() {
@@ -183,14 +195,14 @@ bool PN5180::readRegister(uint8_t reg, uint32_t *value) {
   uint8_t cmd[2] = { PN5180_READ_REGISTER, reg };
 
   SPI.beginTransaction(PN5180_SPI_SETTINGS);
-  transceiveCommand(cmd, 2, (uint8_t*)value, 4);
+  bool ok = transceiveCommand(cmd, 2, (uint8_t*)value, 4);
   SPI.endTransaction();
 
   PN5180DEBUG(F("Register value=0x"));
   PN5180DEBUG(formatHex(*value));
   PN5180DEBUG("\n");
 
-  return true;
+  return ok;
 }
 
 /*
@@ -202,9 +214,9 @@ bool PN5180::writeEEprom(uint8_t addr, uint8_t *buffer, uint8_t len) {
   cmd[1] = addr;
   for (int i = 0; i < len; i++) cmd[2 + i] = buffer[i];
   SPI.beginTransaction(PN5180_SPI_SETTINGS);
-  transceiveCommand(cmd, len + 2);
+  bool ok = transceiveCommand(cmd, len + 2);
   SPI.endTransaction();
-  return true;
+  return ok;
 }
 
 /*
@@ -231,7 +243,7 @@ bool PN5180::readEEprom(uint8_t addr, uint8_t *buffer, int len) {
   uint8_t cmd[3] = { PN5180_READ_EEPROM, addr, static_cast<uint8_t>(len) };
 
   SPI.beginTransaction(PN5180_SPI_SETTINGS);
-  transceiveCommand(cmd, 3, buffer, len);
+  bool ok = transceiveCommand(cmd, 3, buffer, len);
   SPI.endTransaction();
 
 #ifdef DEBUG
@@ -243,7 +255,7 @@ bool PN5180::readEEprom(uint8_t addr, uint8_t *buffer, int len) {
   PN5180DEBUG("\n");
 #endif
 
-  return true;
+  return ok;
 }
 
 
@@ -322,8 +334,10 @@ bool PN5180::sendData(uint8_t *data, int len, uint8_t validBits) {
  * будут недействительными. Если это условие не выполнено, возникает исключение.
  */
 uint8_t * PN5180::readData(int len) {
-  if (len > 508) {
-    Serial.println(F("*** FATAL: Reading more than 508 bytes is not supported!"));
+  if (len > PN5180_READ_BUFFER_SIZE) {
+    PN5180LOG.print(F("*** FATAL: Reading more than "));
+    PN5180LOG.print(PN5180_READ_BUFFER_SIZE);
+    PN5180LOG.println(F(" bytes is not supported!"));
     return 0L;
   }
 
@@ -350,9 +364,6 @@ uint8_t * PN5180::readData(int len) {
 }
 
 bool PN5180::readData(uint8_t len, uint8_t *buffer) {
-  if (len > 508) {
-    return false;
-  }
   uint8_t cmd[2] = { PN5180_READ_DATA, 0x00 };
   SPI.beginTransaction(PN5180_SPI_SETTINGS);
   bool success = transceiveCommand(cmd, 2, buffer, len);
@@ -380,6 +391,46 @@ bool PN5180::switchToLPCD(uint16_t wakeupCounterInMs) {
   return success;
 }
 
+/*
+ * MIFARE_AUTHENTICATE - 0x0C
+ * Эта команда выполняет аутентификацию MIFARE Classic (Crypto1) для указанного блока.
+ * Ключ (6 байт), тип ключа (0x60 — Key A, 0x61 — Key B), адрес блока и 4 байта UID
+ * передаются в одном SPI-фрейме. После успешной аутентификации PN5180 сам устанавливает
+ * бит MFC_CRYPTO_ON в SYSTEM_CONFIG, и весь последующий обмен с картой шифруется прозрачно
+ * для хоста, пока этот бит не будет сброшен (см. activateTypeA).
+ * Ответ — 1 байт статуса:
+ *   0x00 — аутентификация успешна
+ *   0x01 — аутентификация не удалась (неверный ключ)
+ *   0x02 — таймаут, карта не ответила
+ * Для 7-байтовых UID передаются последние 4 байта UID.
+ */
+uint8_t PN5180::mifareAuthenticate(uint8_t blockno, uint8_t keyType, const uint8_t *key, const uint8_t *uid) {
+  if (keyType != MIFARE_KEY_A && keyType != MIFARE_KEY_B) {
+    PN5180DEBUG(F("ERROR: invalid Mifare key type!\n"));
+    return MIFARE_AUTH_ERROR;
+  }
+
+  uint8_t cmd[13];
+  cmd[0] = PN5180_MIFARE_AUTHENTICATE;
+  memcpy(&cmd[1], key, 6);
+  cmd[7] = keyType;
+  cmd[8] = blockno;
+  memcpy(&cmd[9], uid, 4);
+
+  uint8_t status = MIFARE_AUTH_ERROR;
+  SPI.beginTransaction(PN5180_SPI_SETTINGS);
+  bool success = transceiveCommand(cmd, sizeof(cmd), &status, 1);
+  SPI.endTransaction();
+
+  if (!success) return MIFARE_AUTH_ERROR;
+
+  PN5180DEBUG(F("Mifare authenticate status=0x"));
+  PN5180DEBUG(formatHex(status));
+  PN5180DEBUG("\n");
+
+  return status;
+}
+
 /*
  * LOAD_RF_CONFIG - 0x11
  * Параметр 'Transmitter Configuration' должен быть в диапазоне от 0x0 до 0x1C включительно. Если
@@ -406,10 +457,77 @@ bool PN5180::loadRFConfig(uint8_t txConf, uint8_t rxConf) {
   uint8_t cmd[3] = { PN5180_LOAD_RF_CONFIG, txConf, rxConf };
 
   SPI.beginTransaction(PN5180_SPI_SETTINGS);
-  transceiveCommand(cmd, 3);
+  bool success = transceiveCommand(cmd, 3);
   SPI.endTransaction();
 
-  return true;
+  rfTxConfig = success ? txConf : 0xFF;
+  rfRxConfig = success ? rxConf : 0xFF;
+  if (success && rfConfigHook) {
+    rfConfigHook(*this, rfConfigContext);
+  }
+  return success;
+}
+
+/*
+ * UPDATE_RF_CONFIG - 0x12
+ * Изменяет значение регистра в таблице RF-конфигурации в EEPROM: новое значение
+ * применяется каждым следующим LOAD_RF_CONFIG с этим номером конфигурации.
+ * Регистр должен уже входить в таблицу, иначе PN5180 выставляет GENERAL_ERROR.
+ * Формат записи: номер конфигурации, адрес регистра, значение (4 байта, LE).
+ */
+bool PN5180::updateRFConfig(uint8_t conf, uint8_t reg, uint32_t value) {
+  PN5180DEBUG(F("Update RF-Config: conf="));
+  PN5180DEBUG(formatHex(conf));
+  PN5180DEBUG(F(", reg="));
+  PN5180DEBUG(formatHex(reg));
+  PN5180DEBUG(F(", value="));
+  PN5180DEBUG(formatHex(value));
+  PN5180DEBUG("\n");
+
+  uint8_t cmd[7] = { PN5180_UPDATE_RF_CONFIG, conf, reg,
+                     (uint8_t)(value & 0xFF), (uint8_t)((value >> 8) & 0xFF),
+                     (uint8_t)((value >> 16) & 0xFF), (uint8_t)((value >> 24) & 0xFF) };
+
+  SPI.beginTransaction(PN5180_SPI_SETTINGS);
+  bool success = transceiveCommand(cmd, 7);
+  SPI.endTransaction();
+
+  if (conf == rfTxConfig || conf == rfRxConfig) {
+    invalidateRFConfig(); // загруженные регистры ещё старые
+  }
+  return success;
+}
+
+/*
+ * Загружает RF-конфигурацию, только если она отличается от последней загруженной.
+ * Нужна там, где протокол переключается часто (опрос нескольких технологий):
+ * LOAD_RF_CONFIG переписывает десятки регистров и занимает заметное время.
+ * Регистры, изменённые после загрузки (CRC, Crypto1), при этом не восстанавливаются.
+ */
+bool PN5180::switchRFConfig(uint8_t txConf, uint8_t rxConf) {
+  if (txConf == rfTxConfig && rxConf == rfRxConfig) {
+    return true;
+  }
+  return loadRFConfig(txConf, rxConf);
+}
+
+/*
+ * Забыть последнюю загруженную конфигурацию: следующий switchRFConfig() загрузит её заново.
+ * Нужно, когда тот же PN5180 перенастраивал другой объект (другой протокол на тех же пинах).
+ */
+void PN5180::invalidateRFConfig() {
+  rfTxConfig = 0xFF;
+  rfRxConfig = 0xFF;
+}
+
+/*
+ * Обработчик после каждой загрузки RF-конфигурации любым объектом PN5180: регистры,
+ * изменённые поверх конфигурации (ступень драйвера TX), нужно записать заново.
+ * Обработчик не должен сам загружать конфигурацию.
+ */
+void PN5180::setRFConfigHook(PN5180RFConfigHook hook, void *context) {
+  rfConfigHook = hook;
+  rfConfigContext = context;
 }
 
 /*
@@ -423,11 +541,20 @@ bool PN5180::setRF_on() {
   uint8_t cmd[2] = { PN5180_RF_ON, 0x00 };
 
   SPI.beginTransaction(PN5180_SPI_SETTINGS);
-  transceiveCommand(cmd, 2);
+  bool ok = transceiveCommand(cmd, 2);
   SPI.endTransaction();
-
-  while (0 == (TX_RFON_IRQ_STAT & getIRQStatus())); // ждать, пока RF-поле не будет установлено
+  if (!ok) return false;
+
+  // ждать, пока RF-поле не будет установлено; без поля (внешнее поле, ошибка питания) — не вечно
+  unsigned long started = millis();
+  while (0 == (TX_RFON_IRQ_STAT & getIRQStatus())) {
+    if (millis() - started > PN5180_RF_SWITCH_TIMEOUT_MS) {
+      PN5180DEBUG(F("ERROR: RF ON timeout\n"));
+      return false;
+    }
+  }
   clearIRQStatus(TX_RFON_IRQ_STAT);
+  rfOn = true;
   return true;
 }
 
@@ -442,14 +569,35 @@ bool PN5180::setRF_off() {
   uint8_t cmd[2] { PN5180_RF_OFF, 0x00 };
 
   SPI.beginTransaction(PN5180_SPI_SETTINGS);
-  transceiveCommand(cmd, 2);
+  bool ok = transceiveCommand(cmd, 2);
   SPI.endTransaction();
-
-  while (0 == (TX_RFOFF_IRQ_STAT & getIRQStatus())); // ждать, пока RF-поле не выключится
+  if (!ok) return false;
+
+  rfOn = false;
+  // ждать, пока RF-поле не выключится; поле, уже выключенное PN5180 (TEMPSENS_ERROR), IRQ не даёт
+  unsigned long started = millis();
+  while (0 == (TX_RFOFF_IRQ_STAT & getIRQStatus())) {
+    if (millis() - started > PN5180_RF_SWITCH_TIMEOUT_MS) {
+      PN5180DEBUG(F("ERROR: RF OFF timeout\n"));
+      return false;
+    }
+  }
   clearIRQStatus(TX_RFOFF_IRQ_STAT);
   return true;
 }
 
+bool PN5180::isRFOn() const {
+  return rfOn;
+}
+
+/*
+ * Поле выключил сам PN5180 (датчик температуры): RF_OFF послать можно, но
+ * TX_RFOFF_IRQ не придёт, и setRF_off() прождал бы PN5180_RF_SWITCH_TIMEOUT_MS.
+ */
+void PN5180::markRFOff() {
+  rfOn = false;
+}
+
 //---------------------------------------------------------------------------------------------
 
 /*
@@ -504,7 +652,7 @@ bool PN5180::transceiveCommand(uint8_t *sendBuffer, size_t sendBufferLen, uint8_
     if (millis() - startedWaiting > commandTimeout) return false;
   }; // ждать, пока busy не станет low
   // 1.
-  digitalWrite(PN5180_NSS, LOW); delay(2);
+  digitalWrite(PN5180_NSS, LOW); delayMicroseconds(nssGuardUs);
   // 2.
   for (uint8_t i=0; i<sendBufferLen; i++) {
     SPI.transfer(sendBuffer[i]);
@@ -515,7 +663,7 @@ bool PN5180::transceiveCommand(uint8_t *sendBuffer, size_t sendBufferLen, uint8_
     if (millis() - startedWaiting > commandTimeout) return false;
   }; // ждать, пока busy не станет high
   // 4.
-  digitalWrite(PN5180_NSS, HIGH); delay(1);
+  digitalWrite(PN5180_NSS, HIGH); delayMicroseconds(nssGuardUs / 2);
   // 5.
   startedWaiting = millis();
   while (LOW != digitalRead(PN5180_BUSY)) {
@@ -528,7 +676,7 @@ bool PN5180::transceiveCommand(uint8_t *sendBuffer, size_t sendBufferLen, uint8_
   PN5180DEBUG(F("Receiving SPI frame...\n"));
 
   // 1.
-  digitalWrite(PN5180_NSS, LOW); delay(2);
+  digitalWrite(PN5180_NSS, LOW); delayMicroseconds(nssGuardUs);
   // 2.
   for (uint8_t i=0; i<recvBufferLen; i++) {
     recvBuffer[i] = SPI.transfer(0xff);
@@ -539,7 +687,7 @@ bool PN5180::transceiveCommand(uint8_t *sendBuffer, size_t sendBufferLen, uint8_
     if (millis() - startedWaiting > commandTimeout) return false;
   }; // ждать, пока busy не станет high
   // 4.
-  digitalWrite(PN5180_NSS, HIGH); delay(1);
+  digitalWrite(PN5180_NSS, HIGH); delayMicroseconds(nssGuardUs / 2);
   // 5.
   startedWaiting = millis();
   while (LOW != digitalRead(PN5180_BUSY)) {
@@ -560,16 +708,39 @@ bool PN5180::transceiveCommand(uint8_t *sendBuffer, size_t sendBufferLen, uint8_
 
 
 
-void PN5180::reset() {
-  // Serial.println(F("Reset PN5180..."));
+uint8_t PN5180::reset() {
+  // PN5180LOG.println(F("Reset PN5180..."));
   digitalWrite(PN5180_RST, LOW);  // требуется не менее 10 мкс
-  delay(20);
-  digitalWrite(PN5180_RST, HIGH); // требуется 2 мс для запуска
-  delay(4);
-
-  while (0 == (IDLE_IRQ_STAT & getIRQStatus())); // ждать запуска системы
+  delayMicroseconds(PN5180_RESET_PULSE_US);
+  digitalWrite(PN5180_RST, HIGH); // запуск около 2,5 мс
+
+  // Ждём IDLE_IRQ не дольше PN5180_BOOT_TIMEOUT_MS; пока BUSY высокий, микросхема загружается.
+  // Каждая команда ограничена тем же сроком, а не commandTimeout
+  uint8_t result = PN5180_START_BUSY_STUCK;
+  uint8_t savedTimeout = commandTimeout;
+  commandTimeout = PN5180_BOOT_TIMEOUT_MS;
+  unsigned long started = millis();
+  do {
+    if (LOW == digitalRead(PN5180_BUSY)) {
+      result = PN5180_START_NO_IDLE;
+      uint32_t irqStatus;
+      // 0xFFFFFFFF — MISO без ведомого, а не состояние PN5180
+      if (readRegister(IRQ_STATUS, &irqStatus) && irqStatus != 0xFFFFFFFFUL && (irqStatus & IDLE_IRQ_STAT)) {
+        result = PN5180_START_OK;
+        break;
+      }
+    }
+  } while (millis() - started <= PN5180_BOOT_TIMEOUT_MS);
+  commandTimeout = savedTimeout;
+
+  if (result == PN5180_START_OK) {
+    clearIRQStatus(0xffffffff); // очистить все флаги
+  }
 
-  clearIRQStatus(0xffffffff); // очистить все флаги
+  // после сброса RF-конфигурация неизвестна, поле выключено
+  invalidateRFConfig();
+  rfOn = false;
+  return result;
 }
 
 /**
@@ -639,50 +810,50 @@ PN5180TransceiveStat PN5180::getTransceiveState() {
 // Функция для отображения состояния IRQ в человекочитаемом виде
 void PN5180::showIRQStatus(uint32_t irqStatus)
 {
-  Serial.print(F("IRQ-Status 0x"));
-  Serial.print(irqStatus, HEX);
-  Serial.print(": [ ");
+  PN5180LOG.print(F("IRQ-Status 0x"));
+  PN5180LOG.print(irqStatus, HEX);
+  PN5180LOG.print(": [ ");
   if (irqStatus & (1UL << 0))
-    Serial.print(F("RQ ")); // RQ - Request - запрос на выполнение команды
+    PN5180LOG.print(F("RQ ")); // RQ - Request - запрос на выполнение команды
   if (irqStatus & (1UL << 1))
-    Serial.print(F("TX ")); // TX - передача данных
+    PN5180LOG.print(F("TX ")); // TX - передача данных
   if (irqStatus & (1UL << 2))
-    Serial.print(F("IDLE ")); // Ожидание (Idle) - режим ожидания, когда нет активных команд
+    PN5180LOG.print(F("IDLE ")); // Ожидание (Idle) - режим ожидания, когда нет активных команд
   if (irqStatus & (1UL << 3)) 
-    Serial.print(F("MODE_DETECTED ")); // MODE_DETECTED - обнаружение режима работы (например, режим чтения карты)
+    PN5180LOG.print(F("MODE_DETECTED ")); // MODE_DETECTED - обнаружение режима работы (например, режим чтения карты)
   if (irqStatus & (1UL << 4)) 
-    Serial.print(F("CARD_ACTIVATED ")); // CARD_ACTIVATED - карта активирована
+    PN5180LOG.print(F("CARD_ACTIVATED ")); // CARD_ACTIVATED - карта активирована
   if (irqStatus & (1UL << 5))
-    Serial.print(F("STATE_CHANGE ")); // STATE_CHANGE - изменение состояния
+    PN5180LOG.print(F("STATE_CHANGE ")); // STATE_CHANGE - изменение состояния
   if (irqStatus & (1UL << 6))
-    Serial.print(F("RFOFF_DET ")); // RFOFF_DET - обнаружение выключения радиочастотного поля
+    PN5180LOG.print(F("RFOFF_DET ")); // RFOFF_DET - обнаружение выключения радиочастотного поля
   if (irqStatus & (1UL << 7))
-    Serial.print(F("RFON_DET ")); // RFON_DET - обнаружение включения радиочастотного поля
+    PN5180LOG.print(F("RFON_DET ")); // RFON_DET - обнаружение включения радиочастотного поля
   if (irqStatus & (1UL << 8))
-    Serial.print(F("TX_RFOFF ")); // TX_RFOFF - радиочастотное поле выключено
+    PN5180LOG.print(F("TX_RFOFF ")); // TX_RFOFF - радиочастотное поле выключено
   if (irqStatus & (1UL << 9))
-    Serial.print(F("TX_RFON ")); // TX_RFON - радиочастотное поле включено
+    PN5180LOG.print(F("TX_RFON ")); // TX_RFON - радиочастотное поле включено
   if (irqStatus & (1UL << 10))
-    Serial.print(F("RF_ACTIVE_ERROR ")); // RF Active Error - ошибка активного режима радиочастотной цепи
+    PN5180LOG.print(F("RF_ACTIVE_ERROR ")); // RF Active Error - ошибка активного режима радиочастотной цепи
   if (irqStatus & (1UL << 11))
-    Serial.print(F("TIMER0 ")); 
+    PN5180LOG.print(F("TIMER0 ")); 
   if (irqStatus & (1UL << 12))
-    Serial.print(F("TIMER1 ")); 
+    PN5180LOG.print(F("TIMER1 ")); 
   if (irqStatus & (1UL << 13))
-    Serial.print(F("TIMER2 ")); 
+    PN5180LOG.print(F("TIMER2 ")); 
   if (irqStatus & (1UL << 14)) 
-    Serial.print(F("RX_SOF_DET ")); // RX_SOF_DET Start of Frame Detection - обнаружение начала кадра 
+    PN5180LOG.print(F("RX_SOF_DET ")); // RX_SOF_DET Start of Frame Detection - обнаружение начала кадра 
   if (irqStatus & (1UL << 15))
-    Serial.print(F("RX_SC_DET ")); // RX Short Circuit Detection - обнаружение короткого замыкания в цепи приёмника
+    PN5180LOG.print(F("RX_SC_DET ")); // RX Short Circuit Detection - обнаружение короткого замыкания в цепи приёмника
   if (irqStatus & (1UL << 16))
-    Serial.print(F("TEMPSENS_ERROR ")); // Temperature Sensor Error - ошибка датчика температуры
+    PN5180LOG.print(F("TEMPSENS_ERROR ")); // Temperature Sensor Error - ошибка датчика температуры
   if (irqStatus & (1UL << 17))
-    Serial.print(F("GENERAL_ERROR ")); 
+    PN5180LOG.print(F("GENERAL_ERROR ")); 
   if (irqStatus & (1UL << 18)) 
-    Serial.print(F("HV_ERROR ")); // High Voltage Error - ошибка высокого напряжения в цепи питания PN5180
+    PN5180LOG.print(F("HV_ERROR ")); // High Voltage Error - ошибка высокого напряжения в цепи питания PN5180
   if (irqStatus & (1UL << 19))
-    Serial.print(F("LPCD ")); // Low Power Card Detection - обнаружение карты в режиме низкого энергопотребления
-  Serial.println("]");
+    PN5180LOG.print(F("LPCD ")); // Low Power Card Detection - обнаружение карты в режиме низкого энергопотребления
+  PN5180LOG.println("]");
 }
 
 uint8_t PN5180::readRFResponse(uint8_t* buffer, uint8_t maxLen) {
@@ -702,53 +873,164 @@ uint8_t PN5180::readRFResponse(uint8_t* buffer, uint8_t maxLen) {
 }
 
 
-// Function to start the PN5180 
-bool PN5180::PN5180_Start()
-{
-  // digitalWrite(PIN_TRIGGER, LOW); // Выключаем питание PN5180
-  Serial.println(F("================================================"));
-  Serial.println(F("Uploaded: " __DATE__ " " __TIME__));
-  Serial.println(F("PN5180 ISO14443 Sketch for Mifare Ultralight EV1 and APDU"));
+/*
+ * Программирует TIMER1 на carrierCycles периодов несущей (fc = 13,56 МГц).
+ * Выбирается наименьший делитель, при котором значение помещается в 20-битный TIMER1_RELOAD.
+ * То, что не помещается даже при максимальном делителе, остаётся в rxTimeoutRemaining и
+ * отсчитывается повторным запуском таймера в waitForRx().
+ */
+bool PN5180::armTimer1(uint32_t carrierCycles, uint32_t startMode) {
+  uint8_t prescale = 0;
+  while (prescale < TIMER_PRESCALE_MAX && ((carrierCycles + (1UL << prescale) - 1) >> prescale) > TIMER_RELOAD_MAX) {
+    prescale++;
+  }
+  uint32_t reload = (carrierCycles + (1UL << prescale) - 1) >> prescale;
+  if (reload > TIMER_RELOAD_MAX) {
+    reload = TIMER_RELOAD_MAX;
+  }
+  if (reload == 0) {
+    reload = 1;
+  }
+  rxTimeoutRemaining = carrierCycles - ((reload << prescale) < carrierCycles ? (reload << prescale) : carrierCycles);
 
-  Serial.println(F("------------------------------------------------"));
+  uint32_t config = TIMER_CONFIG_ENABLE | ((uint32_t)prescale << TIMER_CONFIG_PRESCALE_SHIFT) | startMode | TIMER_CONFIG_STOP_ON_RX_STARTED;
+  return writeRegister(TIMER1_RELOAD, reload) && writeRegister(TIMER1_CONFIG, config);
+}
+
+/*
+ * Задаёт время ожидания ответа карты (например, FWT ISO14443-4) в периодах несущей.
+ * Вызывается перед sendData(): TIMER1 запускается аппаратно по окончании передачи
+ * и останавливается, когда карта начинает ответ, поэтому таймаут точный
+ * и не зависит от задержек SPI.
+ */
+bool PN5180::startRxTimeout(uint32_t carrierCycles) {
+  // Программный предел на случай сбоя таймера: время ожидания + 100 мс на приём кадра
+  rxTimeoutMs = carrierCycles / 13560UL + 100;
+  rxStart = millis();
+  clearIRQStatus(RX_IRQ_STAT | TIMER1_IRQ_STAT);
+  return armTimer1(carrierCycles, TIMER_CONFIG_START_ON_TX_ENDED);
+}
+
+/*
+ * Однократная проверка приёма после sendData() по флагам IRQ_STATUS, без ожидания:
+ * RX_IRQ — кадр принят, TIMER1_IRQ — истекло время, заданное startRxTimeout().
+ * Позволяет обслуживать другие задачи (другие PN5180 на той же шине),
+ * пока карта готовит ответ.
+ *
+ * возвращаемое значение:
+ * -	> 0 — количество принятых байт
+ * -	0 — таймаут, карта не ответила
+ * -	-1 — ошибка приёма (CRC/чётность, протокол)
+ * -	PN5180_RX_COLLISION — коллизия битов: ответили несколько карт (для ATQA это норма)
+ * -	PN5180_RX_PENDING — ответ ещё не получен, вызвать снова
+ */
+int16_t PN5180::pollRx() {
+  int16_t result = PN5180_RX_PENDING;
+  uint32_t irqStatus = getIRQStatus();
+  if (irqStatus & RX_IRQ_STAT) {
+    uint32_t rxStatus;
+    readRegister(RX_STATUS, &rxStatus);
+    if (rxStatus & RX_COLLISION_DETECTED) {
+      result = PN5180_RX_COLLISION;
+    }
+    else if (rxStatus & (RX_DATA_INTEGRITY_ERROR | RX_PROTOCOL_ERROR)) {
+      PN5180DEBUG(F("RX error, RX_STATUS=0x"));
+      PN5180DEBUG(formatHex(rxStatus));
+      PN5180DEBUG("\n");
+      result = -1;
+    }
+    else {
+      result = (int16_t)(rxStatus & RX_BYTES_RECEIVED_MASK);
+    }
+  }
+  else if (irqStatus & TIMER1_IRQ_STAT) {
+    if (rxTimeoutRemaining == 0) {
+      result = 0;
+    }
+    else {
+      // Время ожидания длиннее одного периода TIMER1 — запускаем его снова
+      clearIRQStatus(TIMER1_IRQ_STAT);
+      armTimer1(rxTimeoutRemaining, TIMER_CONFIG_START_NOW);
+    }
+  }
+  if (result == PN5180_RX_PENDING && millis() - rxStart > rxTimeoutMs) {
+    PN5180DEBUG(F("RX timeout without TIMER1 IRQ\n"));
+    result = 0;
+  }
+
+  if (result != PN5180_RX_PENDING) {
+    // Отключаем TIMER1, иначе он снова запустится по окончании следующей передачи
+    writeRegisterWithAndMask(TIMER1_CONFIG, (uint32_t)~TIMER_CONFIG_ENABLE);
+    clearIRQStatus(TIMER1_IRQ_STAT);
+  }
+  return result;
+}
+
+/*
+ * Ожидает окончания приёма после sendData(), см. pollRx().
+ * Между опросами IRQ_STATUS — пауза PN5180_RX_POLL_US, чтобы не занимать шину SPI
+ * непрерывно; момент окончания ожидания всё равно задаёт TIMER1.
+ *
+ * возвращаемое значение: > 0 — количество принятых байт, 0 — таймаут,
+ * -1 — ошибка приёма, PN5180_RX_COLLISION — коллизия битов
+ */
+int16_t PN5180::waitForRx() {
+  int16_t result;
+  while ((result = pollRx()) == PN5180_RX_PENDING)
+    delayMicroseconds(PN5180_RX_POLL_US);
+  return result;
+}
+
+/*
+ * Быстрый запуск: минимальный импульс сброса, ожидание загрузки со сроком
+ * и все версии (PRODUCT, FIRMWARE, EEPROM — 0x10..0x15) одним чтением EEPROM.
+ * Без вывода; причина отказа — код PN5180_START_*.
+ */
+uint8_t PN5180::fastStart()
+{
   begin();
-  Serial.println(F("PN5180 Hard-Reset..."));
-  reset();
-  Serial.println(F("------------------------------------------------"));
-  Serial.println(F("Reading PN5180 version..."));
-  readEEprom(PRODUCT_VERSION, productVersion, sizeof(productVersion));
-  Serial.print(F("PN5180 version="));
-  Serial.print(productVersion[1]);
-  Serial.print(".");
-  Serial.println(productVersion[0]);
-
-  if (productVersion[1] != 4)
-  { // if product version is not 4, the initialization failed
-
-    return false; // return error
-  }
-
-  Serial.println(F("------------------------------------------------"));
-  Serial.println(F("Reading firmware PN5180 version..."));
-  uint8_t firmwareVersion[2];
-  readEEprom(FIRMWARE_VERSION, firmwareVersion, sizeof(firmwareVersion));
-  Serial.print(F("Firmware PN5180 version="));
-  Serial.print(firmwareVersion[1]);
-  Serial.print(".");
-  Serial.println(firmwareVersion[0]);
-
-  Serial.println(F("------------------------------------------------"));
-  Serial.println(F("Reading EEPROM PN5180 version..."));
-  uint8_t eepromVersion[2];
-  readEEprom(EEPROM_VERSION, eepromVersion, sizeof(eepromVersion));
-  Serial.print(F("EEPROM PN5180 version="));
-  Serial.print(eepromVersion[1]);
-  Serial.print(".");
-  Serial.println(eepromVersion[0]);
-
-  Serial.println(F("------------------------------------------------"));
-  Serial.println(F("Enable RF field..."));
-  // nfc.setupRF();
+  uint8_t result = reset();
+  if (result != PN5180_START_OK) {
+    return result;
+  }
+  if (!readEEprom(PRODUCT_VERSION, versions, sizeof(versions))) {
+    return PN5180_START_SPI_ERROR;
+  }
+  if (versions[1] != 4) {
+    return PN5180_START_BAD_VERSION; // не 4.x — MISO залип или это не PN5180
+  }
+  return PN5180_START_OK;
+}
+
+// Версии после fastStart(): [0..1] PRODUCT, [2..3] FIRMWARE, [4..5] EEPROM (младший, старший)
+const uint8_t *PN5180::getVersions() const
+{
+  return versions;
+}
 
+// Function to start the PN5180
+bool PN5180::PN5180_Start()
+{
+  PN5180LOG.println(F("Uploaded: " __DATE__ " " __TIME__));
+  uint8_t result = fastStart();
+  if (result != PN5180_START_OK) {
+    PN5180LOG.print(F("PN5180 start error "));
+    PN5180LOG.println(result);
+    return false;
+  }
+  productVersion[0] = versions[0];
+  productVersion[1] = versions[1];
+  PN5180LOG.print(F("PN5180 version="));
+  PN5180LOG.print(versions[1]);
+  PN5180LOG.print(".");
+  PN5180LOG.print(versions[0]);
+  PN5180LOG.print(F(", firmware="));
+  PN5180LOG.print(versions[3]);
+  PN5180LOG.print(".");
+  PN5180LOG.print(versions[2]);
+  PN5180LOG.print(F(", EEPROM="));
+  PN5180LOG.print(versions[5]);
+  PN5180LOG.print(".");
+  PN5180LOG.println(versions[4]);
   return true;
 }
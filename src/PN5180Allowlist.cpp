@@ -0,0 +1,136 @@
+// NAME: PN5180Allowlist.cpp
+//
+// DESC: Список разрешённых UID с поиском за O(1): минимальная совершенная
+//       хеш-функция и 32-битные отпечатки во flash или внешней памяти.
+//
+// Этот файл является частью библиотеки PN5180 для среды Arduino.
+//
+// Эта библиотека является свободным программным обеспечением; вы можете распространять и/или
+// изменять её на условиях Стандартной Общественной Лицензии GNU (LGPL) версии 2.1
+// либо (по вашему выбору) любой более поздней версии.
+//
+// Эта библиотека распространяется в надежде, что она будет полезной,
+// но БЕЗ КАКИХ-ЛИБО ГАРАНТИЙ; даже без подразумеваемой гарантии
+// КОММЕРЧЕСКОЙ ЦЕННОСТИ или ПРИГОДНОСТИ ДЛЯ ОПРЕДЕЛЕННОЙ ЦЕЛИ. Подробнее см. в
+// Стандартной Общественной Лицензии GNU.
+//
+//
+// Тот же файл собирается на хосте (extras/host, -DPN5180_ALLOWLIST_HOST) — для
+// проверки построителя и замера поиска без Arduino.
+
+#ifdef PN5180_ALLOWLIST_HOST
+#include <string.h>
+#else
+#include <Arduino.h>
+#endif
+#include "PN5180Allowlist.h"
+
+PN5180Allowlist::PN5180Allowlist()
+{
+	reader = 0;
+	context = 0;
+	data = 0;
+	progmem = false;
+	count = 0;
+	buckets = 0;
+	seed = 0;
+}
+
+bool PN5180Allowlist::read(uint32_t offset, uint8_t *buffer, uint8_t len)
+{
+	if (reader)
+		return reader(offset, buffer, len, context);
+#ifndef PN5180_ALLOWLIST_HOST
+	if (progmem)
+	{
+		for (uint8_t i = 0; i < len; i++)
+			buffer[i] = pgm_read_byte(data + offset + i);
+		return true;
+	}
+#endif
+	memcpy(buffer, data + offset, len);
+	return true;
+}
+
+/*
+ * Заголовок читается один раз; в RAM остаются только count, buckets и seed.
+ */
+bool PN5180Allowlist::parseHeader()
+{
+	uint8_t header[PN5180_ALLOWLIST_HEADER_LEN];
+	count = 0;
+	if (!read(0, header, sizeof(header)))
+		return false;
+	if (header[0] != 'P' || header[1] != 'N' || header[2] != 'A' || header[3] != 'L' ||
+		header[4] != PN5180_ALLOWLIST_VERSION)
+		return false;
+	uint16_t n = header[6] | (header[7] << 8);
+	buckets = header[8] | (header[9] << 8);
+	seed = header[10] | (header[11] << 8);
+	if (n > PN5180_ALLOWLIST_MAX_COUNT || (n > 0 && buckets == 0))
+		return false;
+	count = n;
+	return true;
+}
+
+bool PN5180Allowlist::beginMemory(const uint8_t *image)
+{
+	reader = 0;
+	data = image;
+	progmem = false;
+	return parseHeader();
+}
+
+#ifndef PN5180_ALLOWLIST_HOST
+bool PN5180Allowlist::beginProgmem(const uint8_t *image)
+{
+	reader = 0;
+	data = image;
+	progmem = true;
+	return parseHeader();
+}
+#endif
+
+bool PN5180Allowlist::begin(PN5180AllowlistReader reader, void *context)
+{
+	this->reader = reader;
+	this->context = context;
+	data = 0;
+	return parseHeader();
+}
+
+/*
+ * Корзина по старшим битам h, смещение корзины, слот, отпечаток в слоте.
+ * Время не зависит от размера списка: два хеша и два чтения (2 и 4 байта).
+ */
+bool PN5180Allowlist::contains(const uint8_t *uid, uint8_t uidLength)
+{
+	if (count == 0)
+		return false;
+	uint32_t base = (uint32_t)seed << 16;
+	uint32_t h = pn5180AllowlistHash(uid, uidLength, base);
+
+	uint8_t buffer[4];
+	uint16_t bucket = pn5180AllowlistReduce(h, buckets);
+	if (!read(PN5180_ALLOWLIST_HEADER_LEN + 2UL * bucket, buffer, 2))
+		return false;
+	uint16_t disp = buffer[0] | (buffer[1] << 8);
+
+	uint16_t slot;
+	if (disp & PN5180_ALLOWLIST_DIRECT)
+		slot = disp & ~PN5180_ALLOWLIST_DIRECT;
+	else
+		slot = pn5180AllowlistReduce(pn5180AllowlistHash(uid, uidLength, base + disp + 1), count);
+	if (slot >= count)
+		return false;
+
+	if (!read(PN5180_ALLOWLIST_HEADER_LEN + 2UL * buckets + 4UL * slot, buffer, 4))
+		return false;
+	uint32_t fp = buffer[0] | ((uint32_t)buffer[1] << 8) | ((uint32_t)buffer[2] << 16) | ((uint32_t)buffer[3] << 24);
+	return fp == h;
+}
+
+uint16_t PN5180Allowlist::getCount() const
+{
+	return count;
+}
@@ -0,0 +1,221 @@
+// NAME: PN5180CardTracker.cpp
+//
+// DESC: Учёт карт в поле: одно событие «карта поднесена» на карту и одно
+//       «карта убрана», когда её достаточно долго нет.
+//
+// Этот файл является частью библиотеки PN5180 для среды Arduino.
+//
+// Эта библиотека является свободным программным обеспечением; вы можете распространять и/или
+// изменять её на условиях Стандартной Общественной Лицензии GNU (LGPL) версии 2.1
+// либо (по вашему выбору) любой более поздней версии.
+//
+// Эта библиотека распространяется в надежде, что она будет полезной,
+// но БЕЗ КАКИХ-ЛИБО ГАРАНТИЙ; даже без подразумеваемой гарантии
+// КОММЕРЧЕСКОЙ ЦЕННОСТИ или ПРИГОДНОСТИ ДЛЯ ОПРЕДЕЛЕННОЙ ЦЕЛИ. Подробнее см. в
+// Стандартной Общественной Лицензии GNU.
+//
+//
+// #define DEBUG 1
+
+#include <Arduino.h>
+#include "PN5180CardTracker.h"
+#include "Debug.h"
+
+#if (TRACKER_SLOTS & (TRACKER_SLOTS - 1)) != 0
+#error TRACKER_SLOTS must be a power of two
+#endif
+
+// Состояния слота
+#define SLOT_EMPTY (0)
+#define SLOT_DWELL (1)   // прочитана, событие ещё не выдано
+#define SLOT_PRESENT (2) // событие ENTER выдано
+#define SLOT_DELETED (3) // удалённая запись: поиск идёт дальше, вставка может занять
+#define SLOT_SEEN (0x80) // прочитана в текущем опросе
+
+PN5180CardTracker::PN5180CardTracker(PN5180TrackerCallback callback, void *context)
+	: callback(callback), context(context)
+{
+	dwellMs = TRACKER_DWELL_MS;
+	debouncePolls = TRACKER_DEBOUNCE_POLLS;
+	debounceMs = TRACKER_DEBOUNCE_MS;
+	memset(slots, 0, sizeof(slots));
+	count = 0;
+	resetStats();
+}
+
+// Карта должна читаться не меньше ms, прежде чем будет выдано ENTER (отсев пролётов мимо антенны)
+void PN5180CardTracker::setDwell(uint16_t ms)
+{
+	dwellMs = ms;
+}
+
+/*
+ * Карта считается убранной, когда её нет polls опросов подряд и не меньше ms.
+ * Оба условия: при частом опросе одного счётчика мало (дребезг на краю поля),
+ * при редком (пауза теплового режима) — одного времени.
+ */
+void PN5180CardTracker::setDebounce(uint8_t polls, uint16_t ms)
+{
+	debouncePolls = polls;
+	debounceMs = ms;
+}
+
+// FNV-1a по технологии и UID
+uint8_t PN5180CardTracker::hash(uint8_t technology, const uint8_t *uid, uint8_t uidLength)
+{
+	uint16_t h = 0x811C ^ technology;
+	for (uint8_t i = 0; i < uidLength; i++)
+	{
+		h ^= uid[i];
+		h *= 0x0193;
+	}
+	return (uint8_t)(h ^ (h >> 8));
+}
+
+/*
+ * Открытая адресация с линейным пробированием: не больше TRACKER_SLOTS шагов,
+ * без выделения памяти. Возвращает слот карты или -1; в freeSlot — первый
+ * слот, куда её можно вставить (TRACKER_SLOTS, если таблица заполнена).
+ */
+int8_t PN5180CardTracker::find(uint8_t technology, const uint8_t *uid, uint8_t uidLength, uint8_t *freeSlot)
+{
+	uint8_t slot = hash(technology, uid, uidLength) & (TRACKER_SLOTS - 1);
+	*freeSlot = TRACKER_SLOTS;
+	for (uint8_t probe = 0; probe < TRACKER_SLOTS; probe++)
+	{
+		PN5180TrackedCard &card = slots[slot];
+		uint8_t state = card.state & ~SLOT_SEEN;
+		if (probe + 1 > stats.maxProbe)
+			stats.maxProbe = probe + 1;
+		if (state == SLOT_EMPTY)
+		{
+			if (*freeSlot == TRACKER_SLOTS)
+				*freeSlot = slot;
+			return -1;
+		}
+		if (state == SLOT_DELETED)
+		{
+			if (*freeSlot == TRACKER_SLOTS)
+				*freeSlot = slot;
+		}
+		else if (card.technology == technology && card.uidLength == uidLength && memcmp(card.uid, uid, uidLength) == 0)
+			return slot;
+		slot = (slot + 1) & (TRACKER_SLOTS - 1);
+	}
+	return -1;
+}
+
+void PN5180CardTracker::remove(uint8_t slot)
+{
+	slots[slot].state = SLOT_DELETED;
+	count--;
+	// Пустая таблица: удалённые записи больше не нужны для поиска
+	if (count == 0)
+		memset(slots, 0, sizeof(slots));
+}
+
+uint8_t PN5180CardTracker::seen(uint8_t technology, const uint8_t *uid, uint8_t uidLength)
+{
+	if (uidLength > sizeof(slots[0].uid))
+		uidLength = sizeof(slots[0].uid);
+	stats.reads++;
+	uint32_t now = millis();
+
+	uint8_t freeSlot;
+	int8_t slot = find(technology, uid, uidLength, &freeSlot);
+	if (slot < 0)
+	{
+		if (freeSlot == TRACKER_SLOTS)
+		{
+			stats.full++;
+			return TRACKER_FULL;
+		}
+		PN5180TrackedCard &card = slots[freeSlot];
+		card.technology = technology;
+		card.uidLength = uidLength;
+		memcpy(card.uid, uid, uidLength);
+		card.firstSeen = now;
+		card.state = SLOT_DWELL;
+		count++;
+		slot = freeSlot;
+	}
+
+	PN5180TrackedCard &card = slots[slot];
+	card.lastSeen = now;
+	card.misses = 0;
+	uint8_t state = card.state & ~SLOT_SEEN;
+	card.state = state | SLOT_SEEN;
+	if (state == SLOT_PRESENT)
+	{
+		stats.duplicates++;
+		return TRACKER_PRESENT;
+	}
+	if (now - card.firstSeen < dwellMs)
+		return TRACKER_DWELL;
+
+	card.state = SLOT_PRESENT | SLOT_SEEN;
+	stats.enters++;
+	if (callback)
+		callback(TRACKER_EVENT_ENTER, card, context);
+	return TRACKER_NEW;
+}
+
+void PN5180CardTracker::endPoll()
+{
+	uint32_t now = millis();
+	for (uint8_t slot = 0; slot < TRACKER_SLOTS; slot++)
+	{
+		PN5180TrackedCard &card = slots[slot];
+		if (card.state & SLOT_SEEN)
+		{
+			card.state &= ~SLOT_SEEN;
+			continue;
+		}
+		if (card.state != SLOT_DWELL && card.state != SLOT_PRESENT)
+			continue;
+		if (card.misses < 0xFF)
+			card.misses++;
+		if (card.misses < debouncePolls || now - card.lastSeen < debounceMs)
+			continue;
+
+		if (card.state == SLOT_PRESENT)
+		{
+			stats.leaves++;
+			if (callback)
+				callback(TRACKER_EVENT_LEAVE, card, context);
+		}
+		else
+			stats.flybys++;
+		remove(slot);
+	}
+}
+
+void PN5180CardTracker::clear()
+{
+	for (uint8_t slot = 0; slot < TRACKER_SLOTS; slot++)
+	{
+		PN5180TrackedCard &card = slots[slot];
+		if ((card.state & ~SLOT_SEEN) != SLOT_PRESENT)
+			continue;
+		stats.leaves++;
+		if (callback)
+			callback(TRACKER_EVENT_LEAVE, card, context);
+	}
+	memset(slots, 0, sizeof(slots));
+	count = 0;
+}
+
+uint8_t PN5180CardTracker::getCount() const
+{
+	return count;
+}
+
+const PN5180TrackerStats &PN5180CardTracker::getStats() const
+{
+	return stats;
+}
+
+void PN5180CardTracker::resetStats()
+{
+	memset(&stats, 0, sizeof(stats));
+}
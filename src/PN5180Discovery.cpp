@@ -0,0 +1,247 @@
+// NAME: PN5180Discovery.cpp
+//
+// DESC: Цикл опроса нескольких технологий (NFC-A/B/F/V) на PN5180.
+//
+// Этот файл является частью библиотеки PN5180 для среды Arduino.
+//
+// Эта библиотека является свободным программным обеспечением; вы можете распространять и/или
+// изменять её на условиях Стандартной Общественной Лицензии GNU (LGPL) версии 2.1
+// либо (по вашему выбору) любой более поздней версии.
+//
+// Эта библиотека распространяется в надежде, что она будет полезной,
+// но БЕЗ КАКИХ-ЛИБО ГАРАНТИЙ; даже без подразумеваемой гарантии
+// КОММЕРЧЕСКОЙ ЦЕННОСТИ или ПРИГОДНОСТИ ДЛЯ ОПРЕДЕЛЕННОЙ ЦЕЛИ. Подробнее см. в
+// Стандартной Общественной Лицензии GNU.
+//
+// #define DEBUG 1
+
+#include <Arduino.h>
+#include "PN5180Discovery.h"
+#include "Debug.h"
+
+/*
+ * Все объекты должны работать с одним и тем же PN5180 (одни и те же пины).
+ * Технологии без объекта (nfcF/nfcV = 0) не опрашиваются.
+ */
+PN5180Discovery::PN5180Discovery(PN5180ISO14443 &nfcA, PN5180FeliCa *nfcF, PN5180ISO15693 *nfcV)
+	: nfcA(nfcA), nfcF(nfcF), nfcV(nfcV)
+{
+	weight[PN5180_TECH_A] = 1;
+	weight[PN5180_TECH_B] = 1;
+	weight[PN5180_TECH_F] = nfcF ? 1 : 0;
+	weight[PN5180_TECH_V] = nfcV ? 1 : 0;
+	recentCycles = DISCOVERY_RECENT_CYCLES;
+	gating = false;
+	guardUs = DISCOVERY_FIELD_GUARD_US;
+	resetStats();
+	restart();
+}
+
+/*
+ * Вес технологии — количество попыток опроса за цикл; 0 — технология не опрашивается.
+ */
+void PN5180Discovery::setWeight(uint8_t tech, uint8_t pollsPerCycle)
+{
+	if (tech >= PN5180_TECH_COUNT)
+		return;
+	if ((tech == PN5180_TECH_F && !nfcF) || (tech == PN5180_TECH_V && !nfcV))
+		pollsPerCycle = 0;
+	weight[tech] = pollsPerCycle;
+}
+
+// Технология, нашедшая карту не более cycles циклов назад, опрашивается первой
+void PN5180Discovery::setRecentCycles(uint8_t cycles)
+{
+	recentCycles = cycles;
+}
+
+/*
+ * Режим с выключением поля: между циклами поле выключено, poll() включает его
+ * перед первым опросом и выжидает guardUs — карте нужно время, чтобы получить
+ * питание и сбросить состояние. Пока карта найдена и обрабатывается, поле
+ * остаётся включённым; выключает его первый цикл без карты.
+ */
+void PN5180Discovery::setFieldGating(bool enabled, uint16_t guardUs)
+{
+	gating = enabled;
+	this->guardUs = guardUs;
+	if (!enabled && !nfcA.isRFOn())
+		nfcA.setRF_on();
+}
+
+/*
+ * Включение поля с ограниченным ожиданием TX_RFON_IRQ и защитным интервалом.
+ * Время от RF_ON до конца интервала — задержка, которую добавляет цикл.
+ */
+bool PN5180Discovery::fieldUp()
+{
+	uint32_t start = micros();
+	if (!nfcA.setRF_on())
+	{
+		stats.fieldErrors++;
+		return false;
+	}
+	// delayMicroseconds() на AVR точна только до 16383 мкс
+	if (guardUs >= 1000)
+		delay(guardUs / 1000);
+	delayMicroseconds(guardUs % 1000);
+
+	uint32_t elapsed = micros() - start;
+	stats.fieldCycles++;
+	stats.fieldUpSum += elapsed;
+	stats.fieldUpLast = elapsed;
+	if (elapsed > stats.fieldUpMax)
+		stats.fieldUpMax = elapsed;
+	return true;
+}
+
+/*
+ * Начинает новый поиск: сбрасывает приоритеты и запускает отсчёт времени до первого UID.
+ * Вызывать после reset() PN5180 и если RF-конфигурацию менял код вне этого цикла.
+ */
+void PN5180Discovery::restart()
+{
+	for (uint8_t t = 0; t < PN5180_TECH_COUNT; t++)
+		lastFound[t] = 0;
+	currentTech = PN5180_TECH_NONE;
+	measuring = false;
+}
+
+uint8_t PN5180Discovery::getTechnology() const
+{
+	return currentTech;
+}
+
+const PN5180DiscoveryStats &PN5180Discovery::getStats() const
+{
+	return stats;
+}
+
+void PN5180Discovery::resetStats()
+{
+	memset(&stats, 0, sizeof(stats));
+	stats.ttfuMin = 0xFFFFFFFF;
+}
+
+PN5180 &PN5180Discovery::device(uint8_t tech)
+{
+	if (tech == PN5180_TECH_F)
+		return *nfcF;
+	if (tech == PN5180_TECH_V)
+		return *nfcV;
+	return nfcA;
+}
+
+/*
+ * Один опрос технологии tech. RF-конфигурация загружается только при смене технологии:
+ * при повторном опросе той же технологии кэш switchRFConfig() объекта остаётся верным.
+ */
+bool PN5180Discovery::pollTechnology(uint8_t tech, PN5180DiscoveryResult *result)
+{
+	if (tech != currentTech)
+	{
+		// Другой объект мог перенастроить PN5180 — кэш конфигурации недостоверен
+		device(tech).invalidateRFConfig();
+		currentTech = tech;
+		stats.rfSwitches++;
+	}
+	stats.polls++;
+
+	memset(result, 0, sizeof(*result));
+	result->technology = tech;
+	switch (tech)
+	{
+	case PN5180_TECH_A:
+		// cardDetect: WUPA, антиколлизия и SELECT; ATQA, SAK и UID в data
+		result->uidLength = nfcA.cardDetect(result->data);
+		memcpy(result->uid, result->data + 3, result->uidLength);
+		break;
+	case PN5180_TECH_B:
+		if (nfcA.activateTypeB(result->data))
+		{
+			memcpy(result->uid, result->data, 4);
+			result->uidLength = 4;
+		}
+		break;
+	case PN5180_TECH_F:
+		if (nfcF->switchRFConfig(FELICA_TX_CONFIG_212, FELICA_RX_CONFIG_212) &&
+			nfcF->poll(FELICA_SYSTEM_CODE_ANY, FELICA_SLOTS_1, result->uid, result->data) == FELICA_OK)
+			result->uidLength = FELICA_IDM_LEN;
+		break;
+	case PN5180_TECH_V:
+		if (nfcV->switchRFConfig(ISO15693_TX_CONFIG, ISO15693_RX_CONFIG) &&
+			nfcV->getInventory(result->uid) == ISO15693_EC_OK)
+			result->uidLength = ISO15693_UID_LEN;
+		break;
+	}
+	return result->uidLength > 0;
+}
+
+/*
+ * Один цикл опроса в духе NFC Forum Activity: технологии по очереди, каждая — weight раз.
+ * Технологии, нашедшие карту за последние recentCycles циклов, идут первыми
+ * (самая недавняя — раньше), остальные — в порядке A, B, F, V.
+ * Время до первого UID отсчитывается от первого poll() после найденной карты или restart().
+ *
+ * возвращаемое значение: true — карта найдена, данные в result
+ */
+bool PN5180Discovery::poll(PN5180DiscoveryResult *result)
+{
+	if (!measuring)
+	{
+		measuring = true;
+		ttfuStart = millis();
+	}
+	if (gating && !nfcA.isRFOn() && !fieldUp())
+		return false;
+
+	uint8_t order[PN5180_TECH_COUNT];
+	uint8_t count = 0;
+	uint32_t cycle = stats.cycles + 1;
+	for (uint8_t t = 0; t < PN5180_TECH_COUNT; t++)
+	{
+		if (weight[t] == 0)
+			continue;
+		bool recent = lastFound[t] != 0 && cycle - lastFound[t] <= recentCycles;
+		uint8_t pos = count;
+		if (recent)
+		{
+			// вставка перед менее недавними и не-недавними технологиями
+			pos = 0;
+			while (pos < count && lastFound[order[pos]] != 0 && cycle - lastFound[order[pos]] <= recentCycles &&
+				   lastFound[order[pos]] >= lastFound[t])
+				pos++;
+			for (uint8_t i = count; i > pos; i--)
+				order[i] = order[i - 1];
+		}
+		order[pos] = t;
+		count++;
+	}
+
+	for (uint8_t i = 0; i < count; i++)
+	{
+		uint8_t tech = order[i];
+		for (uint8_t n = 0; n < weight[tech]; n++)
+		{
+			if (!pollTechnology(tech, result))
+				continue;
+
+			uint32_t ttfu = millis() - ttfuStart;
+			measuring = false;
+			result->ttfu = ttfu;
+			lastFound[tech] = cycle;
+			stats.found[tech]++;
+			stats.ttfuSum[tech] += ttfu;
+			stats.ttfuLast = ttfu;
+			if (ttfu < stats.ttfuMin)
+				stats.ttfuMin = ttfu;
+			if (ttfu > stats.ttfuMax)
+				stats.ttfuMax = ttfu;
+			return true;
+		}
+	}
+	stats.cycles++;
+	if (gating)
+		nfcA.setRF_off();
+	return false;
+}
@@ -0,0 +1,299 @@
+// NAME: PN5180EepromConfig.cpp
+//
+// DESC: Профили конфигурации EEPROM: одно пакетное чтение, сравнение с нужным
+//       профилем и запись только отличающихся байтов.
+//
+// Этот файл является частью библиотеки PN5180 для среды Arduino.
+//
+// Эта библиотека является свободным программным обеспечением; вы можете распространять и/или
+// изменять её на условиях Стандартной Общественной Лицензии GNU (LGPL) версии 2.1
+// либо (по вашему выбору) любой более поздней версии.
+//
+// Эта библиотека распространяется в надежде, что она будет полезной,
+// но БЕЗ КАКИХ-ЛИБО ГАРАНТИЙ; даже без подразумеваемой гарантии
+// КОММЕРЧЕСКОЙ ЦЕННОСТИ или ПРИГОДНОСТИ ДЛЯ ОПРЕДЕЛЕННОЙ ЦЕЛИ. Подробнее см. в
+// Стандартной Общественной Лицензии GNU.
+//
+//
+// #define DEBUG 1
+
+#include <Arduino.h>
+#include <stddef.h>
+#include "PN5180EepromConfig.h"
+#include "Debug.h"
+
+/*
+ * Таблица управляемых полей: адрес EEPROM, длина и смещение в PN5180EepromProfile.
+ * Порядок совпадает с номерами EECFG_* и определяет порядок значений
+ * в сериализованном профиле.
+ */
+struct EepromField {
+	uint8_t addr;
+	uint8_t len;
+	uint8_t offset;
+};
+
+static const EepromField fieldTable[EECFG_FIELD_COUNT] PROGMEM = {
+	{ IRQ_PIN_CONFIG,                  1, offsetof(PN5180EepromProfile, irqPinConfig) },
+	{ MISO_PULLUP_ENABLE,              1, offsetof(PN5180EepromProfile, misoPullupEnable) },
+	{ MFC_AUTH_TIMEOUT,                2, offsetof(PN5180EepromProfile, mfcAuthTimeout) },
+	{ LPCD_REFERENCE_VALUE,            2, offsetof(PN5180EepromProfile, lpcdReferenceValue) },
+	{ LPCD_FIELD_ON_TIME,              1, offsetof(PN5180EepromProfile, lpcdFieldOnTime) },
+	{ LPCD_THRESHOLD,                  1, offsetof(PN5180EepromProfile, lpcdThreshold) },
+	{ LPCD_REFVAL_GPO_CONTROL,         1, offsetof(PN5180EepromProfile, lpcdRefvalGpoControl) },
+	{ LPCD_GPO_TOGGLE_BEFORE_FIELD_ON, 1, offsetof(PN5180EepromProfile, lpcdGpoToggleBeforeFieldOn) },
+	{ LPCD_GPO_TOGGLE_AFTER_FIELD_OFF, 1, offsetof(PN5180EepromProfile, lpcdGpoToggleAfterFieldOff) },
+	{ DPC_CONTROL,                     1, offsetof(PN5180EepromProfile, dpcControl) },
+	{ DPC_TIME,                        2, offsetof(PN5180EepromProfile, dpcTime) },
+	{ DPC_XI,                          1, offsetof(PN5180EepromProfile, dpcXi) },
+	{ AGC_CONTROL,                     2, offsetof(PN5180EepromProfile, agcControl) },
+};
+
+static const uint8_t blobMagic0 = 'P';
+static const uint8_t blobMagic1 = '5';
+
+static uint8_t fieldAddr(uint8_t i) { return pgm_read_byte(&fieldTable[i].addr); }
+static uint8_t fieldLen(uint8_t i) { return pgm_read_byte(&fieldTable[i].len); }
+
+static uint16_t getValue(const PN5180EepromProfile &profile, uint8_t i) {
+	const uint8_t *p = (const uint8_t *)&profile + pgm_read_byte(&fieldTable[i].offset);
+	if (fieldLen(i) == 1) return *p;
+	return *(const uint16_t *)p;
+}
+
+static void setValue(PN5180EepromProfile &profile, uint8_t i, uint16_t value) {
+	uint8_t *p = (uint8_t *)&profile + pgm_read_byte(&fieldTable[i].offset);
+	if (fieldLen(i) == 1) *p = (uint8_t)value;
+	else *(uint16_t *)p = value;
+}
+
+static const __FlashStringHelper *fieldName(uint8_t i) {
+	switch (i) {
+		case EECFG_IRQ_PIN_CONFIG: return F("IRQ_PIN_CONFIG");
+		case EECFG_MISO_PULLUP_ENABLE: return F("MISO_PULLUP_ENABLE");
+		case EECFG_MFC_AUTH_TIMEOUT: return F("MFC_AUTH_TIMEOUT");
+		case EECFG_LPCD_REFERENCE_VALUE: return F("LPCD_REFERENCE_VALUE");
+		case EECFG_LPCD_FIELD_ON_TIME: return F("LPCD_FIELD_ON_TIME");
+		case EECFG_LPCD_THRESHOLD: return F("LPCD_THRESHOLD");
+		case EECFG_LPCD_REFVAL_GPO_CONTROL: return F("LPCD_REFVAL_GPO_CONTROL");
+		case EECFG_LPCD_GPO_TOGGLE_BEFORE_FIELD_ON: return F("LPCD_GPO_TOGGLE_BEFORE_FIELD_ON");
+		case EECFG_LPCD_GPO_TOGGLE_AFTER_FIELD_OFF: return F("LPCD_GPO_TOGGLE_AFTER_FIELD_OFF");
+		case EECFG_DPC_CONTROL: return F("DPC_CONTROL");
+		case EECFG_DPC_TIME: return F("DPC_TIME");
+		case EECFG_DPC_XI: return F("DPC_XI");
+		default: return F("AGC_CONTROL");
+	}
+}
+
+/*
+ * Fletcher-16 по модулю 255: дешевле CRC на AVR и ловит перестановки байтов.
+ */
+static uint16_t fletcher16(const uint8_t *data, uint8_t len) {
+	uint16_t a = 0, b = 0;
+	for (uint8_t i = 0; i < len; i++) {
+		a = (a + data[i]) % 255;
+		b = (b + a) % 255;
+	}
+	return (b << 8) | a;
+}
+
+PN5180EepromConfig::PN5180EepromConfig(PN5180 &nfc)
+	: nfc(nfc)
+{
+	resetStats();
+}
+
+/*
+ * Все управляемые поля лежат в окне 0x1A..0x5E, поэтому одна команда READ_EEPROM
+ * (69 байт) дешевле десятка коротких чтений: каждая команда стоит рукопожатия BUSY
+ * и пауз NSS.
+ */
+bool PN5180EepromConfig::readWindow(uint8_t *window) {
+	stats.reads++;
+	return nfc.readEEprom(EECFG_FIRST_ADDR, window, EECFG_WINDOW_LEN);
+}
+
+/*
+ * Накладывает управляемые поля профиля на копию окна. Возвращает маску полей,
+ * у которых отличается хотя бы один байт, в bytes - число отличающихся байтов.
+ */
+uint16_t PN5180EepromConfig::overlay(const uint8_t *window, const PN5180EepromProfile &profile,
+                                     uint8_t *desired, uint8_t &bytes) {
+	uint16_t fields = 0;
+	bytes = 0;
+	memcpy(desired, window, EECFG_WINDOW_LEN);
+	for (uint8_t i = 0; i < EECFG_FIELD_COUNT; i++) {
+		if (!(profile.fields & (1u << i))) continue;
+		uint16_t value = getValue(profile, i);
+		uint8_t pos = fieldAddr(i) - EECFG_FIRST_ADDR;
+		for (uint8_t b = 0; b < fieldLen(i); b++) {
+			uint8_t v = (uint8_t)(value >> (8 * b));
+			if (window[pos + b] != v) {
+				desired[pos + b] = v;
+				fields |= (1u << i);
+				bytes++;
+			}
+		}
+	}
+	return fields;
+}
+
+bool PN5180EepromConfig::read(PN5180EepromProfile &profile) {
+	uint8_t window[EECFG_WINDOW_LEN];
+	if (!readWindow(window)) return false;
+
+	profile.fields = EECFG_ALL_FIELDS;
+	for (uint8_t i = 0; i < EECFG_FIELD_COUNT; i++) {
+		uint8_t pos = fieldAddr(i) - EECFG_FIRST_ADDR;
+		uint16_t value = window[pos];
+		if (fieldLen(i) == 2) value |= (uint16_t)window[pos + 1] << 8;
+		setValue(profile, i, value);
+	}
+	return true;
+}
+
+bool PN5180EepromConfig::diff(const PN5180EepromProfile &profile, PN5180EepromDiff &result) {
+	uint8_t window[EECFG_WINDOW_LEN];
+	uint8_t desired[EECFG_WINDOW_LEN];
+	if (!readWindow(window)) return false;
+	result.fields = overlay(window, profile, desired, result.bytes);
+	return true;
+}
+
+/*
+ * Пишем только отличающиеся байты: ресурс EEPROM ограничен, а совпадающий профиль
+ * (обычный случай при каждом старте) не стоит ни одной записи. Соседние
+ * отличающиеся байты идут одной командой WRITE_EEPROM. После записи окно
+ * перечитывается целиком и сравнивается с ожидаемым.
+ */
+uint8_t PN5180EepromConfig::apply(const PN5180EepromProfile &profile, PN5180EepromDiff *result) {
+	uint8_t window[EECFG_WINDOW_LEN];
+	uint8_t desired[EECFG_WINDOW_LEN];
+	PN5180EepromDiff d;
+
+	stats.applies++;
+	if (!readWindow(window)) return EECFG_READ_ERROR;
+	d.fields = overlay(window, profile, desired, d.bytes);
+	if (result) *result = d;
+
+	if (0 == d.bytes) {
+		stats.upToDate++;
+		return EECFG_OK;
+	}
+
+	uint8_t pos = 0;
+	while (pos < EECFG_WINDOW_LEN) {
+		if (window[pos] == desired[pos]) {
+			pos++;
+			continue;
+		}
+		uint8_t start = pos;
+		while (pos < EECFG_WINDOW_LEN && window[pos] != desired[pos]) pos++;
+
+		PN5180DEBUG(F("EEPROM write at 0x"));
+		PN5180DEBUG(formatHex((uint8_t)(EECFG_FIRST_ADDR + start)));
+		PN5180DEBUG(F(", size="));
+		PN5180DEBUG(pos - start);
+		PN5180DEBUG(F("\n"));
+
+		stats.writeCommands++;
+		if (!nfc.writeEEprom(EECFG_FIRST_ADDR + start, &desired[start], pos - start)) {
+			return EECFG_WRITE_ERROR;
+		}
+		stats.bytesWritten += pos - start;
+	}
+
+	if (!readWindow(window)) return EECFG_READ_ERROR;
+	if (memcmp(window, desired, EECFG_WINDOW_LEN) != 0) return EECFG_VERIFY_ERROR;
+	return EECFG_OK;
+}
+
+const PN5180EepromStats &PN5180EepromConfig::getStats() const {
+	return stats;
+}
+
+void PN5180EepromConfig::resetStats() {
+	memset(&stats, 0, sizeof(stats));
+}
+
+/*
+ * Формат: 'P' '5' версия маска(2, LE) значения управляемых полей в порядке таблицы (LE)
+ * Fletcher-16(2, LE) по всем предыдущим байтам. Не зависит от порядка байтов
+ * и выравнивания платформы, поэтому один файл годится для всего парка.
+ */
+uint8_t PN5180EepromConfig::serialize(const PN5180EepromProfile &profile, uint8_t *buffer, uint8_t size) {
+	uint16_t fields = profile.fields & EECFG_ALL_FIELDS;
+	uint8_t len = 5 + 2;
+	for (uint8_t i = 0; i < EECFG_FIELD_COUNT; i++) {
+		if (fields & (1u << i)) len += fieldLen(i);
+	}
+	if (len > size) return 0;
+
+	uint8_t n = 0;
+	buffer[n++] = blobMagic0;
+	buffer[n++] = blobMagic1;
+	buffer[n++] = EECFG_BLOB_VERSION;
+	buffer[n++] = fields & 0xFF;
+	buffer[n++] = fields >> 8;
+	for (uint8_t i = 0; i < EECFG_FIELD_COUNT; i++) {
+		if (!(fields & (1u << i))) continue;
+		uint16_t value = getValue(profile, i);
+		buffer[n++] = value & 0xFF;
+		if (fieldLen(i) == 2) buffer[n++] = value >> 8;
+	}
+	uint16_t sum = fletcher16(buffer, n);
+	buffer[n++] = sum & 0xFF;
+	buffer[n++] = sum >> 8;
+	return n;
+}
+
+bool PN5180EepromConfig::deserialize(const uint8_t *buffer, uint8_t len, PN5180EepromProfile &profile) {
+	if (len < 5 + 2) return false;
+	if (buffer[0] != blobMagic0 || buffer[1] != blobMagic1) return false;
+	if (buffer[2] != EECFG_BLOB_VERSION) return false;
+
+	uint16_t sum = buffer[len - 2] | ((uint16_t)buffer[len - 1] << 8);
+	if (fletcher16(buffer, len - 2) != sum) return false;
+
+	uint16_t fields = buffer[3] | ((uint16_t)buffer[4] << 8);
+	if (fields & ~EECFG_ALL_FIELDS) return false;
+
+	uint8_t n = 5;
+	for (uint8_t i = 0; i < EECFG_FIELD_COUNT; i++) {
+		if (fields & (1u << i)) n += fieldLen(i);
+	}
+	if (n != len - 2) return false;
+
+	memset(&profile, 0, sizeof(profile));
+	profile.fields = fields;
+	n = 5;
+	for (uint8_t i = 0; i < EECFG_FIELD_COUNT; i++) {
+		if (!(fields & (1u << i))) continue;
+		uint16_t value = buffer[n++];
+		if (fieldLen(i) == 2) value |= (uint16_t)buffer[n++] << 8;
+		setValue(profile, i, value);
+	}
+	return true;
+}
+
+// formatHex() есть только в отладочной сборке
+static void printHex(Print &out, uint16_t value, uint8_t digits) {
+	while (digits-- > 0) {
+		out.print((value >> (4 * digits)) & 0x0F, HEX);
+	}
+}
+
+/*
+ * Одна строка на управляемое поле: "IRQ_PIN_CONFIG (0x1A) = 0x01"
+ */
+void PN5180EepromConfig::print(const PN5180EepromProfile &profile, Print &out) {
+	for (uint8_t i = 0; i < EECFG_FIELD_COUNT; i++) {
+		if (!(profile.fields & (1u << i))) continue;
+		out.print(fieldName(i));
+		out.print(F(" (0x"));
+		printHex(out, fieldAddr(i), 2);
+		out.print(F(") = 0x"));
+		printHex(out, getValue(profile, i), 2 * fieldLen(i));
+		out.println();
+	}
+}
@@ -0,0 +1,115 @@
+// NAME: PN5180Events.cpp
+//
+// DESC: Двоичные кадры событий карт для хоста вместо текстового вывода.
+//
+// Этот файл является частью библиотеки PN5180 для среды Arduino.
+//
+// Эта библиотека является свободным программным обеспечением; вы можете распространять и/или
+// изменять её на условиях Стандартной Общественной Лицензии GNU (LGPL) версии 2.1
+// либо (по вашему выбору) любой более поздней версии.
+//
+// Эта библиотека распространяется в надежде, что она будет полезной,
+// но БЕЗ КАКИХ-ЛИБО ГАРАНТИЙ; даже без подразумеваемой гарантии
+// КОММЕРЧЕСКОЙ ЦЕННОСТИ или ПРИГОДНОСТИ ДЛЯ ОПРЕДЕЛЕННОЙ ЦЕЛИ. Подробнее см. в
+// Стандартной Общественной Лицензии GNU.
+//
+//
+
+#include <Arduino.h>
+#include "PN5180Events.h"
+
+/*
+ * CRC-16/CCITT-FALSE побитно: таблица на 512 байт не стоит нескольких
+ * микросекунд на кадр из 20 байт при скорости порта 500 кбит/с.
+ */
+uint16_t pn5180EventCrc(const uint8_t *data, uint16_t len, uint16_t crc)
+{
+	while (len--)
+	{
+		crc ^= (uint16_t)(*data++) << 8;
+		for (uint8_t i = 0; i < 8; i++)
+			crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+	}
+	return crc;
+}
+
+PN5180EventWriter::PN5180EventWriter(Print &out)
+	: out(out)
+{
+	seq = 0;
+}
+
+/*
+ * Собирает кадр целиком и отдаёт его одним write(): HardwareSerial копирует
+ * в буфер передачи без ожидания, пока в нём есть место.
+ */
+bool PN5180EventWriter::send(uint8_t type, const uint8_t *payload, uint8_t len)
+{
+	if (len > PN5180_EVENT_MAX_PAYLOAD)
+		return false;
+	uint8_t frame[PN5180_EVENT_MAX_FRAME];
+	frame[0] = PN5180_EVENT_SOF;
+	frame[1] = len;
+	frame[2] = seq++;
+	frame[3] = type;
+	memcpy(frame + PN5180_EVENT_HEADER_LEN, payload, len);
+	uint16_t crc = pn5180EventCrc(frame + 1, PN5180_EVENT_HEADER_LEN - 1 + len);
+	frame[PN5180_EVENT_HEADER_LEN + len] = crc & 0xFF;
+	frame[PN5180_EVENT_HEADER_LEN + len + 1] = crc >> 8;
+	uint8_t total = PN5180_EVENT_HEADER_LEN + len + PN5180_EVENT_CRC_LEN;
+	return out.write(frame, total) == total;
+}
+
+bool PN5180EventWriter::hello(const uint8_t *productVersion)
+{
+	uint8_t payload[3] = {PN5180_EVENT_VERSION, productVersion[0], productVersion[1]};
+	return send(PN5180_EVENT_HELLO, payload, sizeof(payload));
+}
+
+bool PN5180EventWriter::cardEnterTypeA(const uint8_t *buffer, uint8_t uidLength)
+{
+	uint8_t payload[2 + 10 + 3];
+	if (uidLength > 10)
+		return false;
+	payload[0] = 0; // PN5180_TECH_A
+	payload[1] = uidLength;
+	memcpy(payload + 2, buffer + 3, uidLength);
+	payload[2 + uidLength] = buffer[0];
+	payload[3 + uidLength] = buffer[1];
+	payload[4 + uidLength] = buffer[2];
+	return send(PN5180_EVENT_CARD_ENTER, payload, 5 + uidLength);
+}
+
+bool PN5180EventWriter::cardEnter(uint8_t technology, const uint8_t *uid, uint8_t uidLength)
+{
+	uint8_t payload[2 + 10];
+	if (uidLength > 10)
+		return false;
+	payload[0] = technology;
+	payload[1] = uidLength;
+	memcpy(payload + 2, uid, uidLength);
+	return send(PN5180_EVENT_CARD_ENTER, payload, 2 + uidLength);
+}
+
+bool PN5180EventWriter::cardLeave(uint8_t technology, const uint8_t *uid, uint8_t uidLength)
+{
+	uint8_t payload[2 + 10];
+	if (uidLength > 10)
+		return false;
+	payload[0] = technology;
+	payload[1] = uidLength;
+	memcpy(payload + 2, uid, uidLength);
+	return send(PN5180_EVENT_CARD_LEAVE, payload, 2 + uidLength);
+}
+
+bool PN5180EventWriter::apduResult(uint8_t index, uint16_t sw, uint16_t responseLength)
+{
+	uint8_t payload[5] = {index, (uint8_t)(sw >> 8), (uint8_t)(sw & 0xFF), (uint8_t)(responseLength & 0xFF), (uint8_t)(responseLength >> 8)};
+	return send(PN5180_EVENT_APDU_RESULT, payload, sizeof(payload));
+}
+
+bool PN5180EventWriter::error(uint8_t code, uint32_t detail)
+{
+	uint8_t payload[5] = {code, (uint8_t)detail, (uint8_t)(detail >> 8), (uint8_t)(detail >> 16), (uint8_t)(detail >> 24)};
+	return send(PN5180_EVENT_ERROR, payload, sizeof(payload));
+}
@@ -0,0 +1,214 @@
+// NAME: PN5180FeliCa.cpp
+//
+// DESC: Протокол FeliCa (NFC-F) на модуле NXP Semiconductors PN5180 для Arduino.
+//
+// Этот файл является частью библиотеки PN5180 для среды Arduino.
+//
+// Эта библиотека является свободным программным обеспечением; вы можете распространять и/или
+// изменять её на условиях Стандартной Общественной Лицензии GNU (LGPL) версии 2.1
+// либо (по вашему выбору) любой более поздней версии.
+//
+// Эта библиотека распространяется в надежде, что она будет полезной,
+// но БЕЗ КАКИХ-ЛИБО ГАРАНТИЙ; даже без подразумеваемой гарантии
+// КОММЕРЧЕСКОЙ ЦЕННОСТИ или ПРИГОДНОСТИ ДЛЯ ОПРЕДЕЛЕННОЙ ЦЕЛИ. Подробнее см. в
+// Стандартной Общественной Лицензии GNU.
+//
+// #define DEBUG 1
+
+#include <Arduino.h>
+#include "PN5180FeliCa.h"
+#include "Debug.h"
+
+// Ответ на SENSF_REQ: слот 0 начинается через 2,417 мс, каждый следующий — через 1,208 мс (в тактах 13,56 МГц)
+#define FELICA_POLL_BASE_CYCLES (32775UL)
+#define FELICA_POLL_SLOT_CYCLES (16380UL)
+// Единица времени ответа из PMm: 256 * 16 / fc ≈ 302 мкс
+#define FELICA_PMM_UNIT_CYCLES (4096UL)
+// Таймаут команды, если PMm неизвестен: 100 мс
+#define FELICA_DEFAULT_TIMEOUT_CYCLES (1356000UL)
+
+PN5180FeliCa::PN5180FeliCa(uint8_t SSpin, uint8_t BUSYpin, uint8_t RSTpin)
+	: PN5180(SSpin, BUSYpin, RSTpin)
+{
+}
+
+bool PN5180FeliCa::setupRF(uint8_t bitRate)
+{
+	PN5180DEBUG(F("Загрузка RF-конфигурации FeliCa...\n"));
+	bool loaded = (bitRate == FELICA_BITRATE_424) ? loadRFConfig(FELICA_TX_CONFIG_424, FELICA_RX_CONFIG_424)
+												  : loadRFConfig(FELICA_TX_CONFIG_212, FELICA_RX_CONFIG_212);
+	if (!loaded)
+		return false;
+
+	PN5180DEBUG(F("Включение RF поля...\n"));
+	return setRF_on();
+}
+
+/*
+ * Отправляет кадр FeliCa и ждёт ответ не дольше timeoutCycles (TIMER1).
+ * cmd[0] — байт длины (LEN, включая себя), его заполняет эта функция; CRC добавляет PN5180.
+ * responseCode : ожидаемый код ответа (второй байт кадра)
+ * result       : указатель на ответ (LEN, код, данные) во внутреннем буфере PN5180
+ */
+FeliCaResult PN5180FeliCa::issueCommand(uint8_t *cmd, uint8_t cmdLen, uint8_t responseCode, uint8_t **result, int16_t *resultLen,
+										uint32_t timeoutCycles)
+{
+	*resultLen = 0;
+	cmd[0] = cmdLen;
+	startRxTimeout(timeoutCycles);
+	if (!sendData(cmd, cmdLen, 0))
+		return FELICA_PN5180_ERROR;
+
+	int16_t len = waitForRx();
+	if (len == 0)
+		return FELICA_NO_CARD;
+	if (len < 2)
+		return FELICA_RX_ERROR;
+
+	*result = readData(len);
+	if (*result == 0)
+		return FELICA_PN5180_ERROR;
+	if ((*result)[0] != len || (*result)[1] != responseCode)
+		return FELICA_RX_ERROR;
+	*resultLen = len;
+	return FELICA_OK;
+}
+
+/*
+ * SENSF_REQ (Polling, код 00) с timeSlots слотами (FELICA_SLOTS_*).
+ * Карты выбирают слот случайно; PN5180 принимает только первый ответ после передачи,
+ * поэтому возвращается IDm/PMm карты, ответившей в самом раннем слоте.
+ * systemCode : FELICA_SYSTEM_CODE_ANY или код системы (например, 0x0003 для транспортных карт)
+ * idm, pmm   : по 8 байт; pmm может быть 0
+ */
+FeliCaResult PN5180FeliCa::poll(uint16_t systemCode, uint8_t timeSlots, uint8_t *idm, uint8_t *pmm)
+{
+	// LEN, 00, системный код (старший байт первым), RC = 00 (без дополнительных данных), TSN
+	uint8_t cmd[6] = {0, 0x00, (uint8_t)(systemCode >> 8), (uint8_t)(systemCode & 0xFF), 0x00, (uint8_t)(timeSlots & 0x0F)};
+
+	uint8_t *result;
+	int16_t len;
+	uint32_t timeout = FELICA_POLL_BASE_CYCLES + FELICA_POLL_SLOT_CYCLES * ((timeSlots & 0x0F) + 1);
+	FeliCaResult rc = issueCommand(cmd, sizeof(cmd), 0x01, &result, &len, timeout);
+	if (rc != FELICA_OK)
+		return rc;
+
+	// LEN, 01, IDm(8), PMm(8), [RD(2)]
+	if (len < 2 + FELICA_IDM_LEN + FELICA_PMM_LEN)
+		return FELICA_RX_ERROR;
+	memcpy(idm, result + 2, FELICA_IDM_LEN);
+	if (pmm)
+		memcpy(pmm, result + 2 + FELICA_IDM_LEN, FELICA_PMM_LEN);
+	return FELICA_OK;
+}
+
+/*
+ * Сбор нескольких карт в поле: повторяет SENSF_REQ с 16 слотами до polls раз.
+ * Каждый опрос даёт карту из самого раннего занятого слота; так как карты выбирают
+ * слот заново при каждом запросе, за несколько опросов находятся разные карты.
+ * Сбор прекращается, когда буфер заполнен или два опроса подряд не дали новой карты.
+ * idms, pmms : буферы на maxCards * 8 байт; pmms может быть 0
+ *
+ * возвращаемое значение: количество найденных карт
+ */
+uint8_t PN5180FeliCa::pollMultiple(uint16_t systemCode, uint8_t *idms, uint8_t *pmms, uint8_t maxCards, uint8_t polls)
+{
+	uint8_t numCards = 0;
+	uint8_t idle = 0;
+	for (uint8_t i = 0; i < polls && numCards < maxCards && idle < 2; i++)
+	{
+		uint8_t idm[FELICA_IDM_LEN];
+		uint8_t pmm[FELICA_PMM_LEN];
+		FeliCaResult rc = poll(systemCode, FELICA_SLOTS_16, idm, pmm);
+		if (rc == FELICA_NO_CARD && numCards == 0)
+			break;
+		if (rc == FELICA_PN5180_ERROR)
+			break;
+
+		bool known = (rc != FELICA_OK);
+		for (uint8_t n = 0; n < numCards && !known; n++)
+			known = memcmp(idms + n * FELICA_IDM_LEN, idm, FELICA_IDM_LEN) == 0;
+		if (known)
+		{
+			idle++;
+			continue;
+		}
+		memcpy(idms + numCards * FELICA_IDM_LEN, idm, FELICA_IDM_LEN);
+		if (pmms)
+			memcpy(pmms + numCards * FELICA_PMM_LEN, pmm, FELICA_PMM_LEN);
+		numCards++;
+		idle = 0;
+	}
+	return numCards;
+}
+
+/*
+ * Read Without Encryption (код 06): numBlocks блоков одного сервиса одной командой.
+ * Максимальное время ответа берётся из PMm (байт 5: A — биты 2..0, B — биты 5..3, E — биты 7..6):
+ * T = 302 мкс * ((B + 1) * numBlocks + A + 1) * 4^E.
+ * pmm          : PMm карты из poll() или 0 (таймаут 100 мс)
+ * blockNumbers : номера блоков; номера > 255 кодируются трёхбайтовым элементом списка
+ * blockData    : буфер на numBlocks * 16 байт
+ * statusFlags  : если не 0 — Status Flag 1 (старший байт) и Status Flag 2 ответа
+ */
+FeliCaResult PN5180FeliCa::readWithoutEncryption(const uint8_t *idm, const uint8_t *pmm, uint16_t serviceCode, const uint16_t *blockNumbers,
+												 uint8_t numBlocks, uint8_t *blockData, uint16_t *statusFlags)
+{
+	if (numBlocks == 0 || numBlocks > FELICA_MAX_BLOCKS)
+		return FELICA_INVALID_PARAMETER;
+
+	// LEN, 06, IDm, кол-во сервисов = 1, код сервиса (младший байт первым), кол-во блоков, список блоков
+	uint8_t cmd[14 + 3 * FELICA_MAX_BLOCKS];
+	uint8_t cmdLen = 0;
+	cmd[cmdLen++] = 0;
+	cmd[cmdLen++] = 0x06;
+	memcpy(cmd + cmdLen, idm, FELICA_IDM_LEN);
+	cmdLen += FELICA_IDM_LEN;
+	cmd[cmdLen++] = 1;
+	cmd[cmdLen++] = serviceCode & 0xFF;
+	cmd[cmdLen++] = serviceCode >> 8;
+	cmd[cmdLen++] = numBlocks;
+	for (uint8_t i = 0; i < numBlocks; i++)
+	{
+		// Элемент списка блоков: бит 7 — двухбайтовый элемент, биты 3..0 — индекс сервиса (0)
+		if (blockNumbers[i] <= 0xFF)
+		{
+			cmd[cmdLen++] = 0x80;
+			cmd[cmdLen++] = blockNumbers[i];
+		}
+		else
+		{
+			cmd[cmdLen++] = 0x00;
+			cmd[cmdLen++] = blockNumbers[i] & 0xFF;
+			cmd[cmdLen++] = blockNumbers[i] >> 8;
+		}
+	}
+
+	uint32_t timeout = FELICA_DEFAULT_TIMEOUT_CYCLES;
+	if (pmm)
+	{
+		uint8_t a = pmm[5] & 0x07;
+		uint8_t b = (pmm[5] >> 3) & 0x07;
+		uint8_t e = pmm[5] >> 6;
+		timeout = (FELICA_PMM_UNIT_CYCLES * ((b + 1) * numBlocks + a + 1) << (2 * e)) + FELICA_POLL_BASE_CYCLES;
+	}
+
+	uint8_t *result;
+	int16_t len;
+	FeliCaResult rc = issueCommand(cmd, cmdLen, 0x07, &result, &len, timeout);
+	if (rc != FELICA_OK)
+		return rc;
+
+	// LEN, 07, IDm, Status Flag 1, Status Flag 2, [кол-во блоков, данные]
+	if (len < 12 || memcmp(result + 2, idm, FELICA_IDM_LEN) != 0)
+		return FELICA_RX_ERROR;
+	if (statusFlags)
+		*statusFlags = ((uint16_t)result[10] << 8) | result[11];
+	if (result[10] != 0)
+		return FELICA_STATUS_ERROR;
+	if (len != 13 + numBlocks * FELICA_BLOCK_SIZE || result[12] != numBlocks)
+		return FELICA_RX_ERROR;
+
+	memcpy(blockData, result + 13, numBlocks * FELICA_BLOCK_SIZE);
+	return FELICA_OK;
+}
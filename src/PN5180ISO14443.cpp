@@ -25,6 +25,34 @@
 PN5180ISO14443::PN5180ISO14443(uint8_t SSpin, uint8_t BUSYpin, uint8_t RSTpin)
 	: PN5180(SSpin, BUSYpin, RSTpin)
 {
+	mfcKeys = 0;
+	mfcKeyCount = 0;
+	mfcKeyCacheNext = 0;
+	for (int i = 0; i < MIFARE_CLASSIC_MAX_KEYS; i++)
+		mfcKeyHits[i] = 0;
+	for (int i = 0; i < MIFARE_CLASSIC_KEY_CACHE_SIZE; i++)
+		mfcKeyCache[i].keyIndex = 0xFF;
+
+	isoDepActive = false;
+	isoDepBlockNumber = 0;
+	isoDepCidEnabled = false;
+	isoDepCid = 0;
+	isoDepNadEnabled = false;
+	isoDepNad = 0;
+	isoDepFwi = 4;
+	isoDepFsc = 32;
+	memset(&ats, 0, sizeof(ats));
+}
+
+/*
+ * Таблица размеров кадра FSDI/FSCI -> FSD/FSC в байтах (ISO14443-4, 5.2.2).
+ * Значения 9..15 ограничены 256: больший кадр не помещается в буфер передачи PN5180.
+ */
+static const uint16_t isoDepFrameSizes[9] PROGMEM = {16, 24, 32, 40, 48, 64, 96, 128, 256};
+
+static uint16_t isoDepFrameSize(uint8_t fsi)
+{
+	return pgm_read_word(&isoDepFrameSizes[(fsi > 8) ? 8 : fsi]);
 }
 
 bool PN5180ISO14443::setupRF()
@@ -73,35 +101,65 @@ uint16_t PN5180ISO14443::rxBytesReceived()
  */
 uint8_t PN5180ISO14443::activateTypeA(uint8_t *buffer, uint8_t kind)
 {
-	uint8_t cmd[7];
-	uint8_t uidLength = 0;
-	// Загружаем стандартный протокол TypeA
-	if (!loadRFConfig(0x0, 0x80))
+	if (!prepareTypeA())
+		return 0;
+	// Отправляем REQA/WUPA, 7 бит в последнем байте
+	uint8_t cmd = (kind == 0) ? 0x26 : 0x52;
+	if (!startRxTimeout(ISO14443A_RESPONSE_TIMEOUT_CYCLES) || !sendData(&cmd, 1, 0x07))
+		return 0;
+	// Читаем 2 байта ATQA в buffer; коллизия битов ATQA — несколько карт, антиколлизия выберет одну
+	int16_t len = waitForRx();
+	if ((len != 2 && len != PN5180_RX_COLLISION) || !readData(2, buffer))
 		return 0;
+	return activateTypeASelect(buffer);
+}
 
+/*
+ * Подготовка к REQA/WUPA: RF-конфигурация TypeA, Crypto и CRC выключены.
+ * Новая активация завершает предыдущую сессию ISO-DEP.
+ */
+bool PN5180ISO14443::prepareTypeA()
+{
+	isoDepActive = false;
+	// Загружаем стандартный протокол TypeA (если активна другая конфигурация)
+	if (!switchRFConfig(ISO14443A_TX_CONFIG_106, ISO14443A_RX_CONFIG_106))
+		return false;
 	// Отключаем Crypto
 	if (!writeRegisterWithAndMask(SYSTEM_CONFIG, 0xFFFFFFBF))
-		return 0;
+		return false;
 	// Сбрасываем RX CRC
 	if (!writeRegisterWithAndMask(CRC_RX_CONFIG, 0xFFFFFFFE))
-		return 0;
+		return false;
 	// Сбрасываем TX CRC
-	if (!writeRegisterWithAndMask(CRC_TX_CONFIG, 0xFFFFFFFE))
-		return 0;
-	// Отправляем REQA/WUPA, 7 бит в последнем байте
-	cmd[0] = (kind == 0) ? 0x26 : 0x52;
-	if (!sendData(cmd, 1, 0x07))
-		return 0;
-	// Читаем 2 байта ATQA в buffer
-	if (!readData(2, buffer))
-		return 0;
+	return writeRegisterWithAndMask(CRC_TX_CONFIG, 0xFFFFFFFE);
+}
+
+/*
+ * Кадр активации Type A и ответ карты. READ_DATA — только после того, как ответ
+ * принят (waitForRx()) и его длина совпала: BUSY ждёт лишь выполнения команды SPI,
+ * а не ответа карты, и раньше времени в буфере приёма остаётся прежний кадр.
+ */
+bool PN5180ISO14443::exchangeTypeA(uint8_t *cmd, uint8_t len, uint8_t *response, uint8_t responseLen)
+{
+	if (!startRxTimeout(ISO14443A_RESPONSE_TIMEOUT_CYCLES) || !sendData(cmd, len, 0x00))
+		return false;
+	return waitForRx() == responseLen && readData(responseLen, response);
+}
+
+/*
+ * Антиколлизия и SELECT карты, уже ответившей ATQA (состояние READY).
+ * Отдельно от activateTypeA() — для REQA/WUPA, отправленных без ожидания (pollRx()).
+ * buffer : ATQA в buffer[0..1]; сюда же записываются SAK и UID, как в activateTypeA()
+ */
+uint8_t PN5180ISO14443::activateTypeASelect(uint8_t *buffer)
+{
+	uint8_t cmd[7];
+	uint8_t uidLength = 0;
 	// Отправляем Anti collision 1, 8 бит в последнем байте
 	cmd[0] = 0x93;
 	cmd[1] = 0x20;
-	if (!sendData(cmd, 2, 0x00))
-		return 0;
 	// Читаем 5 байт, сохраняем с offset 2 для дальнейшего использования
-	if (!readData(5, cmd + 2))
+	if (!exchangeTypeA(cmd, 2, cmd + 2, 5))
 		return 0;
 	// Включаем вычисление RX CRC
 	if (!writeRegisterWithOrMask(CRC_RX_CONFIG, 0x01))
@@ -112,10 +170,8 @@ uint8_t PN5180ISO14443::activateTypeA(uint8_t *buffer, uint8_t kind)
 	// Отправляем Select anti collision 1, остальные байты уже в offset 2 и далее
 	cmd[0] = 0x93;
 	cmd[1] = 0x70;
-	if (!sendData(cmd, 7, 0x00))
-		return 0;
 	// Читаем 1 байт SAK в buffer[2]
-	if (!readData(1, buffer + 2))
+	if (!exchangeTypeA(cmd, 7, buffer + 2, 1))
 		return 0;
 	// Проверяем, 4-байтовый UID или 7-байтовый UID и требуется ли anti collision 2
 	// Если бит 3 равен 0 — это 4-байтовый UID
@@ -142,10 +198,8 @@ uint8_t PN5180ISO14443::activateTypeA(uint8_t *buffer, uint8_t kind)
 		// Выполняем anti collision 2
 		cmd[0] = 0x95;
 		cmd[1] = 0x20;
-		if (!sendData(cmd, 2, 0x00))
-			return 0;
 		// Читаем 5 байт, сохраняем с offset 2 для дальнейшего использования
-		if (!readData(5, cmd + 2))
+		if (!exchangeTypeA(cmd, 2, cmd + 2, 5))
 			return 0;
 		// первые 4 байта — это последние 4 байта UID, сохраняем их
 		for (int i = 0; i < 4; i++)
@@ -161,10 +215,8 @@ uint8_t PN5180ISO14443::activateTypeA(uint8_t *buffer, uint8_t kind)
 		// Отправляем Select anti collision 2
 		cmd[0] = 0x95;
 		cmd[1] = 0x70;
-		if (!sendData(cmd, 7, 0x00))
-			return 0;
 		// Читаем 1 байт SAK в buffer[2]
-		if (!readData(1, buffer + 2))
+		if (!exchangeTypeA(cmd, 7, buffer + 2, 1))
 			return 0;
 		uidLength = 7;
 	}
@@ -182,8 +234,8 @@ bool PN5180ISO14443::mifareBlockRead(uint8_t blockno, uint8_t *buffer)
 	cmd[1] = blockno;
 	if (!sendData(cmd, 2, 0x00))
 	{
-		Serial.print(F("Ошибка чтения блока "));
-		Serial.println(blockno, HEX);
+		PN5180LOG.print(F("Ошибка чтения блока "));
+		PN5180LOG.println(blockno, HEX);
 		return false;
 	}
 	// Проверяем, получили ли мы какие-либо данные от метки
@@ -195,30 +247,30 @@ bool PN5180ISO14443::mifareBlockRead(uint8_t blockno, uint8_t *buffer)
 		if (readData(16, buffer))
 		{
 			// Выводим только одну страницу (4 байта)
-			Serial.print(F("--- Содержимое страницы 0x"));
-			Serial.print(blockno, HEX);
-			Serial.println(F(" ---"));
+			PN5180LOG.print(F("--- Содержимое страницы 0x"));
+			PN5180LOG.print(blockno, HEX);
+			PN5180LOG.println(F(" ---"));
 			char hexStr[4]; // "XX\0"
 			for (int i = 0; i < 4; i++)
 			{
 				snprintf(hexStr, sizeof(hexStr), "%02X", buffer[i]);
-				Serial.print(hexStr);
+				PN5180LOG.print(hexStr);
 				if (i < 3)
-					Serial.print(":");
+					PN5180LOG.print(":");
 			}
-			Serial.println();
+			PN5180LOG.println();
 			success = true;
 		}
 		else
 		{
-			Serial.print(F("Ошибка чтения блока "));
-			Serial.println(blockno, HEX);
+			PN5180LOG.print(F("Ошибка чтения блока "));
+			PN5180LOG.println(blockno, HEX);
 		}
 	}
 	else
 	{
-		Serial.print(F("Ошибка чтения блока "));
-		Serial.println(blockno, HEX);
+		PN5180LOG.print(F("Ошибка чтения блока "));
+		PN5180LOG.println(blockno, HEX);
 	}
 	return success;
 }
@@ -230,34 +282,312 @@ uint8_t PN5180ISO14443::mifareUltralightWrite(uint8_t block, uint8_t *data4)
 	cmd[1] = block; // Адрес блока (page)
 	memcpy(&cmd[2], data4, 4);
 
-	// Отправляем команду
-	if (!sendData(cmd, 6, 0x00))
+	// ACK — 4 бита без CRC, поэтому на время записи проверка RX CRC отключается
+	if (!writeRegisterWithAndMask(CRC_RX_CONFIG, 0xFFFFFFFE))
+		return 0xFF;
+	// Отправляем команду и ждём ответ: READ_DATA до его приёма вернул бы старый байт
+	startRxTimeout(MIFARE_UL_WRITE_TIMEOUT_CYCLES);
+	bool sent = sendData(cmd, 6, 0x00);
+	uint8_t ack = 0;
+	bool received = sent && waitForRx() == 1 && readData(1, &ack);
+	writeRegisterWithOrMask(CRC_RX_CONFIG, 0x01);
+	if (!sent)
 		return 0xFF; // Ошибка отправки
 
 	// Выводим информацию о блоке и данных
-	Serial.print(F("Запись блока 0x"));
-	Serial.print(block, HEX);
-	Serial.print(F(": "));
+	PN5180LOG.print(F("Запись блока 0x"));
+	PN5180LOG.print(block, HEX);
+	PN5180LOG.print(F(": "));
 	for (int i = 0; i < 4; i++)
 	{
 		if (i > 0)
-			Serial.print(":");
+			PN5180LOG.print(":");
 		if (data4[i] < 0x10)
-			Serial.print("0");
-		Serial.print(data4[i], HEX);
+			PN5180LOG.print("0");
+		PN5180LOG.print(data4[i], HEX);
 	}
-	Serial.println();
+	PN5180LOG.println();
 
-	uint8_t ack = 0;
-	if (!readData(1, &ack))
+	if (!received)
 		return 0xFE; // Ошибка чтения
 
 	return ack; // Возвращаем код ответа
 }
 
+/*
+ * Раскладка памяти MIFARE Classic:
+ * - сектора 0..31 — по 4 блока (1K: сектора 0..15, 4K: сектора 0..31)
+ * - сектора 32..39 — по 16 блоков (только 4K)
+ * Последний блок каждого сектора — трейлер (ключи и биты доступа).
+ */
+uint8_t PN5180ISO14443::mifareClassicSectorFirstBlock(uint8_t sector)
+{
+	if (sector < 32)
+		return sector * 4;
+	return 128 + (sector - 32) * 16;
+}
+
+uint8_t PN5180ISO14443::mifareClassicSectorBlockCount(uint8_t sector)
+{
+	return (sector < 32) ? 4 : 16;
+}
+
+/*
+ * Аутентификация MIFARE Classic через команду PN5180 MFC_AUTHENTICATE (0x0C).
+ * uid — UID карты (4 или 7 байт), для 7-байтового UID используются последние 4 байта.
+ * Карта должна быть активирована (activateTypeA) перед вызовом.
+ * После неудачной аутентификации карта переходит в состояние HALT и
+ * требует повторной активации через WUPA.
+ *
+ * возвращаемое значение: MIFARE_AUTH_OK, MIFARE_AUTH_FAILED, MIFARE_AUTH_TIMEOUT или MIFARE_AUTH_ERROR
+ */
+uint8_t PN5180ISO14443::mifareClassicAuthenticate(uint8_t blockno, uint8_t keyType, const uint8_t *key, const uint8_t *uid, uint8_t uidLength)
+{
+	const uint8_t *authUid = (uidLength == 7) ? uid + 3 : uid;
+	return mifareAuthenticate(blockno, keyType, key, authUid);
+}
+
+/*
+ * Чтение 16-байтового блока MIFARE Classic после аутентификации.
+ * Шифрование Crypto1 выполняется PN5180, поэтому команда та же, что и для Ultralight (0x30).
+ */
+bool PN5180ISO14443::mifareClassicBlockRead(uint8_t blockno, uint8_t *buffer)
+{
+	uint8_t cmd[2] = {0x30, blockno};
+	startRxTimeout(MIFARE_CLASSIC_RESPONSE_TIMEOUT_CYCLES);
+	if (!sendData(cmd, 2, 0x00))
+		return false;
+
+	// NAK — 4 бита без CRC: ошибка приёма или неверная длина
+	if (waitForRx() != 16)
+		return false;
+
+	return readData(16, buffer);
+}
+
+/*
+ * Ответ карты на фазу записи: ровно один байт с 4 значащими битами и значением ACK (0x0A).
+ * Старый байт в буфере приёма не принимается за ответ: без нового кадра waitForRx() вернёт 0.
+ */
+bool PN5180ISO14443::mifareClassicWaitAck()
+{
+	if (waitForRx() != 1)
+		return false;
+	uint32_t rxStatus;
+	if (!readRegister(RX_STATUS, &rxStatus) ||
+		((rxStatus & RX_NUM_LAST_BITS_MASK) >> RX_NUM_LAST_BITS_SHIFT) != MIFARE_CLASSIC_ACK_BITS)
+		return false;
+	uint8_t *ack = readData(1);
+	return ack != 0 && (ack[0] & 0x0F) == MIFARE_UL_ACK;
+}
+
+/*
+ * Запись 16-байтового блока MIFARE Classic после аутентификации.
+ * Запись выполняется в две фазы: A0 + номер блока, затем 16 байт данных.
+ * На каждую фазу карта отвечает 4-битным ACK (0x0A), поэтому RX CRC на время записи отключается.
+ */
+bool PN5180ISO14443::mifareClassicBlockWrite(uint8_t blockno, const uint8_t *data16)
+{
+	uint8_t cmd[16];
+	bool success = false;
+
+	// Сбрасываем RX CRC: ACK приходит без CRC
+	if (!writeRegisterWithAndMask(CRC_RX_CONFIG, 0xFFFFFFFE))
+		return false;
+
+	// Фаза 1: команда записи
+	cmd[0] = 0xA0;
+	cmd[1] = blockno;
+	startRxTimeout(MIFARE_CLASSIC_RESPONSE_TIMEOUT_CYCLES);
+	if (sendData(cmd, 2, 0x00) && mifareClassicWaitAck())
+	{
+		// Фаза 2: данные блока
+		memcpy(cmd, data16, 16);
+		startRxTimeout(MIFARE_CLASSIC_WRITE_TIMEOUT_CYCLES);
+		success = sendData(cmd, 16, 0x00) && mifareClassicWaitAck();
+	}
+
+	// Включаем вычисление RX CRC
+	writeRegisterWithOrMask(CRC_RX_CONFIG, 0x01);
+
+	if (!success)
+	{
+		PN5180LOG.print(F("Ошибка записи блока "));
+		PN5180LOG.println(blockno, HEX);
+	}
+	return success;
+}
+
+/*
+ * Читает все блоки уже аутентифицированного сектора в buffer.
+ * возвращаемое значение: количество прочитанных байт (0 — ошибка)
+ */
+uint8_t PN5180ISO14443::mifareClassicReadSectorBlocks(uint8_t sector, uint8_t *buffer)
+{
+	uint8_t first = mifareClassicSectorFirstBlock(sector);
+	uint8_t count = mifareClassicSectorBlockCount(sector);
+	for (uint8_t i = 0; i < count; i++)
+	{
+		if (!mifareClassicBlockRead(first + i, buffer + 16 * i))
+		{
+			PN5180LOG.print(F("Ошибка чтения блока "));
+			PN5180LOG.println(first + i, HEX);
+			return 0;
+		}
+	}
+	return count * 16;
+}
+
+/*
+ * Читает сектор MIFARE Classic целиком: одна аутентификация на сектор, затем все блоки сектора.
+ * buffer : 64 байта для секторов 0..31, 256 байт для секторов 32..39
+ */
+bool PN5180ISO14443::mifareClassicReadSector(uint8_t sector, uint8_t keyType, const uint8_t *key, const uint8_t *uid, uint8_t uidLength, uint8_t *buffer)
+{
+	uint8_t status = mifareClassicAuthenticate(mifareClassicSectorFirstBlock(sector), keyType, key, uid, uidLength);
+	if (status != MIFARE_AUTH_OK)
+	{
+		PN5180LOG.print(F("Аутентификация сектора "));
+		PN5180LOG.print(sector);
+		PN5180LOG.print(F(" не удалась, статус "));
+		PN5180LOG.println(status, HEX);
+		return false;
+	}
+	return mifareClassicReadSectorBlocks(sector, buffer) != 0;
+}
+
+/*
+ * FNV-1a по всему UID, свёрнутый до 16 бит. Совпадение хешей разных карт
+ * стоит лишь одной лишней попытки аутентификации.
+ */
+uint16_t PN5180ISO14443::mifareClassicUidHash(const uint8_t *uid, uint8_t uidLength)
+{
+	uint32_t hash = 2166136261UL;
+	for (uint8_t i = 0; i < uidLength; i++)
+	{
+		hash ^= uid[i];
+		hash *= 16777619UL;
+	}
+	return (uint16_t)(hash ^ (hash >> 16));
+}
+
+/*
+ * Задаёт список ключей для перебора в mifareClassicReadSectorAnyKey.
+ * Список не копируется, массив должен существовать всё время работы.
+ * Смена списка сбрасывает статистику и кэш ключей.
+ */
+void PN5180ISO14443::mifareClassicSetKeys(const uint8_t (*keys)[6], uint8_t count)
+{
+	mfcKeys = keys;
+	mfcKeyCount = (count > MIFARE_CLASSIC_MAX_KEYS) ? MIFARE_CLASSIC_MAX_KEYS : count;
+	mfcKeyCacheNext = 0;
+	for (int i = 0; i < MIFARE_CLASSIC_MAX_KEYS; i++)
+		mfcKeyHits[i] = 0;
+	for (int i = 0; i < MIFARE_CLASSIC_KEY_CACHE_SIZE; i++)
+		mfcKeyCache[i].keyIndex = 0xFF;
+}
+
+/*
+ * Перебор ключей: читает сектор, пробуя ключи из списка mifareClassicSetKeys.
+ * Порядок перебора:
+ * 1. ключ, который в последний раз подошёл для карты с тем же UID (кэш);
+ * 2. остальные ключи по убыванию числа успешных аутентификаций.
+ * Так для однотипного парка карт почти всегда хватает одной аутентификации.
+ * После каждой неудачной попытки карта заново активируется через WUPA,
+ * при этом проверяется, что в поле та же карта.
+ * Случайный UID (RID, UID0 = 0x08) меняется при каждой активации: такие карты
+ * в кэш не попадают и не вытесняют из него постоянные.
+ * Карта должна быть активирована перед вызовом.
+ *
+ * возвращаемое значение: индекс подошедшего ключа или -1
+ */
+int8_t PN5180ISO14443::mifareClassicReadSectorAnyKey(uint8_t sector, uint8_t keyType, const uint8_t *uid, uint8_t uidLength, uint8_t *buffer)
+{
+	if (mfcKeys == 0 || mfcKeyCount == 0)
+		return -1;
+
+	// Ищем UID в кэше
+	bool cacheable = !(uidLength == 4 && uid[0] == MIFARE_CLASSIC_RANDOM_UID);
+	uint16_t uidHash = mifareClassicUidHash(uid, uidLength);
+	int8_t cacheSlot = -1;
+	for (int i = 0; i < MIFARE_CLASSIC_KEY_CACHE_SIZE && cacheable; i++)
+	{
+		if (mfcKeyCache[i].keyIndex < mfcKeyCount && mfcKeyCache[i].uidHash == uidHash)
+		{
+			cacheSlot = i;
+			break;
+		}
+	}
+
+	// Формируем порядок перебора
+	uint8_t order[MIFARE_CLASSIC_MAX_KEYS];
+	uint8_t orderLen = 0;
+	uint8_t cachedKey = (cacheSlot >= 0) ? mfcKeyCache[cacheSlot].keyIndex : 0xFF;
+	if (cachedKey != 0xFF)
+		order[orderLen++] = cachedKey;
+	for (uint8_t k = 0; k < mfcKeyCount; k++)
+	{
+		if (k == cachedKey)
+			continue;
+		// вставка с сохранением порядка по убыванию числа попаданий
+		uint8_t pos = orderLen;
+		while (pos > ((cachedKey != 0xFF) ? 1 : 0) && mfcKeyHits[order[pos - 1]] < mfcKeyHits[k])
+		{
+			order[pos] = order[pos - 1];
+			pos--;
+		}
+		order[pos] = k;
+		orderLen++;
+	}
+
+	uint8_t response[10];
+	for (uint8_t attempt = 0; attempt < orderLen; attempt++)
+	{
+		uint8_t k = order[attempt];
+		if (attempt > 0)
+		{
+			// Карта в HALT после неудачной аутентификации — будим её снова
+			for (int i = 0; i < 10; i++)
+				response[i] = 0;
+			if (activateTypeA(response, 1) != uidLength || memcmp(response + 3, uid, uidLength) != 0)
+				return -1;
+		}
+
+		uint8_t status = mifareClassicAuthenticate(mifareClassicSectorFirstBlock(sector), keyType, mfcKeys[k], uid, uidLength);
+		if (status == MIFARE_AUTH_FAILED)
+			continue;
+		if (status != MIFARE_AUTH_OK)
+			return -1; // таймаут или ошибка SPI — карты нет в поле
+
+		if (!mifareClassicReadSectorBlocks(sector, buffer))
+			return -1;
+
+		// Обновляем статистику; при переполнении счётчики делятся пополам (старение)
+		if (mfcKeyHits[k] == 0xFF)
+		{
+			for (uint8_t i = 0; i < mfcKeyCount; i++)
+				mfcKeyHits[i] >>= 1;
+		}
+		mfcKeyHits[k]++;
+
+		// Запоминаем ключ для UID
+		if (!cacheable)
+			return k;
+		if (cacheSlot < 0)
+		{
+			cacheSlot = mfcKeyCacheNext;
+			mfcKeyCacheNext = (mfcKeyCacheNext + 1) % MIFARE_CLASSIC_KEY_CACHE_SIZE;
+			mfcKeyCache[cacheSlot].uidHash = uidHash;
+		}
+		mfcKeyCache[cacheSlot].keyIndex = k;
+		return k;
+	}
+	return -1;
+}
+
 bool PN5180ISO14443::mifareHalt()
 {
-	uint8_t cmd[1];
+	uint8_t cmd[2];
 	// mifare Halt
 	cmd[0] = 0x50;
 	cmd[1] = 0x00;
@@ -319,14 +649,15 @@ uint8_t PN5180ISO14443::cardRead(uint8_t *buffer)
 	// Проверка на SAK == 0x20, если так — вызываем sendRATS()
 	if (response[2] == 0x20)
 	{
-		Serial.println(F("SAK == 0x20, отправка RATS..."));
-		sendRATS();
+		PN5180LOG.println(F("SAK == 0x20, отправка RATS..."));
+		if (sendRATS())
+			sendSelectAID();
 	}
 
 	// Проверяем: UID длина 7 байт, SAK = 0x00, ATQA = 0x0044
 	if (!(uidLength == 7 && response[2] == 0x00 && response[0] == 0x44 && response[1] == 0x00))
 	{
-		Serial.println(F("Это не mifare_UL_EV1"));
+		PN5180LOG.println(F("Это не mifare_UL_EV1"));
 		// mifareHalt();
 		return uidLength;
 	}
@@ -338,12 +669,12 @@ uint8_t PN5180ISO14443::cardRead(uint8_t *buffer)
 		// Проверяем, что это MIFARE Ultralight EV1 48 байт
 		if (versionData[2] != 0x03 || versionData[4] != 0x01 || versionData[6] != 0x0B)
 		{
-			Serial.println(F("Это не mifare_UL_EV1 48 кБ"));
+			PN5180LOG.println(F("Это не mifare_UL_EV1 48 кБ"));
 			return uidLength;
 		}
 	}
 
-	Serial.println(F("Обнаружена mifare_UL_EV1 48 кБ!"));
+	PN5180LOG.println(F("Обнаружена mifare_UL_EV1 48 кБ!"));
 
 	// Аутентификация PWD_AUTH
 	// uint8_t password[4] = {0xD1, 0xF7, 0x34, 0x85}; //  твой пароль
@@ -352,14 +683,14 @@ uint8_t PN5180ISO14443::cardRead(uint8_t *buffer)
 
 	if (mifare_UL_EV1_PwdAuth(password, pack_read))
 	{
-		Serial.print(F("Аутентификация прошла успешно! PACK: "));
-		Serial.print(pack_read[0], HEX);
-		Serial.print(":");
-		Serial.println(pack_read[1], HEX);
+		PN5180LOG.print(F("Аутентификация прошла успешно! PACK: "));
+		PN5180LOG.print(pack_read[0], HEX);
+		PN5180LOG.print(":");
+		PN5180LOG.println(pack_read[1], HEX);
 	}
 	else
 	{
-		Serial.println(F("Аутентификация не удалась."));
+		PN5180LOG.println(F("Аутентификация не удалась."));
 		return 0;
 	}
 
@@ -367,7 +698,7 @@ uint8_t PN5180ISO14443::cardRead(uint8_t *buffer)
 	uint8_t sig[32];
 	if (mifare_UL_EV1_ReadSig(sig))
 	{
-		Serial.println(F("Подпись успешно считана!"));
+		PN5180LOG.println(F("Подпись успешно считана!"));
 	}
 
 	// Читаем блок
@@ -377,8 +708,9 @@ uint8_t PN5180ISO14443::cardRead(uint8_t *buffer)
 	// Проверка на SAK == 0x20, если так — вызываем sendRATS()
 	if (response[2] == 0x20)
 	{
-		Serial.println(F("SAK == 0x20, отправка RATS..."));
-		sendRATS();
+		PN5180LOG.println(F("SAK == 0x20, отправка RATS..."));
+		if (sendRATS())
+			sendSelectAID();
 	}
 
 	mifareHalt();
@@ -444,7 +776,7 @@ bool PN5180ISO14443::mifare_UL_EV1_GetVersion(uint8_t *versionBuffer)
 
 	if (!sendData(&cmd, 1, 0x00))
 	{
-		Serial.println(F("Ошибка при отправке GET_VERSION"));
+		PN5180LOG.println(F("Ошибка при отправке GET_VERSION"));
 		return false;
 	}
 
@@ -453,28 +785,28 @@ bool PN5180ISO14443::mifare_UL_EV1_GetVersion(uint8_t *versionBuffer)
 	uint16_t len = rxBytesReceived();
 	if (len != 8)
 	{
-		Serial.print(F("Ожидалось 8 байт, получено: "));
-		Serial.println(len);
+		PN5180LOG.print(F("Ожидалось 8 байт, получено: "));
+		PN5180LOG.println(len);
 		return false;
 	}
 
 	if (!readData(8, versionBuffer))
 	{
-		Serial.println(F("Ошибка чтения данных GET_VERSION"));
+		PN5180LOG.println(F("Ошибка чтения данных GET_VERSION"));
 		return false;
 	}
 
-	Serial.println(F("Версия чипа (GET_VERSION):"));
+	PN5180LOG.println(F("Версия чипа (GET_VERSION):"));
 	for (int i = 0; i < 8; i++)
 	{
-		Serial.print("0x");
+		PN5180LOG.print("0x");
 		if (versionBuffer[i] < 0x10)
-			Serial.print("0");
-		Serial.print(versionBuffer[i], HEX);
+			PN5180LOG.print("0");
+		PN5180LOG.print(versionBuffer[i], HEX);
 		if (i < 7)
-			Serial.print(" ");
+			PN5180LOG.print(" ");
 	}
-	Serial.println();
+	PN5180LOG.println();
 
 	return true;
 }
@@ -486,7 +818,7 @@ bool PN5180ISO14443::mifare_UL_EV1_ReadSig(uint8_t *sigBuffer)
 	// Отправка команды
 	if (!sendData(cmd, 2, 0x00))
 	{
-		Serial.println(F("Ошибка отправки READ_SIG"));
+		PN5180LOG.println(F("Ошибка отправки READ_SIG"));
 		return false;
 	}
 
@@ -495,33 +827,82 @@ bool PN5180ISO14443::mifare_UL_EV1_ReadSig(uint8_t *sigBuffer)
 	uint16_t len = rxBytesReceived();
 	if (len != 32)
 	{
-		Serial.print(F("READ_SIG: ожидалось 32 байта, получено "));
-		Serial.println(len);
+		PN5180LOG.print(F("READ_SIG: ожидалось 32 байта, получено "));
+		PN5180LOG.println(len);
 		return false;
 	}
 
 	// Читаем данные в буфер
 	if (!readData(32, sigBuffer))
 	{
-		Serial.println(F("Ошибка чтения ECC подписи"));
+		PN5180LOG.println(F("Ошибка чтения ECC подписи"));
 		return false;
 	}
 
 	// Выводим подпись (по 16 байт на строку, как принято)
-	Serial.println(F("ECC-подпись (READ_SIG):"));
+	PN5180LOG.println(F("ECC-подпись (READ_SIG):"));
 	for (int i = 0; i < 32; i++)
 	{
 		if (sigBuffer[i] < 0x10)
-			Serial.print("0");
-		Serial.print(sigBuffer[i], HEX);
-		Serial.print(" ");
+			PN5180LOG.print("0");
+		PN5180LOG.print(sigBuffer[i], HEX);
+		PN5180LOG.print(" ");
 		if ((i + 1) % 16 == 0)
-			Serial.println();
+			PN5180LOG.println();
 	}
 
 	return true;
 }
 
+/*
+ * FAST_READ (0x3A) для Ultralight EV1 / NTAG: страницы startPage..endPage одной командой.
+ * Ответ не копируется — возвращается указатель на внутренний буфер PN5180,
+ * он действителен до следующего чтения данных из PN5180.
+ * len : количество прочитанных байт ((endPage - startPage + 1) * 4)
+ *
+ * возвращаемое значение: указатель на данные или 0 (NAK, таймаут, ошибка приёма)
+ */
+uint8_t *PN5180ISO14443::mifareUltralightFastRead(uint8_t startPage, uint8_t endPage, uint16_t *len)
+{
+	*len = 0;
+	if (endPage < startPage || endPage - startPage >= MIFARE_UL_FAST_READ_MAX_PAGES)
+		return 0;
+
+	uint8_t cmd[3] = {0x3A, startPage, endPage};
+	startRxTimeout(MIFARE_UL_RESPONSE_TIMEOUT_CYCLES);
+	if (!sendData(cmd, 3, 0x00))
+		return 0;
+
+	// NAK — 4 бита без CRC, поэтому даёт ошибку приёма или неверную длину
+	int16_t expected = (endPage - startPage + 1) * MIFARE_UL_PAGE_SIZE;
+	if (waitForRx() != expected)
+		return 0;
+	*len = expected;
+	return readData(expected);
+}
+
+/*
+ * WRITE (0xA2) одной страницы Ultralight / NTAG с проверкой ACK.
+ * ACK — 4-битный ответ без CRC, поэтому на время записи проверка RX CRC отключается.
+ */
+bool PN5180ISO14443::mifareUltralightWritePage(uint8_t page, const uint8_t *data4)
+{
+	uint8_t cmd[6] = {0xA2, page};
+	memcpy(cmd + 2, data4, MIFARE_UL_PAGE_SIZE);
+
+	if (!writeRegisterWithAndMask(CRC_RX_CONFIG, 0xFFFFFFFE))
+		return false;
+	startRxTimeout(MIFARE_UL_WRITE_TIMEOUT_CYCLES);
+	bool success = sendData(cmd, sizeof(cmd), 0x00);
+	if (success)
+	{
+		uint8_t *ack = (waitForRx() > 0) ? readData(1) : 0;
+		success = (ack != 0) && ((ack[0] & 0x0F) == MIFARE_UL_ACK);
+	}
+	writeRegisterWithOrMask(CRC_RX_CONFIG, 0x01);
+	return success;
+}
+
 bool PN5180ISO14443::mifare_UL_EV1_PwdAuth(uint8_t *pwd, uint8_t *pack)
 {
 	uint8_t cmd[5];
@@ -532,18 +913,18 @@ bool PN5180ISO14443::mifare_UL_EV1_PwdAuth(uint8_t *pwd, uint8_t *pack)
 	cmd[0] = 0x1B;
 	memcpy(&cmd[1], pwd, 4);
 
-	Serial.print(F("Отправка PWD_AUTH: "));
+	PN5180LOG.print(F("Отправка PWD_AUTH: "));
 	for (int i = 0; i < 5; i++)
 	{
-		Serial.print(cmd[i], HEX);
-		Serial.print(" ");
+		PN5180LOG.print(cmd[i], HEX);
+		PN5180LOG.print(" ");
 	}
-	Serial.println();
+	PN5180LOG.println();
 
 	// Отправляем команду на карту
 	if (!sendData(cmd, 5, 0x00))
 	{
-		Serial.println(F("Ошибка отправки PWD_AUTH"));
+		PN5180LOG.println(F("Ошибка отправки PWD_AUTH"));
 		return false;
 	}
 
@@ -552,15 +933,15 @@ bool PN5180ISO14443::mifare_UL_EV1_PwdAuth(uint8_t *pwd, uint8_t *pack)
 	len = rxBytesReceived();
 	if (len != 2)
 	{
-		Serial.print(F("Ошибка: ожидалось 2 байта PACK, получено: "));
-		Serial.println(len);
+		PN5180LOG.print(F("Ошибка: ожидалось 2 байта PACK, получено: "));
+		PN5180LOG.println(len);
 		return false;
 	}
 
 	// Читаем PACK
 	if (!readData(2, response))
 	{
-		Serial.println(F("Ошибка чтения PACK после PWD_AUTH"));
+		PN5180LOG.println(F("Ошибка чтения PACK после PWD_AUTH"));
 		return false;
 	}
 
@@ -568,195 +949,646 @@ bool PN5180ISO14443::mifare_UL_EV1_PwdAuth(uint8_t *pwd, uint8_t *pack)
 	pack[0] = response[0];
 	pack[1] = response[1];
 
-	Serial.print(F("PACK: "));
-	Serial.print(pack[0], HEX);
-	Serial.print(" ");
-	Serial.println(pack[1], HEX);
+	PN5180LOG.print(F("PACK: "));
+	PN5180LOG.print(pack[0], HEX);
+	PN5180LOG.print(" ");
+	PN5180LOG.println(pack[1], HEX);
 
 	return true;
 }
 
-void PN5180ISO14443::sendRATS()
+/*
+ * Активация карты ISO14443 Type B (ISO14443-3, раздел 7) с переходом в ISO-DEP.
+ * 1. REQB/WUPB с одним слотом; при коллизии — повтор с 2, 4, 8, 16 слотами,
+ *    слоты 1..N-1 открываются Slot-MARKER (APn = номер слота << 4 | 5).
+ * 2. Из первой ATQB без ошибок берутся PUPI и Protocol Info (FSCI, FWI, поддержка CID/NAD).
+ * 3. ATTRIB с FSD из ISODEP_FSDI (256, на AVR 128), скоростью 106 кбит/с и CID; ответ — MBLI | CID.
+ * После этого карта обслуживается тем же exchange(), что и Type A после sendRATS().
+ * RF-конфигурация Type B загружается, только если активна другая.
+ * atqb : 11 байт — PUPI(4), Application Data(4), Protocol Info(3)
+ * kind : 0 — REQB, 1 — WUPB (будит и карты в состоянии HALT)
+ * cid  : логический номер карты (0..14)
+ *
+ * возвращаемое значение: true — карта активирована, сессия ISO-DEP открыта
+ */
+bool PN5180ISO14443::activateTypeB(uint8_t *atqb, uint8_t kind, uint8_t cid)
 {
-	uint8_t rats[] = {0xE0, 0x50}; // RATS: FSDI=8, CID=0; FSDI=8 - максимальный запрашиваемый ответ от карты - 256 байт, 5 это 64 байта
+	isoDepActive = false;
+	if (!switchRFConfig(ISO14443B_TX_CONFIG_106, ISO14443B_RX_CONFIG_106))
+		return false;
 
-	Serial.println(F("Отправляем RATS..."));
-	if (!sendData(rats, sizeof(rats), 0))
+	bool found = false;
+	for (uint8_t n = 0; n <= 4 && !found; n++)
 	{
-		Serial.println(F("Ошибка при отправке RATS"));
-		return;
+		uint8_t slots = 1 << n;
+		bool collision = false;
+		for (uint8_t slot = 0; slot < slots; slot++)
+		{
+			uint8_t cmd[3];
+			uint8_t cmdLen;
+			if (slot == 0)
+			{
+				// APf = 05, AFI = 00 (все приложения), PARAM: бит 3 — WUPB, биты 2..0 — N
+				cmd[0] = 0x05;
+				cmd[1] = 0x00;
+				cmd[2] = (kind ? 0x08 : 0x00) | n;
+				cmdLen = 3;
+			}
+			else
+			{
+				cmd[0] = (slot << 4) | 0x05; // Slot-MARKER
+				cmdLen = 1;
+			}
+
+			startRxTimeout(ISO14443B_FWT_ATQB_CYCLES);
+			if (!sendData(cmd, cmdLen, 0))
+				return false;
+			int16_t len = waitForRx();
+			if (len < 0)
+			{
+				collision = true;
+				continue;
+			}
+			if (len < 1 + ISO14443B_ATQB_LEN)
+				continue;
+			uint8_t *data = readData(len);
+			if (data != 0 && data[0] == 0x50)
+			{
+				memcpy(atqb, data + 1, ISO14443B_ATQB_LEN);
+				found = true;
+				break;
+			}
+		}
+		if (!collision)
+			break;
 	}
+	if (!found)
+		return false;
 
-	delay(4);
-	uint8_t ats[32];
-	uint8_t fwt_ats; // Таймаут ответа (Frame Waiting Time) из ATS
-	int len = rxBytesReceived();
-	if (len > 0 && static_cast<size_t>(len) <= sizeof(ats))
+	// Protocol Info: [0] скорости, [1] FSCI | тип протокола, [2] FWI | ADC | FO
+	uint8_t *protInfo = atqb + 8;
+	if (!(protInfo[1] & 0x01))
 	{
-		readData(len, ats);
-		fwt_ats = ats[3]; // Получаем FWT из ATS, 4-й байт (индекс 3)
-		Serial.print(F("ATS: "));
-		for (int i = 0; i < len; i++)
+		PN5180DEBUG(F("Type B: card is not ISO14443-4 compliant\n"));
+		return false;
+	}
+	memset(&ats, 0, sizeof(ats));
+	ats.fsci = protInfo[1] >> 4;
+	ats.fsc = isoDepFrameSize(ats.fsci);
+	ats.fwi = protInfo[2] >> 4;
+	if (ats.fwi > 14)
+		ats.fwi = 4;
+	isoDepFwi = ats.fwi;
+	isoDepFsc = ats.fsc;
+
+	// ATTRIB: 1D, PUPI, Param1 (TR0/TR1 по умолчанию), Param2 (106 кбит/с, FSDI), Param3 (ISO14443-4), Param4 (CID)
+	uint8_t attrib[9] = {0x1D, atqb[0], atqb[1], atqb[2], atqb[3], 0x00, ISODEP_FSDI, 0x01, (uint8_t)(cid & 0x0F)};
+	startRxTimeout((ISODEP_FWT_BASE_CYCLES << isoDepFwi) + ISODEP_FWT_DELTA_CYCLES);
+	if (!sendData(attrib, sizeof(attrib), 0))
+		return false;
+	int16_t len = waitForRx();
+	if (len < 1)
+		return false;
+	uint8_t *answer = readData(len);
+	if (answer == 0 || (answer[0] & 0x0F) != (cid & 0x0F))
+		return false;
+
+	isoDepCidEnabled = (protInfo[2] & 0x01) != 0;
+	isoDepCid = cid & 0x0F;
+	if (!(protInfo[2] & 0x02))
+		isoDepNadEnabled = false;
+	isoDepBlockNumber = 0;
+	isoDepActive = true;
+	return true;
+}
+
+/*
+ * Разбор ATS (ISO14443-4, 5.2):
+ * TL | T0 | [TA(1)] | [TB(1)] | [TC(1)] | исторические байты
+ * T0: бит 4 — есть TA, бит 5 — есть TB, бит 6 — есть TC, младший полубайт — FSCI
+ * TA(1): поддерживаемые скорости DS/DR
+ * TB(1): FWI (старший полубайт), SFGI (младший полубайт)
+ * TC(1): бит 0 — поддержка NAD, бит 1 — поддержка CID
+ * Отсутствующие поля получают значения по умолчанию стандарта.
+ *
+ * возвращаемое значение: false — ATS повреждён
+ */
+bool PN5180ISO14443::parseATS(const uint8_t *data, uint8_t len, PN5180ATS *ats)
+{
+	memset(ats, 0, sizeof(PN5180ATS));
+	ats->fsci = 2; // FSC = 32 байта
+	ats->fwi = 4;
+	ats->tc = 0x02; // по умолчанию CID поддерживается, NAD — нет
+
+	if (len < 1 || data[0] != len)
+		return false;
+	ats->tl = data[0];
+	uint8_t pos = 1;
+	if (len > 1)
+	{
+		ats->t0 = data[pos++];
+		ats->fsci = ats->t0 & 0x0F;
+		if (ats->t0 & 0x10)
+		{
+			if (pos >= len)
+				return false;
+			ats->ta = data[pos++];
+		}
+		if (ats->t0 & 0x20)
+		{
+			if (pos >= len)
+				return false;
+			ats->tb = data[pos++];
+			ats->fwi = ats->tb >> 4;
+			ats->sfgi = ats->tb & 0x0F;
+		}
+		if (ats->t0 & 0x40)
 		{
-			Serial.print(ats[i], HEX);
-			Serial.print(" ");
+			if (pos >= len)
+				return false;
+			ats->tc = data[pos++];
 		}
-		Serial.println();
-		// delay(3);
-		sendSelectAID(fwt_ats);
 	}
-	else
+	if (ats->fwi > 14) // значение 15 зарезервировано
+		ats->fwi = 4;
+	if (ats->sfgi > 14)
+		ats->sfgi = 0;
+	ats->fsc = isoDepFrameSize(ats->fsci);
+
+	ats->historicalLen = len - pos;
+	uint8_t copyLen = (ats->historicalLen > sizeof(ats->historical)) ? sizeof(ats->historical) : ats->historicalLen;
+	memcpy(ats->historical, data + pos, copyLen);
+	return true;
+}
+
+/*
+ * RATS (Request for Answer To Select) — переход карты в режим ISO14443-4 (ISO-DEP).
+ * cid : логический номер карты (0..14). Если карта поддерживает CID (TC(1), бит 1),
+ *       он будет передаваться в каждом блоке.
+ * В RATS объявляется FSD из ISODEP_FSDI (256 байт, на AVR 128 — по PN5180_READ_BUFFER_SIZE):
+ * ответные кадры читаются прямо из буфера приёма.
+ * После успешного ATS состояние ISO-DEP сбрасывается: номер блока 0, FSC, FWI и SFGI из ATS.
+ * Перед возвратом выдерживается SFGT, если карта его запросила.
+ *
+ * возвращаемое значение: true — карта ответила ATS, можно вызывать exchange()
+ */
+bool PN5180ISO14443::sendRATS(uint8_t cid)
+{
+	// RATS: FSDI в старшем полубайте, CID в младшем
+	uint8_t rats[] = {0xE0, (uint8_t)((ISODEP_FSDI << 4) | (cid & 0x0F))};
+
+	isoDepActive = false;
+	PN5180LOG.println(F("Отправляем RATS..."));
+	// FWT активации — 65536/fc ≈ 4,8 мс
+	startRxTimeout(ISODEP_FWT_ACTIVATION_CYCLES + ISODEP_FWT_DELTA_CYCLES);
+	if (!sendData(rats, sizeof(rats), 0))
+	{
+		PN5180LOG.println(F("Ошибка при отправке RATS"));
+		return false;
+	}
+
+	int16_t len = waitForRx();
+	if (len <= 0)
+	{
+		PN5180LOG.println(F("Не получили ATS или ошибка чтения"));
+		return false;
+	}
+
+	uint8_t *data = readData(len);
+	if (data == 0 || !parseATS(data, len, &ats))
+	{
+		PN5180LOG.println(F("Некорректный ATS"));
+		return false;
+	}
+
+	PN5180LOG.print(F("ATS: "));
+	for (int i = 0; i < len; i++)
 	{
-		Serial.println(F("Не получили ATS или ошибка чтения"));
+		PN5180LOG.print(data[i], HEX);
+		PN5180LOG.print(" ");
 	}
+	PN5180LOG.println();
+
+	isoDepFwi = ats.fwi;
+	isoDepFsc = ats.fsc;
+	isoDepCidEnabled = (ats.tc & 0x02) != 0;
+	isoDepCid = cid & 0x0F;
+	if (!(ats.tc & 0x01))
+		isoDepNadEnabled = false;
+	isoDepBlockNumber = 0;
+	isoDepActive = true;
+
+	// SFGT = (4096 + 384) / fc * 2^SFGI (с дельтой), SFGI = 0 — ожидание не требуется
+	if (ats.sfgi > 0)
+	{
+		uint32_t sfgtUs = (ISODEP_FWT_BASE_US + ISODEP_SFGT_DELTA_US) << ats.sfgi;
+		delay(sfgtUs / 1000UL);
+		delayMicroseconds(sfgtUs % 1000UL);
+	}
+	return true;
 }
 
-// Отправляет команду SELECT AID для NFC Forum
-void PN5180ISO14443::sendSelectAID(uint8_t fwt_ats)
+// Возвращает результат последнего разбора ATS
+const PN5180ATS &PN5180ISO14443::getATS() const
 {
-	// uint8_t selectNfcForum[] = {
-	// 	0x00, 0xA4, 0x04, 0x00,
-	// 	0x07, 0xD2, 0x76, 0x00,
-	// 	0x00, 0x85, 0x01, 0x01,
-	// 	0x00};
+	return ats;
+}
 
-	// Новый собственный AID — F0 12 34 56 78
-	uint8_t selectNfcForum[] = {
-		0x00, 0xA4, 0x04, 0x00,		  // SELECT by AID
-		0x05,						  // длина AID = 5 байт
-		0xF0, 0x12, 0x34, 0x56, 0x78, // AID: F0 12 34 56 78
-		0x00						  // Le = 0,  ожидаем ответа максимально возможной длины (256 байт)
-	};
+/*
+ * PPS (Protocol and Parameter Selection, ISO14443-4, 5.3) — повышение скорости обмена.
+ * Вызывается сразу после sendRATS(), до первого exchange().
+ * Из TA(1) выбирается наибольшая общая скорость, не превышающая maxBitRate:
+ *   TA(1): бит 7 — только одинаковые скорости в обе стороны,
+ *          биты 6..4 — DS (карта -> считыватель) 848/424/212,
+ *          биты 2..0 — DR (считыватель -> карта) 848/424/212.
+ * После ответа карты PN5180 переключается на RF-конфигурации ISO14443A выбранной скорости
+ * (TX 0x00..0x03, RX 0x80..0x83).
+ * Если карта не поддерживает повышение скорости или не ответила на PPS, обмен
+ * продолжается на 106 кбит/с.
+ * maxBitRate : ISO14443_BITRATE_106 .. ISO14443_BITRATE_848
+ *
+ * возвращаемое значение: установленная скорость (ISO14443_BITRATE_xxx)
+ */
+uint8_t PN5180ISO14443::sendPPS(uint8_t maxBitRate)
+{
+	if (!isoDepActive || !(ats.t0 & 0x10) || maxBitRate == ISO14443_BITRATE_106)
+		return ISO14443_BITRATE_106;
+
+	// Выбираем максимальные DSI (карта -> считыватель) и DRI (считыватель -> карта).
+	// Бит 8: карта поддерживает только одинаковую скорость в обе стороны —
+	// тогда берётся наибольший делитель, заявленный и в DS, и в DR.
+	bool sameRate = ats.ta & 0x80;
+	uint8_t dsi = 0;
+	uint8_t dri = 0;
+	for (uint8_t i = (maxBitRate > ISO14443_BITRATE_848) ? ISO14443_BITRATE_848 : maxBitRate; i > 0; i--)
+	{
+		bool ds = ats.ta & (0x08 << i);
+		bool dr = ats.ta & (0x01 << (i - 1));
+		if (sameRate)
+			ds = dr = ds && dr;
+		if (dsi == 0 && ds)
+			dsi = i;
+		if (dri == 0 && dr)
+			dri = i;
+	}
+	if (dsi == 0 && dri == 0)
+		return ISO14443_BITRATE_106;
+
+	// PPSS (D0 | CID), PPS0 = 0x11 — присутствует PPS1, PPS1 = DSI << 2 | DRI
+	uint8_t pps[3] = {(uint8_t)(0xD0 | isoDepCid), 0x11, (uint8_t)((dsi << 2) | dri)};
+	uint8_t *rx = 0;
+	int16_t len = isoDepTransceiveBlock(pps, sizeof(pps), 0, &rx);
+	if (len != 1 || rx[0] != pps[0])
+	{
+		PN5180LOG.println(F("PPS не принят, остаёмся на 106 кбит/с"));
+		return ISO14443_BITRATE_106;
+	}
 
-	// Формируем I-Block: PCB (0x02) + APDU. Важное замечание: каждый I-Block должен чередоваться, сначала 0х02, потом 0x03, потом опять 0х02 и так далее, иначе будем получать данные из кэша.
-	uint8_t iblock[1 + sizeof(selectNfcForum)];
-	iblock[0] = 0x02; // PCB для I-Block
-	memcpy(&iblock[1], selectNfcForum, sizeof(selectNfcForum));
+	// Карта уже работает на новой скорости — переключаем передатчик и приёмник
+	if (!loadRFConfig(ISO14443A_TX_CONFIG_106 + dri, ISO14443A_RX_CONFIG_106 + dsi) ||
+		!writeRegisterWithOrMask(CRC_RX_CONFIG, 0x01) ||
+		!writeRegisterWithOrMask(CRC_TX_CONFIG, 0x01))
+	{
+		PN5180LOG.println(F("Ошибка загрузки RF-конфигурации для PPS"));
+		return ISO14443_BITRATE_106;
+	}
 
-	// Вычисляем абсолютное значение FWT по формуле:
-	// FWT = (256 * 16 / fc) * 2^FWI
-	// fc = 13.56 МГц
-	uint8_t FWI = fwt_ats & 0x0F;
-	uint32_t base = (256UL * 16UL * 1000UL) / 13560UL; // ≈ 0.2234 мс
-	uint32_t FWT_ms = base * (1UL << FWI);
-	Serial.print(F("FWT (ms): "));
-	Serial.println(FWT_ms);
+	PN5180LOG.print(F("PPS: DSI="));
+	PN5180LOG.print(dsi);
+	PN5180LOG.print(F(", DRI="));
+	PN5180LOG.println(dri);
+	return (dsi < dri) ? dsi : dri;
+}
 
-	Serial.println(F("Отправляем SELECT AID (I-Block)"));
-	if (!sendData(iblock, sizeof(iblock), 0))
+/*
+ * Включает/выключает передачу NAD (Node Address) в I-блоках.
+ * Действует только если карта заявила поддержку NAD в ATS; вызывать после sendRATS().
+ */
+void PN5180ISO14443::isoDepSetNAD(bool enabled, uint8_t nad)
+{
+	isoDepNadEnabled = enabled;
+	isoDepNad = nad;
+}
+
+/*
+ * Отправляет один блок ISO-DEP и принимает ответный блок.
+ * Ожидание ответа ограничено точным FWT (или FWT * WTXM), отсчитываемым TIMER1.
+ * wtxm : множитель FWT из последнего S(WTX), 0 — без продления
+ * rx   : указатель на принятый блок (внутренний буфер PN5180, действителен до следующего readData)
+ *
+ * возвращаемое значение: длина принятого блока, 0 — таймаут, -1 — ошибка
+ */
+int16_t PN5180ISO14443::isoDepTransceiveBlock(uint8_t *frame, uint16_t frameLen, uint8_t wtxm, uint8_t **rx)
+{
+	// FWT = 4096/fc * 2^FWI, после S(WTX) — в WTXM раз больше (не более 59 * 2^14 * 4096 циклов)
+	uint32_t fwtCycles = ISODEP_FWT_BASE_CYCLES << isoDepFwi;
+	if (wtxm > 0)
+		fwtCycles *= wtxm;
+	fwtCycles += ISODEP_FWT_DELTA_CYCLES;
+
+	// Таймаут отсчитывает TIMER1 в PN5180 с момента окончания передачи
+	if (!startRxTimeout(fwtCycles))
+		return -1;
+	if (!sendData(frame, frameLen, 0))
+		return -1;
+
+	int16_t len = waitForRx();
+	if (len <= 0)
+		return len;
+
+	*rx = readData(len);
+	if (*rx == 0)
+		return -1;
+	return len;
+}
+
+/*
+ * Заголовок блока ISO-DEP: PCB, затем CID (если включён) и NAD (если нужен).
+ * возвращаемое значение: длина заголовка
+ */
+uint8_t PN5180ISO14443::isoDepBuildHeader(uint8_t *frame, uint8_t pcb, bool withNad)
+{
+	uint8_t len = 1;
+	if (isoDepCidEnabled)
 	{
-		Serial.println(F("Ошибка при отправке SELECT AID"));
-		return;
+		pcb |= ISODEP_PCB_CID_FOLLOWING;
+		frame[len++] = isoDepCid;
 	}
-
-	uint8_t response[32];
-	int len = 0;
-	uint32_t start = millis();
-	while ((len = rxBytesReceived()) == 0 && (millis() - start) < FWT_ms)
+	if (withNad)
 	{
-		delay(5);
+		pcb |= ISODEP_PCB_NAD_FOLLOWING;
+		frame[len++] = isoDepNad;
 	}
+	frame[0] = pcb;
+	return len;
+}
+
+/*
+ * Формирует очередной I-блок из APDU, начиная с позиции *txPos.
+ * Если остаток APDU не помещается в кадр карты (FSC) или в локальный буфер,
+ * устанавливается бит сцепления. NAD передаётся только в первом блоке цепочки (7.1.1.3).
+ *
+ * возвращаемое значение: длина блока
+ */
+uint16_t PN5180ISO14443::isoDepBuildIBlock(uint8_t *frame, const uint8_t *apdu, uint32_t apduLen, uint32_t *txPos)
+{
+	bool withNad = isoDepNadEnabled && (*txPos == 0);
+	uint8_t hdrLen = isoDepBuildHeader(frame, ISODEP_PCB_I_BLOCK | isoDepBlockNumber, withNad);
+
+	// FSC включает 2 байта CRC
+	uint16_t frameMax = isoDepFsc - 2;
+	if (frameMax > ISODEP_TX_BUFFER_SIZE)
+		frameMax = ISODEP_TX_BUFFER_SIZE;
+	uint16_t infMax = frameMax - hdrLen;
+
+	uint32_t remaining = apduLen - *txPos;
+	uint16_t infLen = (remaining > infMax) ? infMax : (uint16_t)remaining;
+	if (remaining > infMax)
+		frame[0] |= ISODEP_PCB_CHAINING;
+
+	memcpy(frame + hdrLen, apdu + *txPos, infLen);
+	*txPos += infLen;
+	return hdrLen + infLen;
+}
+
+// true — карта активирована (sendRATS или activateTypeB) и сессия ISO-DEP не закрыта
+bool PN5180ISO14443::isIsoDepActive() const
+{
+	return isoDepActive;
+}
+
+// Приёмник данных для exchange() в буфер вызывающего
+struct IsoDepBufferSink
+{
+	uint8_t *buffer;
+	uint16_t size;
+	uint16_t len;
+};
 
-	if (len > 0 && static_cast<size_t>(len) <= sizeof(response))
+static bool isoDepBufferSink(const uint8_t *data, uint16_t len, void *context)
+{
+	IsoDepBufferSink *sink = (IsoDepBufferSink *)context;
+	if ((uint32_t)sink->len + len > sink->size)
+		return false;
+	memcpy(sink->buffer + sink->len, data, len);
+	sink->len += len;
+	return true;
+}
+
+/*
+ * Обмен APDU по протоколу ISO14443-4 (ISO-DEP), аналог phpalI14443p4_Exchange из NXP NfcRdLib.
+ * Выполняет:
+ * -	чередование номера блока (правила A и B ISO14443-4, 7.5.3);
+ * -	сцепление I-блоков при передаче (кадры не больше FSC карты) и при приёме
+ *		(подтверждение R(ACK) каждого блока цепочки);
+ * -	R(NAK) при таймауте или ошибке приёма (R(ACK) во время приёма цепочки), повтор
+ *		последнего I-блока при R(ACK) с чужим номером блока — не более ISODEP_MAX_RETRIES
+ *		раз подряд (правила 4, 5 и 6);
+ * -	ответ на S(WTX) с тем же WTXM и продление следующего FWT в WTXM раз;
+ * -	CID и NAD по результату sendRATS()/isoDepSetNAD().
+ * Ответ карты не собирается в памяти: INF каждого принятого блока передаётся в sink
+ * прямо из буфера приёма PN5180. Так APDU и ответы extended length (до 64 КБ) проходят
+ * за один вызов без больших буферов.
+ * apdu    : команда
+ * sink    : приёмник фрагментов ответа; вернув false, прерывает обмен
+ * respLen : если не 0 — общая длина ответа (включая SW1 SW2)
+ *
+ * возвращаемое значение: true — ответ получен полностью
+ */
+bool PN5180ISO14443::exchange(const uint8_t *apdu, uint32_t apduLen, PN5180DataSink sink, void *context, uint32_t *respLen)
+{
+	if (respLen)
+		*respLen = 0;
+	if (!isoDepActive)
+		return false;
+
+	uint8_t iBlock[ISODEP_TX_BUFFER_SIZE];
+	uint8_t ctrlBlock[3]; // R- и S-блоки: PCB [CID] [WTXM]
+	uint32_t txPos = 0;
+	uint16_t iBlockLen = isoDepBuildIBlock(iBlock, apdu, apduLen, &txPos);
+
+	uint8_t *txFrame = iBlock;
+	uint16_t txLen = iBlockLen;
+	uint32_t total = 0;
+	bool rxChaining = false;
+	uint8_t wtxm = 0;
+	uint8_t retries = 0;
+
+	for (;;)
 	{
-		readData(len, response);
+		uint8_t *rx = 0;
+		int16_t len = isoDepTransceiveBlock(txFrame, txLen, wtxm, &rx);
+		wtxm = 0;
 
-		Serial.print(F("Ответ на SELECT AID: "));
-		for (int i = 0; i < len; i++)
+		if (len <= 0)
 		{
-			if (response[i] < 0x10)
-				Serial.print("0");
-			Serial.print(response[i], HEX);
-			Serial.print(" ");
+			if (retries++ >= ISODEP_MAX_RETRIES)
+			{
+				PN5180DEBUG(F("ISO-DEP: no valid answer, giving up\n"));
+				return false;
+			}
+			// Правило 5: при приёме цепочки — R(ACK), иначе правило 4: R(NAK)
+			uint8_t pcb = rxChaining ? ISODEP_PCB_R_ACK : ISODEP_PCB_R_NAK;
+			txLen = isoDepBuildHeader(ctrlBlock, pcb | isoDepBlockNumber, false);
+			txFrame = ctrlBlock;
+			continue;
 		}
-		Serial.println();
 
-		if (len >= 3 && response[len - 2] == 0x6A && response[len - 1] == 0x82)
+		uint8_t pcb = rx[0];
+		uint8_t pos = 1;
+		if (pcb & ISODEP_PCB_CID_FOLLOWING)
+			pos++;
+
+		if ((pcb & 0xE2) == ISODEP_PCB_I_BLOCK)
 		{
-			Serial.println(F("разблокируйте телефон"));
-			return;
+			if (pcb & ISODEP_PCB_NAD_FOLLOWING)
+				pos++;
+			// I-блок до окончания нашей цепочки или с чужим номером — нарушение протокола
+			if (txPos < apduLen || (pcb & ISODEP_PCB_BLOCK_NUMBER) != isoDepBlockNumber || pos > len)
+			{
+				PN5180DEBUG(F("ISO-DEP: unexpected I-block\n"));
+				return false;
+			}
+			// Правило B: получен I-блок с текущим номером — переключаем номер блока
+			isoDepBlockNumber ^= ISODEP_PCB_BLOCK_NUMBER;
+			uint16_t infLen = len - pos;
+			if (infLen > 0 && !sink(rx + pos, infLen, context))
+				return false;
+			total += infLen;
+			if (respLen)
+				*respLen = total;
+
+			if (!(pcb & ISODEP_PCB_CHAINING))
+				return true;
+
+			// Карта продолжает цепочку — подтверждаем блок
+			rxChaining = true;
+			txLen = isoDepBuildHeader(ctrlBlock, ISODEP_PCB_R_ACK | isoDepBlockNumber, false);
+			txFrame = ctrlBlock;
+			retries = 0;
 		}
-
-		// Проверка: если первый байт ответа F2
-		if (len >= 1 && response[0] == 0xF2)
+		else if ((pcb & 0xE6) == ISODEP_PCB_R_ACK)
 		{
-			Serial.println(F("Ответ карты F2 отправлен обратно."));
-			if (!sendWaitAWhile(response, len)) {
-				return; 
+			// Карта не отправляет R(NAK)
+			if (pcb & ISODEP_PCB_R_NAK_BIT)
+			{
+				PN5180DEBUG(F("ISO-DEP: unexpected R(NAK)\n"));
+				return false;
+			}
+			if ((pcb & ISODEP_PCB_BLOCK_NUMBER) == isoDepBlockNumber)
+			{
+				// Подтверждение нашего блока цепочки — передаём следующий
+				if (!(iBlock[0] & ISODEP_PCB_CHAINING) || rxChaining)
+				{
+					PN5180DEBUG(F("ISO-DEP: unexpected R(ACK)\n"));
+					return false;
+				}
+				isoDepBlockNumber ^= ISODEP_PCB_BLOCK_NUMBER;
+				iBlockLen = isoDepBuildIBlock(iBlock, apdu, apduLen, &txPos);
+				retries = 0;
 			}
+			else if (retries++ >= ISODEP_MAX_RETRIES)
+			{
+				return false;
+			}
+			// Правило 6: R(ACK) с другим номером — повторяем последний I-блок
+			txFrame = iBlock;
+			txLen = iBlockLen;
+		}
+		else if ((pcb & 0xF7) == ISODEP_PCB_S_WTX && len > pos)
+		{
+			// S(WTX): подтверждаем тем же WTXM (1..59) и ждём дольше
+			wtxm = rx[pos] & 0x3F;
+			if (wtxm == 0)
+				wtxm = 1;
+			else if (wtxm > 59)
+				wtxm = 59;
+			uint8_t n = isoDepBuildHeader(ctrlBlock, ISODEP_PCB_S_WTX, false);
+			ctrlBlock[n++] = wtxm;
+			txFrame = ctrlBlock;
+			txLen = n;
+			retries = 0;
+		}
+		else
+		{
+			PN5180DEBUG(F("ISO-DEP: invalid block\n"));
+			return false;
 		}
-
 	}
-	else
+}
+
+/*
+ * Обмен APDU с ответом в буфер вызывающего.
+ * respLen : на входе — размер resp, на выходе — длина ответа (включая SW1 SW2)
+ *
+ * возвращаемое значение: true — ответ получен и поместился в resp
+ */
+bool PN5180ISO14443::exchange(const uint8_t *apdu, uint16_t apduLen, uint8_t *resp, uint16_t *respLen)
+{
+	IsoDepBufferSink sink = {resp, *respLen, 0};
+	bool success = exchange(apdu, apduLen, isoDepBufferSink, &sink);
+	*respLen = sink.len;
+	return success;
+}
+
+/*
+ * S(DESELECT): переводит карту в состояние HALT и завершает сессию ISO-DEP.
+ * При отсутствии ответа запрос повторяется ISODEP_MAX_RETRIES раз (правило 8).
+ */
+bool PN5180ISO14443::deselect()
+{
+	if (!isoDepActive)
+		return false;
+	isoDepActive = false;
+
+	uint8_t frame[2];
+	uint8_t frameLen = isoDepBuildHeader(frame, ISODEP_PCB_S_DESELECT, false);
+	for (uint8_t attempt = 0; attempt <= ISODEP_MAX_RETRIES; attempt++)
 	{
-		Serial.println(F("Не получили ответ на SELECT AID"));
-	}
-	return;
-
-}
-
-
-// Обработка ответа карты F2 (F2 означает: Повторите попытку позже, мне нужно больше времени, чтобы ответить)
-
-bool PN5180ISO14443::sendWaitAWhile(uint8_t* response, size_t len)
-{
-    uint8_t reply[32];
-    int replyLen = 0;
-    uint32_t timeout = 350; // мс, можно увеличить при необходимости
-    int attempts = 0;
-
-    while (attempts < 3)
-    {
-        // Отправляем полученный ответ обратно на карту
-        if (!sendData(response, len, 0))
-        {
-            Serial.println(F("Ошибка при отправке ответа карты обратно F2"));
-            return false;
-        }
-
-        // Ждём новый ответ от карты
-        replyLen = 0;
-        uint32_t start = millis();
-        while ((replyLen = rxBytesReceived()) == 0 && (millis() - start) < timeout)
-        {
-            delay(5);
-        }
-
-        if (replyLen > 0 && static_cast<size_t>(replyLen) <= sizeof(reply))
-        {
-            readData(replyLen, reply);
-            Serial.print(F("Ответ карты на F2: "));
-            for (int i = 0; i < replyLen; i++)
-            {
-                if (reply[i] < 0x10)
-                    Serial.print("0");
-                Serial.print(reply[i], HEX);
-                Serial.print(" ");
-            }
-            Serial.println();
-
-            // Если первый байт снова F2, повторяем, иначе выходим
-            if (reply[0] == 0xF2)
-            {
-                attempts++;
-                memcpy(response, reply, replyLen);
-                len = replyLen;
-                continue;
-            }
-            else
-            {
-                // Получен нормальный ответ, выходим
-                return true;
-            }
-        }
-        else
-        {
-            Serial.println(F("Нет ответа на F2"));
-            return false;
-        }
-    }
-    // Если три попытки не дали результата
-    return false;
+		uint8_t *rx = 0;
+		int16_t len = isoDepTransceiveBlock(frame, frameLen, 0, &rx);
+		if (len > 0 && (rx[0] & 0xF7) == ISODEP_PCB_S_DESELECT)
+			return true;
+	}
+	return false;
 }
 
+// Отправляет команду SELECT AID через exchange() и печатает ответ
+bool PN5180ISO14443::sendSelectAID()
+{
+	// NDEF-приложение NFC Forum (D2 76 00 00 85 01 01) читает PN5180NDEFType4
+
+	// Новый собственный AID — F0 12 34 56 78
+	uint8_t selectNfcForum[] = {
+		0x00, 0xA4, 0x04, 0x00,		  // SELECT by AID
+		0x05,						  // длина AID = 5 байт
+		0xF0, 0x12, 0x34, 0x56, 0x78, // AID: F0 12 34 56 78
+		0x00						  // Le = 0,  ожидаем ответа максимально возможной длины (256 байт)
+	};
+
+	PN5180LOG.println(F("Отправляем SELECT AID (I-Block)"));
+	uint8_t response[64];
+	uint16_t len = sizeof(response);
+	if (!exchange(selectNfcForum, sizeof(selectNfcForum), response, &len))
+	{
+		PN5180LOG.println(F("Не получили ответ на SELECT AID"));
+		return false;
+	}
 
+	PN5180LOG.print(F("Ответ на SELECT AID: "));
+	for (int i = 0; i < len; i++)
+	{
+		if (response[i] < 0x10)
+			PN5180LOG.print("0");
+		PN5180LOG.print(response[i], HEX);
+		PN5180LOG.print(" ");
+	}
+	PN5180LOG.println();
+
+	if (len >= 2 && response[len - 2] == 0x6A && response[len - 1] == 0x82)
+	{
+		PN5180LOG.println(F("разблокируйте телефон"));
+		return false;
+	}
+	return len >= 2 && response[len - 2] == 0x90 && response[len - 1] == 0x00;
+}
@@ -0,0 +1,272 @@
+// NAME: PN5180ISO14443Session.cpp
+//
+// DESC: Постоянная сессия ISO14443-4 (ISO-DEP) с пакетами APDU.
+//
+// Этот файл является частью библиотеки PN5180 для среды Arduino.
+//
+// Эта библиотека является свободным программным обеспечением; вы можете распространять и/или
+// изменять её на условиях Стандартной Общественной Лицензии GNU (LGPL) версии 2.1
+// либо (по вашему выбору) любой более поздней версии.
+//
+// Эта библиотека распространяется в надежде, что она будет полезной,
+// но БЕЗ КАКИХ-ЛИБО ГАРАНТИЙ; даже без подразумеваемой гарантии
+// КОММЕРЧЕСКОЙ ЦЕННОСТИ или ПРИГОДНОСТИ ДЛЯ ОПРЕДЕЛЕННОЙ ЦЕЛИ. Подробнее см. в
+// Стандартной Общественной Лицензии GNU.
+//
+// #define DEBUG 1
+
+#include <Arduino.h>
+#include "PN5180ISO14443Session.h"
+#include "Debug.h"
+
+PN5180ISO14443Session::PN5180ISO14443Session(PN5180ISO14443 &nfc)
+	: nfc(nfc)
+{
+	opened = false;
+	bitRate = ISO14443_BITRATE_106;
+	lastSW = 0;
+	hceAid = 0;
+	hceAidLen = 0;
+	hcePending = false;
+	resetHceStats();
+}
+
+/*
+ * Открывает сессию с уже активированной картой (activateTypeA/cardDetect, SAK бит 5):
+ * RATS и, если карта поддерживает, PPS до maxBitRate.
+ * Сессия остаётся открытой между вызовами loop(), пока не будет вызван close()
+ * или пока обмен не завершится ошибкой (карта покинула поле).
+ */
+bool PN5180ISO14443Session::open(uint8_t cid, uint8_t maxBitRate)
+{
+	opened = false;
+	lastSW = 0;
+	if (!nfc.sendRATS(cid))
+		return false;
+	bitRate = nfc.sendPPS(maxBitRate);
+	opened = true;
+	return true;
+}
+
+/*
+ * Открывает сессию с картой, уже переведённой в ISO-DEP другим способом,
+ * например activateTypeB() (ATTRIB вместо RATS).
+ */
+bool PN5180ISO14443Session::attach()
+{
+	lastSW = 0;
+	bitRate = ISO14443_BITRATE_106;
+	opened = nfc.isIsoDepActive();
+	return opened;
+}
+
+bool PN5180ISO14443Session::isOpen() const
+{
+	return opened;
+}
+
+uint8_t PN5180ISO14443Session::getBitRate() const
+{
+	return bitRate;
+}
+
+// Слово состояния SW1 SW2 последнего ответа, 0 — ответа не было
+uint16_t PN5180ISO14443Session::getLastSW() const
+{
+	return lastSW;
+}
+
+/*
+ * Один обмен APDU в открытой сессии.
+ * respLen : на входе — размер resp, на выходе — длина ответа (включая SW1 SW2)
+ * Ошибка обмена закрывает сессию: после исчерпания повторов ISO-DEP карта считается потерянной.
+ *
+ * возвращаемое значение: true — ответ получен, SW доступно через getLastSW()
+ */
+bool PN5180ISO14443Session::transmit(const uint8_t *apdu, uint16_t apduLen, uint8_t *resp, uint16_t *respLen)
+{
+	lastSW = 0;
+	if (!opened)
+		return false;
+
+	if (!nfc.exchange(apdu, apduLen, resp, respLen) || *respLen < 2)
+	{
+		PN5180DEBUG(F("Session: exchange failed, closing\n"));
+		opened = false;
+		return false;
+	}
+	lastSW = ((uint16_t)resp[*respLen - 2] << 8) | resp[*respLen - 1];
+	return true;
+}
+
+/*
+ * Выполняет пакет APDU подряд, без повторной активации карты между командами.
+ * После каждого ответа проверяется SW (если expectedSW != APDU_SW_ANY) и вызывается callback.
+ * Пакет прерывается на первой команде с ошибкой обмена, неожиданным SW
+ * или если callback вернул false.
+ * resp     : общий буфер ответа, перезаписывается каждой командой
+ *
+ * возвращаемое значение: количество успешно выполненных команд (count — весь пакет)
+ */
+uint8_t PN5180ISO14443Session::runBatch(const PN5180Apdu *apdus, uint8_t count, uint8_t *resp, uint16_t respSize,
+										PN5180ApduCallback callback, void *context)
+{
+	for (uint8_t i = 0; i < count; i++)
+	{
+		uint16_t len = respSize;
+		if (!transmit(apdus[i].data, apdus[i].len, resp, &len))
+			return i;
+		if (apdus[i].expectedSW != APDU_SW_ANY && lastSW != apdus[i].expectedSW)
+		{
+			PN5180DEBUG(F("Session: unexpected SW, batch aborted\n"));
+			return i;
+		}
+		if (callback && !callback(i, resp, len, lastSW, context))
+			return i + 1;
+	}
+	return count;
+}
+
+// Завершает сессию командой S(DESELECT)
+void PN5180ISO14443Session::close()
+{
+	if (hcePending)
+		hceFinish(HCE_FAILED);
+	if (opened)
+		nfc.deselect();
+	opened = false;
+}
+
+/*
+ * Эвристика: телефон в режиме HCE (Android) отвечает ATS без исторических байт,
+ * у карт DESFire, JCOP и т. п. они всегда есть.
+ */
+bool PN5180ISO14443Session::isLikelyHCE() const
+{
+	// TL = 0 — карта активирована без ATS (Type B)
+	return opened && nfc.getATS().tl != 0 && nfc.getATS().historicalLen == 0;
+}
+
+/*
+ * Задержки перед повторами SELECT в мс. Заблокированный телефон отвечает 6A 82,
+ * пока пользователь не разблокирует экран; поле и сессия ISO-DEP при этом остаются
+ * активными, поэтому после разблокировки ответ приходит без повторной активации.
+ */
+static const uint16_t hceRetrySchedule[] PROGMEM = {20, 40, 80, 150, 250};
+
+/*
+ * Начинает выбор приложения HCE: первый SELECT уходит при ближайшем hcePoll().
+ * aid : AID приложения (массив должен существовать до завершения выбора)
+ */
+void PN5180ISO14443Session::hceBegin(const uint8_t *aid, uint8_t aidLen)
+{
+	hceAid = aid;
+	hceAidLen = aidLen;
+	hceAttempt = 0;
+	hceStart = millis();
+	hceNextTry = hceStart;
+	hcePending = true;
+	hceStats.sessions++;
+}
+
+uint8_t PN5180ISO14443Session::hceFinish(uint8_t result)
+{
+	hcePending = false;
+	if (result == HCE_SELECTED)
+	{
+		hceStats.selected++;
+		if (hceAttempt == 0)
+		{
+			hceStats.firstTry++;
+		}
+		else
+		{
+			uint32_t unlockTime = millis() - hceStart;
+			if (unlockTime < hceStats.unlockTimeMin)
+				hceStats.unlockTimeMin = unlockTime;
+			if (unlockTime > hceStats.unlockTimeMax)
+				hceStats.unlockTimeMax = unlockTime;
+			hceStats.unlockTimeSum += unlockTime;
+		}
+	}
+	else
+	{
+		hceStats.failed++;
+	}
+	return result;
+}
+
+/*
+ * Шаг выбора приложения HCE, вызывается из loop() без блокировки.
+ * Когда подходит время очередной попытки, отправляет SELECT по AID:
+ * -	90 00 — приложение выбрано (HCE_SELECTED), ответ в resp;
+ * -	6A 82 — телефон заблокирован, следующая попытка по расписанию hceRetrySchedule;
+ * -	ошибка обмена — телефон убран из поля, сессия закрыта (HCE_FAILED);
+ * -	другое SW или исчерпан HCE_RETRY_BUDGET_MS — HCE_FAILED.
+ * respLen : на входе — размер resp, на выходе — длина ответа
+ *
+ * возвращаемое значение: HCE_PENDING, HCE_SELECTED или HCE_FAILED
+ */
+uint8_t PN5180ISO14443Session::hcePoll(uint8_t *resp, uint16_t *respLen)
+{
+	if (!hcePending)
+		return HCE_FAILED;
+	if (!opened)
+		return hceFinish(HCE_FAILED);
+	if ((int32_t)(millis() - hceNextTry) < 0)
+	{
+		*respLen = 0;
+		return HCE_PENDING;
+	}
+
+	// SELECT by AID, Le = 0
+	uint8_t select[5 + 16 + 1] = {0x00, 0xA4, 0x04, 0x00};
+	uint8_t aidLen = (hceAidLen > 16) ? 16 : hceAidLen;
+	select[4] = aidLen;
+	memcpy(select + 5, hceAid, aidLen);
+	select[5 + aidLen] = 0x00;
+
+	uint32_t sent = millis();
+	if (!transmit(select, 6 + aidLen, resp, respLen))
+		return hceFinish(HCE_FAILED);
+
+	uint32_t answerTime = millis() - sent;
+	if (answerTime > 0xFFFF)
+		answerTime = 0xFFFF;
+	if (answerTime < hceStats.answerTimeMin)
+		hceStats.answerTimeMin = answerTime;
+	if (answerTime > hceStats.answerTimeMax)
+		hceStats.answerTimeMax = answerTime;
+	hceStats.answerTimeSum += answerTime;
+	hceStats.answers++;
+
+	if (lastSW == APDU_SW_OK)
+		return hceFinish(HCE_SELECTED);
+	if (lastSW != 0x6A82 || millis() - hceStart > HCE_RETRY_BUDGET_MS)
+		return hceFinish(HCE_FAILED);
+
+	// Телефон заблокирован — ждём по расписанию, последний интервал повторяется
+	uint8_t slot = (hceAttempt < sizeof(hceRetrySchedule) / sizeof(hceRetrySchedule[0])) ? hceAttempt : sizeof(hceRetrySchedule) / sizeof(hceRetrySchedule[0]) - 1;
+	hceNextTry = millis() + pgm_read_word(&hceRetrySchedule[slot]);
+	if (hceAttempt < 0xFF)
+		hceAttempt++;
+	hceStats.retries++;
+	return HCE_PENDING;
+}
+
+bool PN5180ISO14443Session::hceIsPending() const
+{
+	return hcePending;
+}
+
+const PN5180HceStats &PN5180ISO14443Session::getHceStats() const
+{
+	return hceStats;
+}
+
+void PN5180ISO14443Session::resetHceStats()
+{
+	memset(&hceStats, 0, sizeof(hceStats));
+	hceStats.unlockTimeMin = 0xFFFFFFFFUL;
+	hceStats.answerTimeMin = 0xFFFF;
+}
@@ -0,0 +1,307 @@
+// NAME: PN5180ISO15693.cpp
+//
+// DESC: Протокол ISO15693 (NFC-V) на модуле NXP Semiconductors PN5180 для Arduino.
+//
+// Этот файл является частью библиотеки PN5180 для среды Arduino.
+//
+// Эта библиотека является свободным программным обеспечением; вы можете распространять и/или
+// изменять её на условиях Стандартной Общественной Лицензии GNU (LGPL) версии 2.1
+// либо (по вашему выбору) любой более поздней версии.
+//
+// Эта библиотека распространяется в надежде, что она будет полезной,
+// но БЕЗ КАКИХ-ЛИБО ГАРАНТИЙ; даже без подразумеваемой гарантии
+// КОММЕРЧЕСКОЙ ЦЕННОСТИ или ПРИГОДНОСТИ ДЛЯ ОПРЕДЕЛЕННОЙ ЦЕЛИ. Подробнее см. в
+// Стандартной Общественной Лицензии GNU.
+//
+// #define DEBUG 1
+
+#include <Arduino.h>
+#include "PN5180ISO15693.h"
+#include "Debug.h"
+
+// Время до начала ответа метки t1 = 4352/fc ≈ 321 мкс, плюс запас
+#define ISO15693_RESPONSE_TIMEOUT_CYCLES (4352UL + 4096UL)
+// Запись: при Option flag = 0 метка отвечает после программирования, не позднее 20 мс
+#define ISO15693_WRITE_TIMEOUT_CYCLES (271200UL)
+// TX_CONFIG: сброс TX_DATA_ENABLE и символа начала кадра — передаётся только EOF
+#define ISO15693_TX_CONFIG_EOF_ONLY_MASK (0xFFFFFB3FUL)
+
+PN5180ISO15693::PN5180ISO15693(uint8_t SSpin, uint8_t BUSYpin, uint8_t RSTpin)
+	: PN5180(SSpin, BUSYpin, RSTpin)
+{
+}
+
+bool PN5180ISO15693::setupRF()
+{
+	PN5180DEBUG(F("Загрузка RF-конфигурации ISO15693...\n"));
+	if (!loadRFConfig(ISO15693_TX_CONFIG, ISO15693_RX_CONFIG))
+		return false;
+
+	PN5180DEBUG(F("Включение RF поля...\n"));
+	return setRF_on();
+}
+
+/*
+ * Отправляет команду и ждёт ответ метки не дольше timeoutCycles (TIMER1).
+ * result    : указатель на ответ (флаги + данные) во внутреннем буфере PN5180
+ * resultLen : длина ответа
+ *
+ * возвращаемое значение: ISO15693_EC_OK или код ошибки (из ответа метки или локальный)
+ */
+ISO15693ErrorCode PN5180ISO15693::issueCommand(uint8_t *cmd, uint8_t cmdLen, uint8_t **result, int16_t *resultLen, uint32_t timeoutCycles)
+{
+	*resultLen = 0;
+	startRxTimeout(timeoutCycles);
+	if (!sendData(cmd, cmdLen, 0))
+		return ISO15693_EC_UNKNOWN_ERROR;
+
+	int16_t len = waitForRx();
+	if (len == 0)
+		return EC_NO_CARD;
+	if (len < 0)
+		return ISO15693_EC_RX_ERROR;
+
+	*result = readData(len);
+	if (*result == 0)
+		return ISO15693_EC_UNKNOWN_ERROR;
+	*resultLen = len;
+
+	// Бит 0 флагов ответа — ошибка, код ошибки во втором байте
+	if ((*result)[0] & 0x01)
+		return (len > 1) ? (ISO15693ErrorCode)(*result)[1] : ISO15693_EC_UNKNOWN_ERROR;
+	return ISO15693_EC_OK;
+}
+
+/*
+ * Один раунд INVENTORY (ISO15693-3, 8.3) с маской mask длиной maskLen бит.
+ * В режиме 16 слотов первый слот открывает сам запрос, каждый следующий — кадр,
+ * состоящий только из EOF. Метки, ответившие без ошибок, добавляются в uids
+ * (без повторов), слоты с коллизией или ошибкой приёма отмечаются в collisionSlots.
+ *
+ * возвращаемое значение: количество новых UID, -1 — ошибка PN5180
+ */
+int8_t PN5180ISO15693::inventoryRound(const uint8_t *mask, uint8_t maskLen, bool oneSlot, uint8_t *uids, uint8_t maxUids, uint8_t *numUids,
+									  uint16_t *collisionSlots)
+{
+	uint8_t cmd[3 + ISO15693_UID_LEN];
+	uint8_t maskBytes = (maskLen + 7) / 8;
+	cmd[0] = ISO15693_FLAG_HIGH_DATA_RATE | ISO15693_FLAG_INVENTORY | (oneSlot ? ISO15693_FLAG_ONE_SLOT : 0);
+	cmd[1] = 0x01; // INVENTORY
+	cmd[2] = maskLen;
+	memcpy(cmd + 3, mask, maskBytes);
+
+	uint32_t txConfig;
+	if (!readRegister(TX_CONFIG, &txConfig))
+		return -1;
+
+	int8_t found = 0;
+	uint8_t slots = oneSlot ? 1 : 16;
+	*collisionSlots = 0;
+	for (uint8_t slot = 0; slot < slots; slot++)
+	{
+		startRxTimeout(ISO15693_RESPONSE_TIMEOUT_CYCLES);
+		if (!sendData(cmd, (slot == 0) ? 3 + maskBytes : 0, 0))
+		{
+			found = -1;
+			break;
+		}
+		int16_t len = waitForRx();
+		if (len < 0)
+		{
+			*collisionSlots |= (1 << slot);
+		}
+		else if (len >= 2 + ISO15693_UID_LEN)
+		{
+			// Ответ: флаги, DSFID, UID (8 байт, младший байт первым)
+			uint8_t *data = readData(len);
+			if (data != 0 && (data[0] & 0x01) == 0)
+			{
+				bool known = false;
+				for (uint8_t i = 0; i < *numUids && !known; i++)
+					known = memcmp(uids + i * ISO15693_UID_LEN, data + 2, ISO15693_UID_LEN) == 0;
+				if (!known && *numUids < maxUids)
+				{
+					memcpy(uids + *numUids * ISO15693_UID_LEN, data + 2, ISO15693_UID_LEN);
+					(*numUids)++;
+					found++;
+				}
+			}
+		}
+
+		// Следующие слоты открываются кадром только из EOF
+		if (slot == 0 && !oneSlot)
+			writeRegisterWithAndMask(TX_CONFIG, ISO15693_TX_CONFIG_EOF_ONLY_MASK);
+	}
+
+	writeRegister(TX_CONFIG, txConfig);
+	return found;
+}
+
+/*
+ * INVENTORY с одним слотом: UID единственной метки в поле.
+ * uid : 8 байт, младший байт первым
+ *
+ * возвращаемое значение: ISO15693_EC_OK, EC_NO_CARD или ISO15693_EC_RX_ERROR (несколько меток)
+ */
+ISO15693ErrorCode PN5180ISO15693::getInventory(uint8_t *uid)
+{
+	uint8_t numUids = 0;
+	uint16_t collisions = 0;
+	if (inventoryRound(0, 0, true, uid, 1, &numUids, &collisions) < 0)
+		return ISO15693_EC_UNKNOWN_ERROR;
+	if (numUids == 1)
+		return ISO15693_EC_OK;
+	return collisions ? ISO15693_EC_RX_ERROR : EC_NO_CARD;
+}
+
+/*
+ * INVENTORY с 16 слотами и разрешением коллизий по маске.
+ * Для каждого слота с коллизией номер слота (4 бита) добавляется к маске,
+ * и раунд повторяется только для меток с совпадающими младшими битами UID.
+ * uids     : буфер на maxUids * 8 байт
+ * complete : если не 0 — false, когда часть меток могла остаться не прочитанной
+ *            (переполнен буфер UID или стек масок)
+ *
+ * возвращаемое значение: количество найденных меток
+ */
+uint8_t PN5180ISO15693::getInventoryMultiple(uint8_t *uids, uint8_t maxUids, bool *complete)
+{
+	struct Mask
+	{
+		uint8_t value[ISO15693_UID_LEN];
+		uint8_t len;
+	};
+	Mask stack[ISO15693_MAX_MASK_DEPTH];
+	uint8_t depth = 1;
+	uint8_t numUids = 0;
+	bool all = true;
+	memset(&stack[0], 0, sizeof(Mask));
+
+	while (depth > 0)
+	{
+		Mask mask = stack[--depth];
+		uint16_t collisions = 0;
+		if (inventoryRound(mask.value, mask.len, false, uids, maxUids, &numUids, &collisions) < 0)
+		{
+			all = false;
+			break;
+		}
+		if (numUids >= maxUids && collisions)
+		{
+			all = false;
+			break;
+		}
+		for (uint8_t slot = 0; slot < 16; slot++)
+		{
+			if (!(collisions & (1 << slot)))
+				continue;
+			if (mask.len + 4 > ISO15693_UID_LEN * 8 || depth >= ISO15693_MAX_MASK_DEPTH)
+			{
+				all = false;
+				continue;
+			}
+			Mask next = mask;
+			next.value[mask.len / 8] |= slot << (mask.len % 8);
+			next.len = mask.len + 4;
+			stack[depth++] = next;
+		}
+	}
+
+	if (complete)
+		*complete = all;
+	return numUids;
+}
+
+/*
+ * GET SYSTEM INFORMATION (0x2B): размер и количество блоков памяти метки.
+ */
+ISO15693ErrorCode PN5180ISO15693::getSystemInfo(const uint8_t *uid, uint8_t *blockSize, uint16_t *numBlocks)
+{
+	uint8_t cmd[2 + ISO15693_UID_LEN] = {ISO15693_FLAG_HIGH_DATA_RATE | ISO15693_FLAG_ADDRESSED, 0x2B};
+	memcpy(cmd + 2, uid, ISO15693_UID_LEN);
+
+	uint8_t *result;
+	int16_t len;
+	ISO15693ErrorCode rc = issueCommand(cmd, sizeof(cmd), &result, &len, ISO15693_RESPONSE_TIMEOUT_CYCLES);
+	if (rc != ISO15693_EC_OK)
+		return rc;
+
+	// флаги, info flags, UID, [DSFID], [AFI], [кол-во блоков - 1, размер блока - 1], [IC ref]
+	uint8_t infoFlags = result[1];
+	int16_t pos = 2 + ISO15693_UID_LEN;
+	if (infoFlags & 0x01)
+		pos++;
+	if (infoFlags & 0x02)
+		pos++;
+	if (!(infoFlags & 0x04) || pos + 2 > len)
+		return ISO15693_EC_NOT_SUPPORTED;
+	*numBlocks = result[pos] + 1;
+	*blockSize = (result[pos + 1] & 0x1F) + 1;
+	return ISO15693_EC_OK;
+}
+
+/*
+ * READ SINGLE BLOCK (0x20)
+ */
+ISO15693ErrorCode PN5180ISO15693::readSingleBlock(const uint8_t *uid, uint8_t blockNo, uint8_t *blockData, uint8_t blockSize)
+{
+	return readMultipleBlocks(uid, blockNo, 1, blockData, blockSize);
+}
+
+/*
+ * WRITE SINGLE BLOCK (0x21)
+ * Метка отвечает после окончания программирования, поэтому таймаут ответа — 20 мс.
+ */
+ISO15693ErrorCode PN5180ISO15693::writeSingleBlock(const uint8_t *uid, uint8_t blockNo, const uint8_t *blockData, uint8_t blockSize)
+{
+	if (blockSize > 32)
+		return ISO15693_EC_INVALID_PARAMETER;
+
+	uint8_t cmd[3 + ISO15693_UID_LEN + 32] = {ISO15693_FLAG_HIGH_DATA_RATE | ISO15693_FLAG_ADDRESSED, 0x21};
+	memcpy(cmd + 2, uid, ISO15693_UID_LEN);
+	cmd[2 + ISO15693_UID_LEN] = blockNo;
+	memcpy(cmd + 3 + ISO15693_UID_LEN, blockData, blockSize);
+
+	uint8_t *result;
+	int16_t len;
+	return issueCommand(cmd, 3 + ISO15693_UID_LEN + blockSize, &result, &len, ISO15693_WRITE_TIMEOUT_CYCLES);
+}
+
+/*
+ * READ MULTIPLE BLOCKS (0x23): numBlocks блоков одной командой, начиная с blockNo.
+ * Ответ (флаги + данные) должен поместиться в буфер приёма (PN5180_READ_BUFFER_SIZE, на AVR 128 байт).
+ * blockData : буфер на numBlocks * blockSize байт
+ */
+ISO15693ErrorCode PN5180ISO15693::readMultipleBlocks(const uint8_t *uid, uint8_t blockNo, uint8_t numBlocks, uint8_t *blockData, uint8_t blockSize)
+{
+	if (numBlocks == 0 || 1 + (uint16_t)numBlocks * blockSize > PN5180_READ_BUFFER_SIZE)
+		return ISO15693_EC_INVALID_PARAMETER;
+
+	uint8_t cmd[4 + ISO15693_UID_LEN];
+	uint8_t cmdLen;
+	cmd[0] = ISO15693_FLAG_HIGH_DATA_RATE | ISO15693_FLAG_ADDRESSED;
+	memcpy(cmd + 2, uid, ISO15693_UID_LEN);
+	cmd[2 + ISO15693_UID_LEN] = blockNo;
+	if (numBlocks == 1)
+	{
+		cmd[1] = 0x20; // READ SINGLE BLOCK
+		cmdLen = 3 + ISO15693_UID_LEN;
+	}
+	else
+	{
+		cmd[1] = 0x23; // READ MULTIPLE BLOCKS, количество блоков - 1
+		cmd[3 + ISO15693_UID_LEN] = numBlocks - 1;
+		cmdLen = 4 + ISO15693_UID_LEN;
+	}
+
+	uint8_t *result;
+	int16_t len;
+	ISO15693ErrorCode rc = issueCommand(cmd, cmdLen, &result, &len, ISO15693_RESPONSE_TIMEOUT_CYCLES);
+	if (rc != ISO15693_EC_OK)
+		return rc;
+	if (len != 1 + numBlocks * blockSize)
+		return ISO15693_EC_RX_ERROR;
+
+	memcpy(blockData, result + 1, numBlocks * blockSize);
+	return ISO15693_EC_OK;
+}
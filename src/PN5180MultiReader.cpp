@@ -0,0 +1,178 @@
+// NAME: PN5180MultiReader.cpp
+//
+// DESC: Несколько PN5180 на одной шине SPI с чередованием ожидания ответов карт.
+//
+// Этот файл является частью библиотеки PN5180 для среды Arduino.
+//
+// Эта библиотека является свободным программным обеспечением; вы можете распространять и/или
+// изменять её на условиях Стандартной Общественной Лицензии GNU (LGPL) версии 2.1
+// либо (по вашему выбору) любой более поздней версии.
+//
+// Эта библиотека распространяется в надежде, что она будет полезной,
+// но БЕЗ КАКИХ-ЛИБО ГАРАНТИЙ; даже без подразумеваемой гарантии
+// КОММЕРЧЕСКОЙ ЦЕННОСТИ или ПРИГОДНОСТИ ДЛЯ ОПРЕДЕЛЕННОЙ ЦЕЛИ. Подробнее см. в
+// Стандартной Общественной Лицензии GNU.
+//
+// #define DEBUG 1
+
+#include <Arduino.h>
+#include "PN5180MultiReader.h"
+#include "Debug.h"
+
+// Состояния считывателя
+enum
+{
+	READER_IDLE,      // можно отправлять WUPA
+	READER_WAIT_ATQA, // WUPA отправлен, ждём ответ через pollRx()
+	READER_PAUSED     // после карты — до pausedUntil
+};
+
+PN5180MultiReader::PN5180MultiReader()
+{
+	count = 0;
+	next = 0;
+	handler = 0;
+	context = 0;
+	resetStats();
+}
+
+/*
+ * Добавляет считыватель. Все считыватели делят SCK/MOSI/MISO, у каждого свои NSS, BUSY и RST;
+ * begin(), reset() и setupRF() вызываются заранее для каждого.
+ *
+ * возвращаемое значение: номер считывателя или -1, если места нет
+ */
+int8_t PN5180MultiReader::add(PN5180ISO14443 &reader)
+{
+	if (count >= MULTIREADER_MAX_READERS)
+		return -1;
+	readers[count] = &reader;
+	state[count] = READER_IDLE;
+	lastVisit[count] = micros();
+	return count++;
+}
+
+uint8_t PN5180MultiReader::getCount() const
+{
+	return count;
+}
+
+PN5180ISO14443 &PN5180MultiReader::getReader(uint8_t r)
+{
+	return *readers[r];
+}
+
+void PN5180MultiReader::setCardHandler(PN5180CardHandler handler, void *context)
+{
+	this->handler = handler;
+	this->context = context;
+}
+
+// Не опрашивать считыватель ms миллисекунд (например, пока карта обрабатывается)
+void PN5180MultiReader::pause(uint8_t r, uint32_t ms)
+{
+	if (r >= count)
+		return;
+	state[r] = READER_PAUSED;
+	pausedUntil[r] = millis() + ms;
+}
+
+const PN5180ReaderStats &PN5180MultiReader::getStats(uint8_t r) const
+{
+	return stats[r];
+}
+
+void PN5180MultiReader::resetStats()
+{
+	memset(stats, 0, sizeof(stats));
+}
+
+/*
+ * Один шаг конечного автомата считывателя r. Не ждёт ответа карты:
+ * WUPA отправляется с таймаутом TIMER1, результат проверяется pollRx() при следующих визитах.
+ * Антиколлизия и SELECT после ATQA выполняются сразу (короткие кадры).
+ */
+void PN5180MultiReader::step(uint8_t r)
+{
+	PN5180ISO14443 &nfc = *readers[r];
+	PN5180ReaderStats &st = stats[r];
+
+	switch (state[r])
+	{
+	case READER_PAUSED:
+		if ((int32_t)(millis() - pausedUntil[r]) < 0)
+			return;
+		state[r] = READER_IDLE;
+		// fall through
+	case READER_IDLE:
+	{
+		uint8_t wupa = 0x52;
+		st.polls++;
+		if (!nfc.prepareTypeA() || !nfc.startRxTimeout(MULTIREADER_ATQA_TIMEOUT_CYCLES) || !nfc.sendData(&wupa, 1, 0x07))
+		{
+			st.errors++;
+			return;
+		}
+		started[r] = micros();
+		state[r] = READER_WAIT_ATQA;
+		return;
+	}
+	case READER_WAIT_ATQA:
+	{
+		int16_t len = nfc.pollRx();
+		if (len == PN5180_RX_PENDING)
+			return;
+		st.waitTime += micros() - started[r];
+		state[r] = READER_IDLE;
+		if (len == 0)
+		{
+			st.timeouts++;
+			return;
+		}
+		// Коллизия в ATQA — обычное дело при двух картах на антенне: как и activateTypeA(),
+		// продолжаем антиколлизией, она выберет одну карту
+		if (len == PN5180_RX_COLLISION)
+			st.collisions++;
+		uint8_t buffer[10] = {0};
+		if ((len != 2 && len != PN5180_RX_COLLISION) || !nfc.readData(2, buffer))
+		{
+			st.errors++;
+			return;
+		}
+		uint8_t uidLength = nfc.activateTypeASelect(buffer);
+		// UID 00 00 00 00 и FF FF FF FF — ошибка приёма, как в cardDetect()
+		bool valid = uidLength > 0 && !(buffer[3] == 0x00 && buffer[4] == 0x00 && buffer[5] == 0x00 && buffer[6] == 0x00) &&
+					 !(buffer[3] == 0xFF && buffer[4] == 0xFF && buffer[5] == 0xFF && buffer[6] == 0xFF);
+		if (!valid)
+		{
+			st.errors++;
+			return;
+		}
+		st.cards++;
+		if (handler)
+			handler(r, buffer, uidLength, context);
+		return;
+	}
+	}
+}
+
+/*
+ * Один проход по всем считывателям; вызывать из loop() как можно чаще.
+ * Каждый проход начинается со следующего считывателя, поэтому ни один не ждёт
+ * дольше одного прохода, даже если обработчик карты на другом работает долго.
+ */
+void PN5180MultiReader::service()
+{
+	if (count == 0)
+		return;
+	for (uint8_t i = 0; i < count; i++)
+	{
+		uint8_t r = (next + i) % count;
+		uint32_t now = micros();
+		if (now - lastVisit[r] > stats[r].maxGap)
+			stats[r].maxGap = now - lastVisit[r];
+		lastVisit[r] = now;
+		step(r);
+	}
+	next = (next + 1) % count;
+}
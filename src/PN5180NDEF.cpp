@@ -0,0 +1,291 @@
+// NAME: PN5180NDEF.cpp
+//
+// DESC: Потоковый разбор TLV и записей NDEF.
+//
+// Этот файл является частью библиотеки PN5180 для среды Arduino.
+//
+// Эта библиотека является свободным программным обеспечением; вы можете распространять и/или
+// изменять её на условиях Стандартной Общественной Лицензии GNU (LGPL) версии 2.1
+// либо (по вашему выбору) любой более поздней версии.
+//
+// Эта библиотека распространяется в надежде, что она будет полезной,
+// но БЕЗ КАКИХ-ЛИБО ГАРАНТИЙ; даже без подразумеваемой гарантии
+// КОММЕРЧЕСКОЙ ЦЕННОСТИ или ПРИГОДНОСТИ ДЛЯ ОПРЕДЕЛЕННОЙ ЦЕЛИ. Подробнее см. в
+// Стандартной Общественной Лицензии GNU.
+//
+
+#include <string.h>
+#include "PN5180NDEF.h"
+
+// Состояния разбора TLV
+enum
+{
+	TLV_TYPE,
+	TLV_LENGTH,
+	TLV_LENGTH_HI,
+	TLV_LENGTH_LO,
+	TLV_SKIP,
+	TLV_MESSAGE
+};
+
+// Состояния разбора записи NDEF
+enum
+{
+	MSG_HEADER,
+	MSG_TYPE_LENGTH,
+	MSG_PAYLOAD_LENGTH,
+	MSG_ID_LENGTH,
+	MSG_TYPE,
+	MSG_ID,
+	MSG_PAYLOAD,
+	MSG_DONE
+};
+
+NDEFParser::NDEFParser()
+{
+	begin(0, 0, false);
+}
+
+/*
+ * Подготовка к разбору нового сообщения.
+ * tlv : true — на входе область TLV метки Type 2 (разбирается первый NDEF Message TLV),
+ *       false — на входе само сообщение NDEF (файл NDEF метки Type 4 без NLEN)
+ */
+void NDEFParser::begin(NDEFRecordCallback callback, void *context, bool tlv)
+{
+	this->callback = callback;
+	this->context = context;
+	this->tlv = tlv;
+	tlvState = TLV_TYPE;
+	tlvRemaining = 0;
+	msgState = MSG_HEADER;
+	fieldRemaining = 0;
+	status = NDEF_PARSE_MORE;
+	memset(&record, 0, sizeof(record));
+}
+
+uint8_t NDEFParser::getStatus() const
+{
+	return status;
+}
+
+/*
+ * Сколько байт парсер заведомо ждёт дальше: остаток значения текущего TLV
+ * или полезной нагрузки записи. 0 — неизвестно (разбирается заголовок).
+ * Используется для выбора размера следующего чтения с метки.
+ */
+uint32_t NDEFParser::bytesExpected() const
+{
+	if (status != NDEF_PARSE_MORE)
+		return 0;
+	if (tlv)
+	{
+		if (tlvState == TLV_MESSAGE || tlvState == TLV_SKIP)
+			return tlvRemaining;
+		return 0;
+	}
+	return (msgState == MSG_PAYLOAD) ? fieldRemaining : 0;
+}
+
+bool NDEFParser::startPayload()
+{
+	record.payloadOffset = 0;
+	if (callback && !callback(NDEF_EVENT_RECORD_BEGIN, record, 0, 0, context))
+		return false;
+	fieldRemaining = record.payloadLength;
+	msgState = MSG_PAYLOAD;
+	return (fieldRemaining > 0) ? true : endRecord();
+}
+
+bool NDEFParser::endRecord()
+{
+	if (callback && !callback(NDEF_EVENT_RECORD_END, record, 0, 0, context))
+		return false;
+	msgState = (record.flags & NDEF_FLAG_ME) ? MSG_DONE : MSG_HEADER;
+	record.index++;
+	return true;
+}
+
+/*
+ * Разбор байт сообщения NDEF. Полезная нагрузка не копируется:
+ * обработчик получает указатели прямо во входной буфер.
+ *
+ * возвращаемое значение: количество использованных байт
+ */
+uint16_t NDEFParser::feedMessage(const uint8_t *data, uint16_t len)
+{
+	uint16_t pos = 0;
+	while (pos < len && msgState != MSG_DONE && status == NDEF_PARSE_MORE)
+	{
+		if (msgState == MSG_PAYLOAD)
+		{
+			uint16_t chunk = (fieldRemaining < (uint32_t)(len - pos)) ? fieldRemaining : len - pos;
+			if (callback && !callback(NDEF_EVENT_PAYLOAD, record, data + pos, chunk, context))
+			{
+				status = NDEF_PARSE_ABORTED;
+				break;
+			}
+			pos += chunk;
+			record.payloadOffset += chunk;
+			fieldRemaining -= chunk;
+			if (fieldRemaining == 0 && !endRecord())
+				status = NDEF_PARSE_ABORTED;
+			continue;
+		}
+
+		uint8_t b = data[pos++];
+		bool ok = true;
+		switch (msgState)
+		{
+		case MSG_HEADER:
+			// Первая запись должна иметь MB, последующие — нет
+			if (((b & NDEF_FLAG_MB) != 0) != (record.index == 0))
+			{
+				status = NDEF_PARSE_ERROR;
+				break;
+			}
+			record.flags = b;
+			record.idLength = 0;
+			record.payloadLength = 0;
+			msgState = MSG_TYPE_LENGTH;
+			break;
+		case MSG_TYPE_LENGTH:
+			record.typeLength = b;
+			lengthBytes = (record.flags & NDEF_FLAG_SR) ? 1 : 4;
+			msgState = MSG_PAYLOAD_LENGTH;
+			break;
+		case MSG_PAYLOAD_LENGTH:
+			record.payloadLength = (record.payloadLength << 8) | b;
+			if (--lengthBytes > 0)
+				break;
+			msgState = (record.flags & NDEF_FLAG_IL) ? MSG_ID_LENGTH : MSG_TYPE;
+			if (msgState == MSG_TYPE)
+			{
+				typePos = 0;
+				fieldRemaining = record.typeLength;
+				if (fieldRemaining == 0)
+					ok = startPayload();
+			}
+			break;
+		case MSG_ID_LENGTH:
+			record.idLength = b;
+			typePos = 0;
+			fieldRemaining = record.typeLength;
+			msgState = MSG_TYPE;
+			if (fieldRemaining == 0)
+			{
+				fieldRemaining = record.idLength;
+				msgState = MSG_ID;
+				if (fieldRemaining == 0)
+					ok = startPayload();
+			}
+			break;
+		case MSG_TYPE:
+			if (typePos < NDEF_MAX_TYPE_LEN)
+				record.type[typePos++] = b;
+			if (--fieldRemaining > 0)
+				break;
+			fieldRemaining = record.idLength;
+			msgState = MSG_ID;
+			if (fieldRemaining == 0)
+				ok = startPayload();
+			break;
+		case MSG_ID:
+			// ID записи не сохраняется
+			if (--fieldRemaining == 0)
+				ok = startPayload();
+			break;
+		}
+		if (!ok)
+			status = NDEF_PARSE_ABORTED;
+	}
+	if (msgState == MSG_DONE && status == NDEF_PARSE_MORE)
+		status = NDEF_PARSE_DONE;
+	return pos;
+}
+
+/*
+ * Передаёт парсеру очередную порцию данных (любого размера, начиная с 1 байта).
+ * Порции должны идти подряд, без пропусков.
+ *
+ * возвращаемое значение: NDEF_PARSE_MORE, пока сообщение не закончилось
+ */
+uint8_t NDEFParser::feed(const uint8_t *data, uint16_t len)
+{
+	if (!tlv)
+	{
+		if (status == NDEF_PARSE_MORE)
+			feedMessage(data, len);
+		return status;
+	}
+
+	uint16_t pos = 0;
+	while (pos < len && status == NDEF_PARSE_MORE)
+	{
+		if (tlvState == TLV_MESSAGE || tlvState == TLV_SKIP)
+		{
+			uint16_t chunk = (tlvRemaining < len - pos) ? tlvRemaining : len - pos;
+			if (tlvState == TLV_MESSAGE)
+				chunk = feedMessage(data + pos, chunk);
+			pos += chunk;
+			tlvRemaining -= chunk;
+			if (status != NDEF_PARSE_MORE)
+				break;
+			if (tlvRemaining == 0)
+			{
+				// Сообщение закончилось раньше записи с ME
+				if (tlvState == TLV_MESSAGE)
+					status = NDEF_PARSE_ERROR;
+				tlvState = TLV_TYPE;
+			}
+			continue;
+		}
+
+		uint8_t b = data[pos++];
+		bool lengthKnown = false;
+		switch (tlvState)
+		{
+		case TLV_TYPE:
+			if (b == NDEF_TLV_NULL)
+				break;
+			if (b == NDEF_TLV_TERMINATOR)
+			{
+				// Область данных закончилась без NDEF Message TLV
+				status = NDEF_PARSE_DONE;
+				break;
+			}
+			tlvType = b;
+			tlvState = TLV_LENGTH;
+			break;
+		case TLV_LENGTH:
+			// 0xFF — трёхбайтовый формат длины
+			if (b == 0xFF)
+			{
+				tlvState = TLV_LENGTH_HI;
+				break;
+			}
+			tlvRemaining = b;
+			lengthKnown = true;
+			break;
+		case TLV_LENGTH_HI:
+			tlvRemaining = (uint16_t)b << 8;
+			tlvState = TLV_LENGTH_LO;
+			break;
+		case TLV_LENGTH_LO:
+			tlvRemaining |= b;
+			lengthKnown = true;
+			break;
+		}
+
+		if (lengthKnown)
+		{
+			if (tlvType != NDEF_TLV_MESSAGE)
+				tlvState = (tlvRemaining > 0) ? TLV_SKIP : TLV_TYPE;
+			else if (tlvRemaining == 0)
+				status = NDEF_PARSE_DONE; // пустое сообщение
+			else
+				tlvState = TLV_MESSAGE;
+		}
+	}
+	return status;
+}
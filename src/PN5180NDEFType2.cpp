@@ -0,0 +1,191 @@
+// NAME: PN5180NDEFType2.cpp
+//
+// DESC: NDEF на метках NFC Forum Type 2 (MIFARE Ultralight, NTAG).
+//
+// Этот файл является частью библиотеки PN5180 для среды Arduino.
+//
+// Эта библиотека является свободным программным обеспечением; вы можете распространять и/или
+// изменять её на условиях Стандартной Общественной Лицензии GNU (LGPL) версии 2.1
+// либо (по вашему выбору) любой более поздней версии.
+//
+// Эта библиотека распространяется в надежде, что она будет полезной,
+// но БЕЗ КАКИХ-ЛИБО ГАРАНТИЙ; даже без подразумеваемой гарантии
+// КОММЕРЧЕСКОЙ ЦЕННОСТИ или ПРИГОДНОСТИ ДЛЯ ОПРЕДЕЛЕННОЙ ЦЕЛИ. Подробнее см. в
+// Стандартной Общественной Лицензии GNU.
+//
+// #define DEBUG 1
+
+#include <Arduino.h>
+#include "PN5180NDEFType2.h"
+#include "Debug.h"
+
+/*
+ * Метка должна быть активирована (activateTypeA/cardDetect) до вызова методов.
+ * Чтение использует FAST_READ, поэтому нужна Ultralight EV1 или NTAG.
+ */
+PN5180NDEFType2::PN5180NDEFType2(PN5180ISO14443 &nfc)
+	: nfc(nfc)
+{
+	ccValid = false;
+	writing = false;
+}
+
+/*
+ * Capability Container (страница 3): E1, версия, размер области данных / 8, доступ.
+ */
+bool PN5180NDEFType2::readCC()
+{
+	uint16_t len;
+	uint8_t *data = nfc.mifareUltralightFastRead(NDEF_T2_CC_PAGE, NDEF_T2_CC_PAGE, &len);
+	ccValid = (data != 0 && data[0] == NDEF_T2_MAGIC);
+	if (ccValid)
+		memcpy(cc, data, sizeof(cc));
+	return ccValid;
+}
+
+// Размер области данных (TLV) в байтах
+uint16_t PN5180NDEFType2::getCapacity() const
+{
+	return ccValid ? cc[2] * 8 : 0;
+}
+
+// Младший полубайт байта доступа CC: 0 — запись разрешена
+bool PN5180NDEFType2::isWritable() const
+{
+	return ccValid && (cc[3] & 0x0F) == 0;
+}
+
+/*
+ * Чтение сообщения NDEF с разбором на лету.
+ * Первый FAST_READ захватывает CC и начало области TLV; следующие читают ровно столько
+ * страниц, сколько парсер ещё ожидает по длине TLV (но не больше 127 страниц за раз).
+ * Данные разбираются прямо в буфере приёма PN5180, без копирования; обработчик
+ * не должен обращаться к PN5180, иначе буфер будет перезаписан.
+ *
+ * возвращаемое значение: NDEF_PARSE_DONE, NDEF_PARSE_ERROR (в т.ч. ошибка чтения) или NDEF_PARSE_ABORTED
+ */
+uint8_t PN5180NDEFType2::read(NDEFRecordCallback callback, void *context)
+{
+	uint16_t len;
+	uint8_t *data = nfc.mifareUltralightFastRead(NDEF_T2_CC_PAGE, NDEF_T2_CC_PAGE + NDEF_T2_FIRST_READ_PAGES - 1, &len);
+	ccValid = (data != 0 && data[0] == NDEF_T2_MAGIC);
+	if (!ccValid)
+		return NDEF_PARSE_ERROR;
+	memcpy(cc, data, sizeof(cc));
+
+	uint16_t capacity = getCapacity();
+	uint16_t endPage = NDEF_T2_DATA_PAGE + capacity / MIFARE_UL_PAGE_SIZE; // первая страница после области данных
+	uint16_t chunk = len - MIFARE_UL_PAGE_SIZE;
+	if (chunk > capacity)
+		chunk = capacity;
+
+	parser.begin(callback, context, true);
+	uint8_t status = parser.feed(data + MIFARE_UL_PAGE_SIZE, chunk);
+	uint16_t nextPage = NDEF_T2_DATA_PAGE + chunk / MIFARE_UL_PAGE_SIZE;
+
+	while (status == NDEF_PARSE_MORE && nextPage < endPage)
+	{
+		uint32_t expected = parser.bytesExpected();
+		uint16_t pages = expected ? (expected + MIFARE_UL_PAGE_SIZE - 1) / MIFARE_UL_PAGE_SIZE : NDEF_T2_READ_PAGES;
+		if (pages > MIFARE_UL_FAST_READ_MAX_PAGES)
+			pages = MIFARE_UL_FAST_READ_MAX_PAGES;
+		if (pages > endPage - nextPage)
+			pages = endPage - nextPage;
+
+		data = nfc.mifareUltralightFastRead(nextPage, nextPage + pages - 1, &len);
+		if (data == 0)
+			return NDEF_PARSE_ERROR;
+		status = parser.feed(data, len);
+		nextPage += pages;
+	}
+	// Область данных кончилась посреди сообщения
+	return (status == NDEF_PARSE_MORE) ? NDEF_PARSE_ERROR : status;
+}
+
+/*
+ * Кладёт байт в поток записи, начиная со страницы 4. Полная страница сразу
+ * записывается на метку; страница 4 (TLV и длина) хранится до endWrite().
+ */
+bool PN5180NDEFType2::stageByte(uint8_t b)
+{
+	uint16_t pageNo = NDEF_T2_DATA_PAGE + writePos / MIFARE_UL_PAGE_SIZE;
+	uint8_t idx = writePos % MIFARE_UL_PAGE_SIZE;
+	writePos++;
+	if (pageNo == NDEF_T2_DATA_PAGE)
+	{
+		firstPage[idx] = b;
+		return true;
+	}
+	page[idx] = b;
+	if (idx < MIFARE_UL_PAGE_SIZE - 1)
+		return true;
+	return nfc.mifareUltralightWritePage(pageNo, page);
+}
+
+/*
+ * Начало записи сообщения NDEF длиной messageLength байт.
+ * Память не зависит от длины сообщения: данные передаются кусками через write().
+ * Пока запись не завершена, страница 4 содержит пустой NDEF TLV, поэтому
+ * прерванная запись оставляет метку с пустым, а не повреждённым сообщением.
+ */
+bool PN5180NDEFType2::beginWrite(uint16_t messageLength)
+{
+	writing = false;
+	if (!ccValid && !readCC())
+		return false;
+	uint8_t header = (messageLength < 0xFF) ? 2 : 4;
+	if (!isWritable() || header + messageLength + 1 > getCapacity())
+		return false;
+
+	uint8_t empty[MIFARE_UL_PAGE_SIZE] = {NDEF_TLV_MESSAGE, 0x00, NDEF_TLV_TERMINATOR, 0x00};
+	if (!nfc.mifareUltralightWritePage(NDEF_T2_DATA_PAGE, empty))
+		return false;
+
+	writeLength = messageLength;
+	writePayload = 0;
+	writePos = 0;
+	stageByte(NDEF_TLV_MESSAGE);
+	if (header == 4)
+	{
+		stageByte(0xFF);
+		stageByte(messageLength >> 8);
+	}
+	stageByte(messageLength & 0xFF);
+	writing = true;
+	return true;
+}
+
+bool PN5180NDEFType2::write(const uint8_t *data, uint16_t len)
+{
+	if (!writing || writePayload + len > writeLength)
+		return false;
+	for (uint16_t i = 0; i < len; i++)
+	{
+		if (!stageByte(data[i]))
+		{
+			writing = false;
+			return false;
+		}
+	}
+	writePayload += len;
+	return true;
+}
+
+/*
+ * Завершение записи: терминатор TLV, дополнение последней страницы нулями
+ * и в самом конце — страница 4 с настоящей длиной сообщения.
+ */
+bool PN5180NDEFType2::endWrite()
+{
+	if (!writing || writePayload != writeLength)
+		return false;
+	writing = false;
+	if (!stageByte(NDEF_TLV_TERMINATOR))
+		return false;
+	while (writePos % MIFARE_UL_PAGE_SIZE != 0)
+	{
+		if (!stageByte(0x00))
+			return false;
+	}
+	return nfc.mifareUltralightWritePage(NDEF_T2_DATA_PAGE, firstPage);
+}
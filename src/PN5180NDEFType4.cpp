@@ -0,0 +1,297 @@
+// NAME: PN5180NDEFType4.cpp
+//
+// DESC: NDEF на метках NFC Forum Type 4 и телефонах в режиме HCE (доступ к файлам через ISO-DEP).
+//
+// Этот файл является частью библиотеки PN5180 для среды Arduino.
+//
+// Эта библиотека является свободным программным обеспечением; вы можете распространять и/или
+// изменять её на условиях Стандартной Общественной Лицензии GNU (LGPL) версии 2.1
+// либо (по вашему выбору) любой более поздней версии.
+//
+// Эта библиотека распространяется в надежде, что она будет полезной,
+// но БЕЗ КАКИХ-ЛИБО ГАРАНТИЙ; даже без подразумеваемой гарантии
+// КОММЕРЧЕСКОЙ ЦЕННОСТИ или ПРИГОДНОСТИ ДЛЯ ОПРЕДЕЛЕННОЙ ЦЕЛИ. Подробнее см. в
+// Стандартной Общественной Лицензии GNU.
+//
+// #define DEBUG 1
+
+#include <Arduino.h>
+#include "PN5180NDEFType4.h"
+#include "Debug.h"
+
+// SELECT NDEF Tag Application по AID D2 76 00 00 85 01 01 (версия 2.0)
+static const uint8_t selectNdefApp[] = {0x00, 0xA4, 0x04, 0x00, 0x07, 0xD2, 0x76, 0x00, 0x00, 0x85, 0x01, 0x01, 0x00};
+
+/*
+ * Приёмник ответа одной команды: последние 2 байта потока (SW1 SW2) придерживаются
+ * и не попадают к вызывающему. Остальные данные передаются дальше без копирования,
+ * кроме не более чем 2 придержанных байт.
+ */
+struct T4Sink
+{
+	PN5180DataSink sink;
+	void *context;
+	uint8_t held[2];
+	uint8_t heldLen;
+	uint16_t dataLen;
+};
+
+static bool t4Forward(T4Sink *s, const uint8_t *data, uint16_t len)
+{
+	s->dataLen += len;
+	return s->sink == 0 || s->sink(data, len, s->context);
+}
+
+static bool t4SinkData(const uint8_t *data, uint16_t len, void *context)
+{
+	T4Sink *s = (T4Sink *)context;
+	if (len >= 2)
+	{
+		if (s->heldLen > 0 && !t4Forward(s, s->held, s->heldLen))
+			return false;
+		if (len > 2 && !t4Forward(s, data, len - 2))
+			return false;
+		s->held[0] = data[len - 2];
+		s->held[1] = data[len - 1];
+		s->heldLen = 2;
+		return true;
+	}
+	if (len == 1)
+	{
+		if (s->heldLen == 2)
+		{
+			if (!t4Forward(s, s->held, 1))
+				return false;
+			s->held[0] = s->held[1];
+			s->heldLen = 1;
+		}
+		s->held[s->heldLen++] = data[0];
+	}
+	return true;
+}
+
+// Приёмник READ BINARY для read(): данные файла NDEF сразу идут в парсер.
+// Байты после последней записи парсер пропускает сам.
+static bool t4SinkParser(const uint8_t *data, uint16_t len, void *context)
+{
+	uint8_t status = ((NDEFParser *)context)->feed(data, len);
+	return status == NDEF_PARSE_MORE || status == NDEF_PARSE_DONE;
+}
+
+/*
+ * Карта должна быть в ISO-DEP (sendRATS, activateTypeB или открытая PN5180ISO14443Session).
+ */
+PN5180NDEFType4::PN5180NDEFType4(PN5180ISO14443 &nfc)
+	: nfc(nfc)
+{
+	selected = false;
+	writing = false;
+	lastSW = 0;
+}
+
+uint16_t PN5180NDEFType4::getLastSW() const
+{
+	return lastSW;
+}
+
+uint16_t PN5180NDEFType4::getMaxMessageSize() const
+{
+	return selected ? maxFileSize - 2 : 0;
+}
+
+// Доступ на запись 00 — свободный
+bool PN5180NDEFType4::isWritable() const
+{
+	return selected && writeAccess == 0x00;
+}
+
+/*
+ * Команда с потоковой передачей данных ответа в sink (без SW).
+ * dataLen : если не 0 — количество переданных данных
+ *
+ * возвращаемое значение: true — SW = 90 00
+ */
+bool PN5180NDEFType4::command(const uint8_t *apdu, uint16_t apduLen, PN5180DataSink sink, void *context, uint16_t *dataLen)
+{
+	T4Sink s = {sink, context, {0, 0}, 0, 0};
+	lastSW = 0;
+	bool ok = nfc.exchange(apdu, (uint32_t)apduLen, t4SinkData, &s);
+	if (dataLen)
+		*dataLen = s.dataLen;
+	if (!ok || s.heldLen != 2)
+		return false;
+	lastSW = ((uint16_t)s.held[0] << 8) | s.held[1];
+	return lastSW == 0x9000;
+}
+
+// SELECT файла по идентификатору, без FCI в ответе (P2 = 0C)
+bool PN5180NDEFType4::selectFile(uint16_t id)
+{
+	uint8_t apdu[7] = {0x00, 0xA4, 0x00, 0x0C, 0x02, (uint8_t)(id >> 8), (uint8_t)(id & 0xFF)};
+	return command(apdu, sizeof(apdu), 0, 0, 0);
+}
+
+bool PN5180NDEFType4::readBinary(uint16_t offset, uint8_t len, PN5180DataSink sink, void *context)
+{
+	uint8_t apdu[5] = {0x00, 0xB0, (uint8_t)(offset >> 8), (uint8_t)(offset & 0xFF), len};
+	uint16_t received;
+	return command(apdu, sizeof(apdu), sink, context, &received) && received == len;
+}
+
+bool PN5180NDEFType4::updateBinary(uint16_t offset, const uint8_t *data, uint8_t len)
+{
+	uint8_t apdu[5 + NDEF_T4_MAX_LC] = {0x00, 0xD6, (uint8_t)(offset >> 8), (uint8_t)(offset & 0xFF), len};
+	memcpy(apdu + 5, data, len);
+	return command(apdu, 5 + len, 0, 0, 0);
+}
+
+/*
+ * Выбор NDEF-приложения и разбор Capability Container:
+ * SELECT NDEF application, SELECT CC (E103), READ BINARY 15 байт, SELECT NDEF file.
+ * CC: CCLEN(2), версия, MLe(2), MLc(2), NDEF File Control TLV
+ *     (04 06, ID файла(2), макс. размер(2), доступ на чтение, доступ на запись).
+ */
+bool PN5180NDEFType4::select()
+{
+	selected = false;
+	writing = false;
+	if (!command(selectNdefApp, sizeof(selectNdefApp), 0, 0, 0))
+		return false;
+	if (!selectFile(NDEF_T4_CC_FILE))
+		return false;
+
+	uint8_t cc[NDEF_T4_CC_LEN + 2];
+	uint16_t len = sizeof(cc);
+	uint8_t apdu[5] = {0x00, 0xB0, 0x00, 0x00, NDEF_T4_CC_LEN};
+	if (!nfc.exchange(apdu, (uint16_t)sizeof(apdu), cc, &len) || len != sizeof(cc))
+		return false;
+	lastSW = ((uint16_t)cc[NDEF_T4_CC_LEN] << 8) | cc[NDEF_T4_CC_LEN + 1];
+	if (lastSW != 0x9000)
+		return false;
+	if (cc[7] != 0x04 || cc[8] < 0x06)
+		return false;
+
+	mle = ((uint16_t)cc[3] << 8) | cc[4];
+	mlc = ((uint16_t)cc[5] << 8) | cc[6];
+	fileId = ((uint16_t)cc[9] << 8) | cc[10];
+	maxFileSize = ((uint16_t)cc[11] << 8) | cc[12];
+	readAccess = cc[13];
+	writeAccess = cc[14];
+	if (mle < 1 || mlc < 1 || maxFileSize < 2 || readAccess != 0x00)
+		return false;
+	if (mle > NDEF_T4_MAX_LE)
+		mle = NDEF_T4_MAX_LE;
+	if (mlc > NDEF_T4_MAX_LC)
+		mlc = NDEF_T4_MAX_LC;
+
+	if (!selectFile(fileId))
+		return false;
+	selected = true;
+	return true;
+}
+
+/*
+ * Чтение сообщения NDEF из файла: NLEN (2 байта), затем READ BINARY кусками не больше MLe.
+ * Данные передаются в sink по мере приёма, без буфера под всё сообщение.
+ * messageLength : если не 0 — длина сообщения (NLEN)
+ */
+bool PN5180NDEFType4::readRaw(PN5180DataSink sink, void *context, uint16_t *messageLength)
+{
+	if (!selected)
+		return false;
+
+	// NLEN и SW
+	uint8_t resp[4];
+	uint16_t len = sizeof(resp);
+	uint8_t apdu[5] = {0x00, 0xB0, 0x00, 0x00, 0x02};
+	if (!nfc.exchange(apdu, (uint16_t)sizeof(apdu), resp, &len) || len != 4)
+		return false;
+	lastSW = ((uint16_t)resp[2] << 8) | resp[3];
+	if (lastSW != 0x9000)
+		return false;
+	uint16_t total = ((uint16_t)resp[0] << 8) | resp[1];
+	if (total > maxFileSize - 2)
+		return false;
+	if (messageLength)
+		*messageLength = total;
+
+	uint16_t offset = 2;
+	while (offset < total + 2)
+	{
+		uint16_t chunk = total + 2 - offset;
+		if (chunk > mle)
+			chunk = mle;
+		if (!readBinary(offset, chunk, sink, context))
+			return false;
+		offset += chunk;
+	}
+	return true;
+}
+
+/*
+ * Чтение с разбором записей на лету (см. NDEFParser).
+ *
+ * возвращаемое значение: NDEF_PARSE_DONE, NDEF_PARSE_ERROR (в т.ч. ошибка обмена) или NDEF_PARSE_ABORTED
+ */
+uint8_t PN5180NDEFType4::read(NDEFRecordCallback callback, void *context)
+{
+	NDEFParser parser;
+	parser.begin(callback, context, false);
+	uint16_t total = 0;
+	bool ok = readRaw(t4SinkParser, &parser, &total);
+	uint8_t status = parser.getStatus();
+	if (status == NDEF_PARSE_ABORTED || status == NDEF_PARSE_ERROR)
+		return status;
+	if (!ok)
+		return NDEF_PARSE_ERROR;
+	// Пустой файл (NLEN = 0) — пустое сообщение; иначе файл не должен кончаться раньше записи с ME
+	return (status == NDEF_PARSE_DONE || total == 0) ? NDEF_PARSE_DONE : NDEF_PARSE_ERROR;
+}
+
+/*
+ * Начало записи сообщения длиной messageLength байт.
+ * Сначала NLEN = 0: прерванная запись оставляет пустое, а не повреждённое сообщение.
+ */
+bool PN5180NDEFType4::beginWrite(uint16_t messageLength)
+{
+	writing = false;
+	if (!isWritable() || messageLength > maxFileSize - 2)
+		return false;
+	uint8_t zero[2] = {0x00, 0x00};
+	if (!updateBinary(0, zero, 2))
+		return false;
+	writeLength = messageLength;
+	writeOffset = 2;
+	writing = true;
+	return true;
+}
+
+// Данные пишутся сразу, кусками не больше MLc
+bool PN5180NDEFType4::write(const uint8_t *data, uint16_t len)
+{
+	if (!writing || writeOffset - 2 + len > writeLength)
+		return false;
+	while (len > 0)
+	{
+		uint8_t chunk = (len > mlc) ? mlc : len;
+		if (!updateBinary(writeOffset, data, chunk))
+		{
+			writing = false;
+			return false;
+		}
+		writeOffset += chunk;
+		data += chunk;
+		len -= chunk;
+	}
+	return true;
+}
+
+// Завершение записи: настоящая длина сообщения в NLEN
+bool PN5180NDEFType4::endWrite()
+{
+	if (!writing || writeOffset - 2 != writeLength)
+		return false;
+	writing = false;
+	uint8_t nlen[2] = {(uint8_t)(writeLength >> 8), (uint8_t)(writeLength & 0xFF)};
+	return updateBinary(0, nlen, 2);
+}
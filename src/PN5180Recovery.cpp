@@ -0,0 +1,197 @@
+// NAME: PN5180Recovery.cpp
+//
+// DESC: Восстановление после неожиданного IRQ_STATUS: самое дешёвое действие,
+//       устраняющее причину, вместо полного сброса на каждую ошибку.
+//
+// Этот файл является частью библиотеки PN5180 для среды Arduino.
+//
+// Эта библиотека является свободным программным обеспечением; вы можете распространять и/или
+// изменять её на условиях Стандартной Общественной Лицензии GNU (LGPL) версии 2.1
+// либо (по вашему выбору) любой более поздней версии.
+//
+// Эта библиотека распространяется в надежде, что она будет полезной,
+// но БЕЗ КАКИХ-ЛИБО ГАРАНТИЙ; даже без подразумеваемой гарантии
+// КОММЕРЧЕСКОЙ ЦЕННОСТИ или ПРИГОДНОСТИ ДЛЯ ОПРЕДЕЛЕННОЙ ЦЕЛИ. Подробнее см. в
+// Стандартной Общественной Лицензии GNU.
+//
+//
+// #define DEBUG 1
+
+#include <Arduino.h>
+#include "PN5180Recovery.h"
+#include "Debug.h"
+
+PN5180Recovery::PN5180Recovery(PN5180ISO14443 &nfc)
+	: nfc(nfc)
+{
+	lastCause = RECOVERY_CAUSE_NONE;
+	lastAction = RECOVERY_ACTION_NONE;
+	repeats = 0;
+	lastTime = 0;
+	resetStats();
+}
+
+/*
+ * Причина по битам IRQ_STATUS, от самой тяжёлой к самой лёгкой.
+ * 0xFFFFFFFF и одновременные TX_RFON/TX_RFOFF с RF_ACTIVE_ERROR — не состояние
+ * микросхемы, а чтение без питания или с оборванным MISO.
+ */
+uint8_t PN5180Recovery::classify(uint32_t irqStatus)
+{
+	if (irqStatus == 0xFFFFFFFFUL || (irqStatus & HV_ERROR_IRQ_STAT))
+		return RECOVERY_CAUSE_HV;
+	if ((irqStatus & (TX_RFON_IRQ_STAT | TX_RFOFF_IRQ_STAT | RF_ACTIVE_ERROR_IRQ_STAT)) == (TX_RFON_IRQ_STAT | TX_RFOFF_IRQ_STAT | RF_ACTIVE_ERROR_IRQ_STAT))
+		return RECOVERY_CAUSE_HV;
+	if (irqStatus & TEMPSENS_ERROR_IRQ_STAT)
+		return RECOVERY_CAUSE_TEMP;
+	if (irqStatus & RF_ACTIVE_ERROR_IRQ_STAT)
+		return RECOVERY_CAUSE_RF_ACTIVE;
+	if (irqStatus & TX_RFOFF_IRQ_STAT)
+		return RECOVERY_CAUSE_RF_OFF;
+	if (irqStatus & RX_IRQ_STAT)
+	{
+		uint32_t rxStatus = 0;
+		if (nfc.readRegister(RX_STATUS, &rxStatus) && (rxStatus & (RX_COLLISION_DETECTED | RX_DATA_INTEGRITY_ERROR | RX_PROTOCOL_ERROR)))
+			return RECOVERY_CAUSE_COLLISION;
+	}
+	else if (irqStatus & GENERAL_ERROR_IRQ_STAT)
+	{
+		return RECOVERY_CAUSE_GENERAL;
+	}
+	return (irqStatus == 0) ? RECOVERY_CAUSE_NONE : RECOVERY_CAUSE_UNKNOWN;
+}
+
+uint8_t PN5180Recovery::actionFor(uint8_t cause)
+{
+	switch (cause)
+	{
+	case RECOVERY_CAUSE_NONE:
+		return RECOVERY_ACTION_NONE;
+	case RECOVERY_CAUSE_COLLISION: // несколько карт — повторить опрос
+		return RECOVERY_ACTION_CLEAR;
+	case RECOVERY_CAUSE_GENERAL:
+	case RECOVERY_CAUSE_UNKNOWN:
+		return RECOVERY_ACTION_IDLE;
+	case RECOVERY_CAUSE_TEMP: // поле выключил датчик; включит его PN5180Thermal::rest() после паузы
+		return RECOVERY_ACTION_CLEAR;
+	case RECOVERY_CAUSE_RF_OFF:
+	case RECOVERY_CAUSE_RF_ACTIVE:
+		return RECOVERY_ACTION_RF;
+	default:
+		return RECOVERY_ACTION_RESET;
+	}
+}
+
+/*
+ * Выполняет действие; false — проверка после него не прошла.
+ * Каждое действие включает предыдущие: сброс IRQ нужен и после перезапуска поля.
+ */
+bool PN5180Recovery::apply(uint8_t action)
+{
+	switch (action)
+	{
+	case RECOVERY_ACTION_CLEAR:
+		return nfc.clearIRQStatus(0xFFFFFFFFUL);
+	case RECOVERY_ACTION_IDLE:
+		// Команда Idle/StopCom; sendData() снова включит Transceive
+		return nfc.writeRegisterWithAndMask(SYSTEM_CONFIG, 0xFFFFFFF8) && nfc.clearIRQStatus(0xFFFFFFFFUL);
+	case RECOVERY_ACTION_RF:
+	{
+		nfc.setRF_off();
+		// После потери питания конфигурация RF могла пропасть — загружаем заново
+		nfc.invalidateRFConfig();
+		bool ok = nfc.setupRF();
+		return nfc.clearIRQStatus(0xFFFFFFFFUL) && ok;
+	}
+	case RECOVERY_ACTION_RESET:
+	{
+		if (nfc.fastStart() != PN5180_START_OK)
+			return false;
+		return nfc.setupRF();
+	}
+	default:
+		return true;
+	}
+}
+
+/*
+ * Действие по причине; если та же причина уже потребовала восстановления
+ * RECOVERY_ESCALATE_COUNT раз за RECOVERY_ESCALATE_WINDOW_MS, прежнее действие
+ * не помогает и берётся следующее. Не прошедшая проверку попытка тоже повышает уровень.
+ * Коллизии и перегрев уровень не повышают: причина первых — несколько карт в поле,
+ * а после перегрева перезапуск поля лишь снова нагреет кристалл.
+ */
+uint8_t PN5180Recovery::recover(uint32_t irqStatus)
+{
+	uint8_t cause = classify(irqStatus);
+	stats.causes[cause]++;
+	if (cause == RECOVERY_CAUSE_TEMP)
+		nfc.markRFOff(); // поле уже выключено датчиком
+	uint8_t action = actionFor(cause);
+	if (action == RECOVERY_ACTION_NONE)
+		return RECOVERY_ACTION_NONE;
+
+	bool escalate = cause != RECOVERY_CAUSE_COLLISION && cause != RECOVERY_CAUSE_TEMP;
+	uint32_t now = millis();
+	if (cause == lastCause && escalate && now - lastTime < RECOVERY_ESCALATE_WINDOW_MS)
+	{
+		if (lastAction > action)
+			action = lastAction;
+		if (++repeats >= RECOVERY_ESCALATE_COUNT && action < RECOVERY_ACTION_RESET)
+		{
+			action++;
+			repeats = 0;
+			stats.escalations++;
+		}
+	}
+	else
+	{
+		repeats = 0;
+	}
+	lastCause = cause;
+
+	for (;;)
+	{
+		uint32_t start = micros();
+		bool ok = apply(action);
+		uint32_t elapsed = micros() - start;
+		stats.actions[action]++;
+		stats.timeSum[action] += elapsed;
+		if (elapsed > stats.timeMax[action])
+			stats.timeMax[action] = elapsed;
+		PN5180DEBUG(F("Recovery: cause "));
+		PN5180DEBUG(cause);
+		PN5180DEBUG(F(", action "));
+		PN5180DEBUG(action);
+		PN5180DEBUG(F(", ok "));
+		PN5180DEBUG(ok);
+		PN5180DEBUG("\n");
+		if (ok)
+			break;
+		if (action == RECOVERY_ACTION_RESET || cause == RECOVERY_CAUSE_TEMP)
+		{
+			stats.failures++;
+			break;
+		}
+		action++;
+		stats.escalations++;
+	}
+	lastAction = action;
+	lastTime = millis();
+	return action;
+}
+
+uint8_t PN5180Recovery::getLastCause() const
+{
+	return lastCause;
+}
+
+const PN5180RecoveryStats &PN5180Recovery::getStats() const
+{
+	return stats;
+}
+
+void PN5180Recovery::resetStats()
+{
+	memset(&stats, 0, sizeof(stats));
+}
@@ -0,0 +1,229 @@
+// NAME: PN5180Thermal.cpp
+//
+// DESC: Тепловой режим: по датчику температуры кристалла увеличивает паузу между
+//       опросами (поле в паузе выключено) и снижает ступень драйвера TX,
+//       после остывания возвращает полную производительность.
+//
+// Этот файл является частью библиотеки PN5180 для среды Arduino.
+//
+// Эта библиотека является свободным программным обеспечением; вы можете распространять и/или
+// изменять её на условиях Стандартной Общественной Лицензии GNU (LGPL) версии 2.1
+// либо (по вашему выбору) любой более поздней версии.
+//
+// Эта библиотека распространяется в надежде, что она будет полезной,
+// но БЕЗ КАКИХ-ЛИБО ГАРАНТИЙ; даже без подразумеваемой гарантии
+// КОММЕРЧЕСКОЙ ЦЕННОСТИ или ПРИГОДНОСТИ ДЛЯ ОПРЕДЕЛЕННОЙ ЦЕЛИ. Подробнее см. в
+// Стандартной Общественной Лицензии GNU.
+//
+//
+// #define DEBUG 1
+
+#include <Arduino.h>
+#include "PN5180Thermal.h"
+#include "Debug.h"
+
+/*
+ * Действия по уровням. Пауза с выключенным полем снижает средний нагрев
+ * пропорционально скважности; снижение ступени драйвера уменьшает ток TX
+ * и в активной части цикла.
+ */
+static const uint16_t levelInterval[THERMAL_LEVELS] PROGMEM = { 0, 50, 200, 1000 };
+static const uint8_t levelGearDrop[THERMAL_LEVELS] PROGMEM = { 0, 0, 1, 2 };
+
+PN5180Thermal::PN5180Thermal(PN5180 &nfc)
+	: nfc(nfc)
+{
+	level = 0;
+	baseGear = 0;
+	dirty = false;
+	fieldCut = false;
+	startTime = 0;
+	levelTime = 0;
+	sampleTime = 0;
+	offTime = 0;
+	alarms = 0;
+	totalAlarms = 0;
+	seriesHead = 0;
+	seriesCount = 0;
+}
+
+/*
+ * Отдельного чтения температуры у PN5180 нет: датчик — компаратор с порогом
+ * TEMP_DELTA, и на пороге PN5180 сам выключает поле. При самом низком пороге
+ * это случается задолго до предела кристалла уже на уровне 0, а бит
+ * TEMPSENS_ERROR приходит в IRQ_STATUS, который loop() читает и так.
+ */
+bool PN5180Thermal::begin() {
+	uint32_t value;
+	if (!nfc.readRegister(AGC_REF_CONFIG, &value)) return false;
+	baseGear = (value & AGC_REF_CONFIG_GEAR_MASK) >> AGC_REF_CONFIG_GEAR_SHIFT;
+	PN5180::setRFConfigHook(onRFConfigLoaded, this);
+
+	uint32_t now = millis();
+	startTime = now;
+	levelTime = now;
+	sampleTime = now;
+	offTime = 0;
+	alarms = 0;
+	return applyConfig();
+}
+
+/*
+ * Порог датчика и ступень драйвера для текущего уровня. Оба регистра
+ * теряются при сбросе, ступень — и при LOAD_RF_CONFIG (её восстанавливает
+ * onRFConfigLoaded()).
+ */
+bool PN5180Thermal::applyConfig() {
+	uint32_t value;
+	if (!nfc.readRegister(TEMP_CONTROL, &value)) return false;
+	value = (value & ~TEMP_CONTROL_DELTA_MASK) | (THERMAL_TEMP_DELTA & TEMP_CONTROL_DELTA_MASK);
+	if (!nfc.writeRegister(TEMP_CONTROL, value)) return false;
+
+	if (!applyGear(nfc, false)) return false;
+	dirty = false;
+	return true;
+}
+
+/*
+ * Ступень драйвера уровня поверх базовой. Сразу после LOAD_RF_CONFIG в регистре
+ * базовая ступень именно этой конфигурации (у Type A, B, F и V она своя) —
+ * тогда её и запоминаем; на уровне без снижения писать нечего.
+ */
+bool PN5180Thermal::applyGear(PN5180 &chip, bool readBase) {
+	uint32_t value;
+	if (!chip.readRegister(AGC_REF_CONFIG, &value)) return false;
+	if (readBase) {
+		baseGear = (value & AGC_REF_CONFIG_GEAR_MASK) >> AGC_REF_CONFIG_GEAR_SHIFT;
+		if (pgm_read_byte(&levelGearDrop[level]) == 0) return true;
+	}
+	value = (value & ~AGC_REF_CONFIG_GEAR_MASK) | ((uint32_t)gear() << AGC_REF_CONFIG_GEAR_SHIFT);
+	return chip.writeRegister(AGC_REF_CONFIG, value);
+}
+
+// LOAD_RF_CONFIG любым объектом на этом PN5180 (PN5180Discovery — при каждой смене технологии)
+void PN5180Thermal::onRFConfigLoaded(PN5180 &chip, void *context) {
+	PN5180Thermal *thermal = (PN5180Thermal *)context;
+	if (!thermal->applyGear(chip, true))
+		thermal->dirty = true;
+}
+
+void PN5180Thermal::setLevel(uint8_t newLevel, uint32_t now) {
+	PN5180DEBUG(F("Thermal level "));
+	PN5180DEBUG(newLevel);
+	PN5180DEBUG(F("\n"));
+	if (pgm_read_byte(&levelGearDrop[newLevel]) != pgm_read_byte(&levelGearDrop[level])) {
+		dirty = true;
+	}
+	level = newLevel;
+	levelTime = now;
+}
+
+void PN5180Thermal::takeSample(uint32_t now) {
+	uint32_t span = now - sampleTime;
+	PN5180ThermalSample &sample = series[seriesHead];
+	sample.time = (now - startTime) / 1000;
+	sample.level = level;
+	sample.duty = (offTime >= span) ? 0 : 100 - (offTime * 100) / span;
+	sample.alarms = alarms;
+	seriesHead = (seriesHead + 1) % THERMAL_SERIES_LEN;
+	if (seriesCount < THERMAL_SERIES_LEN) seriesCount++;
+
+	sampleTime = now;
+	offTime = 0;
+	alarms = 0;
+}
+
+/*
+ * Тревога поднимает уровень сразу; вниз — по одному уровню после
+ * THERMAL_COOLDOWN_MS без тревог, чтобы не раскачиваться у порога.
+ * Регистры пишутся, когда IRQ_STATUS чист: при тревоге PN5180Recovery только
+ * сбрасывает IRQ, и ступень уходит в драйвер при следующем вызове.
+ */
+bool PN5180Thermal::update(uint32_t irqStatus) {
+	uint32_t now = millis();
+	bool changed = false;
+
+	if (irqStatus & TEMPSENS_ERROR_IRQ_STAT) {
+		fieldCut = true;
+		alarms++;
+		totalAlarms++;
+		if (level < THERMAL_LEVELS - 1) {
+			setLevel(level + 1, now);
+			changed = true;
+		}
+		levelTime = now;
+	}
+	else {
+		if (level > 0 && now - levelTime >= THERMAL_COOLDOWN_MS) {
+			setLevel(level - 1, now);
+			changed = true;
+		}
+		if (dirty) applyConfig();
+	}
+
+	if (now - sampleTime >= THERMAL_SAMPLE_MS) takeSample(now);
+	return changed;
+}
+
+void PN5180Thermal::invalidate() {
+	dirty = true;
+}
+
+void PN5180Thermal::rest(void (*wait)(unsigned long ms)) {
+	uint16_t interval = pollInterval();
+	if (interval == 0 && !fieldCut) return;
+	// При выключении поля между опросами (PN5180Discovery) оно уже выключено.
+	// После TEMPSENS_ERROR поле выключил датчик: RF_OFF не дал бы TX_RFOFF_IRQ,
+	// поэтому только пауза и RF_ON — выход из перегрева.
+	bool restore = nfc.isRFOn() || fieldCut;
+	uint32_t start = millis();
+	if (fieldCut)
+		nfc.markRFOff();
+	else if (restore)
+		nfc.setRF_off();
+	fieldCut = false;
+	wait(interval);
+	if (restore)
+		nfc.setRF_on();
+	offTime += millis() - start;
+}
+
+uint8_t PN5180Thermal::getLevel() const {
+	return level;
+}
+
+uint16_t PN5180Thermal::pollInterval() const {
+	return pgm_read_word(&levelInterval[level]);
+}
+
+uint8_t PN5180Thermal::gear() const {
+	uint8_t drop = pgm_read_byte(&levelGearDrop[level]);
+	return (baseGear > drop) ? baseGear - drop : 0;
+}
+
+uint16_t PN5180Thermal::getAlarms() const {
+	return totalAlarms;
+}
+
+uint8_t PN5180Thermal::getSampleCount() const {
+	return seriesCount;
+}
+
+const PN5180ThermalSample &PN5180Thermal::getSample(uint8_t index) const {
+	uint8_t first = (seriesHead + THERMAL_SERIES_LEN - seriesCount) % THERMAL_SERIES_LEN;
+	return series[(first + index) % THERMAL_SERIES_LEN];
+}
+
+void PN5180Thermal::printSeries(Print &out) const {
+	out.println(F("time_s,level,duty_pct,alarms"));
+	for (uint8_t i = 0; i < seriesCount; i++) {
+		const PN5180ThermalSample &sample = getSample(i);
+		out.print(sample.time);
+		out.print(',');
+		out.print(sample.level);
+		out.print(',');
+		out.print(sample.duty);
+		out.print(',');
+		out.println(sample.alarms);
+	}
+}
@@ -0,0 +1,209 @@
+// NAME: PN5180Tuning.cpp
+//
+// DESC: Калибровка RF на устройстве: перебор ступеней драйвера TX, AGC без карты
+//       и с эталонной картой, время активации; лучшая настройка сохраняется в EEPROM.
+//
+// Этот файл является частью библиотеки PN5180 для среды Arduino.
+//
+// Эта библиотека является свободным программным обеспечением; вы можете распространять и/или
+// изменять её на условиях Стандартной Общественной Лицензии GNU (LGPL) версии 2.1
+// либо (по вашему выбору) любой более поздней версии.
+//
+// Эта библиотека распространяется в надежде, что она будет полезной,
+// но БЕЗ КАКИХ-ЛИБО ГАРАНТИЙ; даже без подразумеваемой гарантии
+// КОММЕРЧЕСКОЙ ЦЕННОСТИ или ПРИГОДНОСТИ ДЛЯ ОПРЕДЕЛЕННОЙ ЦЕЛИ. Подробнее см. в
+// Стандартной Общественной Лицензии GNU.
+//
+//
+// #define DEBUG 1
+
+#include <Arduino.h>
+#include "PN5180Tuning.h"
+#include "Debug.h"
+
+PN5180Tuning::PN5180Tuning(PN5180ISO14443 &nfc)
+	: nfc(nfc)
+{
+	memset(steps, 0, sizeof(steps));
+	savedRefConfig = 0;
+	attempts = 0;
+	idleMeasured = false;
+}
+
+/*
+ * Ступень драйвера меняется при включённом поле; AGC нужно несколько
+ * миллисекунд, чтобы выйти на новое значение.
+ */
+bool PN5180Tuning::selectGear(uint8_t gear) {
+	uint32_t value = (savedRefConfig & ~AGC_REF_CONFIG_GEAR_MASK) | ((uint32_t)gear << AGC_REF_CONFIG_GEAR_SHIFT);
+	if (!nfc.writeRegister(AGC_REF_CONFIG, value)) return false;
+	delay(PN5180_TUNE_SETTLE_MS);
+	return true;
+}
+
+bool PN5180Tuning::readAgc(uint16_t *agc) {
+	uint32_t value;
+	if (!nfc.readRegister(AGC_VALUE, &value)) return false;
+	*agc = value & AGC_VALUE_MASK;
+	return true;
+}
+
+bool PN5180Tuning::restore() {
+	return nfc.writeRegister(AGC_REF_CONFIG, savedRefConfig);
+}
+
+/*
+ * AGC без карты — нагрузка самой антенны на каждой ступени. Это значение
+ * становится опорным для DPC: регулятор держит поле таким, каким оно было
+ * в пустом пространстве, когда карта или металл рядом расстраивают антенну.
+ */
+bool PN5180Tuning::measureIdle() {
+	if (!nfc.setupRF()) return false;
+	if (!nfc.readRegister(AGC_REF_CONFIG, &savedRefConfig)) return false;
+
+	for (uint8_t gear = 0; gear < PN5180_TUNE_GEARS; gear++) {
+		if (!selectGear(gear) || !readAgc(&steps[gear].agcIdle)) {
+			restore();
+			return false;
+		}
+		PN5180DEBUG(F("Gear "));
+		PN5180DEBUG(gear);
+		PN5180DEBUG(F(": AGC idle="));
+		PN5180DEBUG(steps[gear].agcIdle);
+		PN5180DEBUG(F("\n"));
+	}
+	idleMeasured = true;
+	return restore();
+}
+
+bool PN5180Tuning::cardPresent() {
+	uint8_t buffer[10];
+	uint8_t uidLength = nfc.activateTypeA(buffer, 1);
+	if (uidLength > 0) nfc.mifareHalt();
+	return uidLength > 0;
+}
+
+/*
+ * На каждой ступени: AGC с картой и attempts активаций WUPA -> SELECT -> HLTA.
+ * HLTA возвращает карту в HALT, поэтому каждая следующая WUPA — полная
+ * активация, как при новом поднесении карты.
+ */
+bool PN5180Tuning::measureCard(uint8_t attempts) {
+	if (!nfc.setupRF()) return false;
+	if (!nfc.readRegister(AGC_REF_CONFIG, &savedRefConfig)) return false;
+	this->attempts = attempts;
+
+	uint8_t buffer[10];
+	for (uint8_t gear = 0; gear < PN5180_TUNE_GEARS; gear++) {
+		PN5180TuningStep &step = steps[gear];
+		step.successes = 0;
+		step.timeSum = 0;
+		step.timeMax = 0;
+		if (!selectGear(gear) || !readAgc(&step.agcCard)) {
+			restore();
+			return false;
+		}
+
+		for (uint8_t i = 0; i < attempts; i++) {
+			uint32_t start = micros();
+			uint8_t uidLength = nfc.activateTypeA(buffer, 1);
+			uint32_t elapsed = micros() - start;
+			if (uidLength == 0) continue;
+			nfc.mifareHalt();
+			step.successes++;
+			step.timeSum += elapsed;
+			if (elapsed > step.timeMax) step.timeMax = elapsed;
+		}
+		PN5180DEBUG(F("Gear "));
+		PN5180DEBUG(gear);
+		PN5180DEBUG(F(": AGC card="));
+		PN5180DEBUG(step.agcCard);
+		PN5180DEBUG(F(", ok="));
+		PN5180DEBUG(step.successes);
+		PN5180DEBUG(F("\n"));
+	}
+	return restore();
+}
+
+/*
+ * Надёжность важнее скорости: сначала число удачных активаций, затем
+ * среднее время активации, затем изменение AGC от карты (сильнее связь
+ * с картой — больше запас по дальности).
+ */
+int8_t PN5180Tuning::best() const {
+	int8_t bestGear = -1;
+	uint32_t bestMean = 0;
+	uint16_t bestDelta = 0;
+	for (uint8_t gear = 0; gear < PN5180_TUNE_GEARS; gear++) {
+		const PN5180TuningStep &step = steps[gear];
+		if (step.successes == 0) continue;
+		uint32_t mean = step.timeSum / step.successes;
+		uint16_t delta = (step.agcIdle > step.agcCard) ? step.agcIdle - step.agcCard : step.agcCard - step.agcIdle;
+		bool better;
+		if (bestGear < 0) better = true;
+		else if (step.successes != steps[bestGear].successes) better = step.successes > steps[bestGear].successes;
+		else if (mean != bestMean) better = mean < bestMean;
+		else better = delta > bestDelta;
+		if (better) {
+			bestGear = gear;
+			bestMean = mean;
+			bestDelta = delta;
+		}
+	}
+	return bestGear;
+}
+
+const PN5180TuningStep &PN5180Tuning::getStep(uint8_t gear) const {
+	return steps[gear];
+}
+
+/*
+ * Ступень и опорное значение AGC записываются в таблицу RF-конфигурации
+ * ISO14443A 106 кбит/с: их применяет каждый LOAD_RF_CONFIG, в том числе
+ * после сброса. Бит включения DPC — через профиль EEPROM, только если он
+ * ещё не установлен.
+ */
+uint8_t PN5180Tuning::store(int8_t gear) {
+	if (gear < 0 || gear >= PN5180_TUNE_GEARS || attempts == 0 || !idleMeasured) return EECFG_WRITE_ERROR;
+
+	uint32_t value = savedRefConfig & ~(AGC_REF_CONFIG_GEAR_MASK | AGC_REF_CONFIG_REF_MASK);
+	value |= (uint32_t)gear << AGC_REF_CONFIG_GEAR_SHIFT;
+	value |= steps[gear].agcIdle & AGC_REF_CONFIG_REF_MASK;
+
+	nfc.clearIRQStatus(GENERAL_ERROR_IRQ_STAT);
+	if (!nfc.updateRFConfig(ISO14443A_TX_CONFIG_106, AGC_REF_CONFIG, value)) return EECFG_WRITE_ERROR;
+	if (nfc.getIRQStatus() & GENERAL_ERROR_IRQ_STAT) return EECFG_WRITE_ERROR;
+
+	PN5180EepromConfig config(nfc);
+	PN5180EepromProfile profile;
+	if (!config.read(profile)) return EECFG_READ_ERROR;
+	profile.fields = (1u << EECFG_DPC_CONTROL);
+	profile.dpcControl |= DPC_CONTROL_ENABLE;
+	uint8_t result = config.apply(profile);
+
+	nfc.setupRF();
+	return result;
+}
+
+void PN5180Tuning::print(Print &out) const {
+	int8_t bestGear = best();
+	out.println(F("gear agcIdle agcCard ok avgUs maxUs"));
+	for (uint8_t gear = 0; gear < PN5180_TUNE_GEARS; gear++) {
+		const PN5180TuningStep &step = steps[gear];
+		out.print(gear);
+		out.print(' ');
+		out.print(step.agcIdle);
+		out.print(' ');
+		out.print(step.agcCard);
+		out.print(' ');
+		out.print(step.successes);
+		out.print('/');
+		out.print(attempts);
+		out.print(' ');
+		out.print(step.successes ? step.timeSum / step.successes : 0);
+		out.print(' ');
+		out.print(step.timeMax);
+		if (gear == bestGear) out.print(F(" *"));
+		out.println();
+	}
+}
@@ -0,0 +1,175 @@
+// NAME: PN5180TxRing.cpp
+//
+// DESC: Кольцевой буфер вывода: Serial не блокирует цикл опроса,
+//       при переполнении отбрасываются сообщения низкого приоритета.
+//
+// Этот файл является частью библиотеки PN5180 для среды Arduino.
+//
+// Эта библиотека является свободным программным обеспечением; вы можете распространять и/или
+// изменять её на условиях Стандартной Общественной Лицензии GNU (LGPL) версии 2.1
+// либо (по вашему выбору) любой более поздней версии.
+//
+// Эта библиотека распространяется в надежде, что она будет полезной,
+// но БЕЗ КАКИХ-ЛИБО ГАРАНТИЙ; даже без подразумеваемой гарантии
+// КОММЕРЧЕСКОЙ ЦЕННОСТИ или ПРИГОДНОСТИ ДЛЯ ОПРЕДЕЛЕННОЙ ЦЕЛИ. Подробнее см. в
+// Стандартной Общественной Лицензии GNU.
+//
+//
+
+#include <Arduino.h>
+#include "PN5180TxRing.h"
+
+PN5180TxRing::PN5180TxRing(Print &out)
+	: out(out)
+{
+	head = 0;
+	tail = 0;
+	resetStats();
+}
+
+uint16_t PN5180TxRing::used() const
+{
+	return (head + PN5180_TX_RING_SIZE - tail) % PN5180_TX_RING_SIZE;
+}
+
+// Одна ячейка всегда свободна, чтобы отличать пустое кольцо от полного
+uint16_t PN5180TxRing::available() const
+{
+	return PN5180_TX_RING_SIZE - 1 - used();
+}
+
+/*
+ * Байт низкого приоритета не занимает последние PN5180_TX_RESERVE байт:
+ * событиям всегда остаётся место.
+ */
+bool PN5180TxRing::put(uint8_t c, uint8_t priority)
+{
+	service();
+	uint16_t limit = (priority == PN5180_TX_LOW) ? PN5180_TX_RESERVE : 0;
+	if (available() <= limit)
+		return false;
+	buffer[head] = c;
+	head = (head + 1) % PN5180_TX_RING_SIZE;
+	stats.bytes++;
+	if (used() > stats.maxUsed)
+		stats.maxUsed = used();
+	return true;
+}
+
+// Блок высокого приоритета (кадр события) — целиком или никак
+bool PN5180TxRing::put(const uint8_t *data, uint16_t len)
+{
+	service();
+	if (available() < len)
+	{
+		stats.droppedMessages++;
+		stats.droppedBytes += len;
+		return false;
+	}
+	while (len--)
+	{
+		buffer[head] = *data++;
+		head = (head + 1) % PN5180_TX_RING_SIZE;
+		stats.bytes++;
+	}
+	if (used() > stats.maxUsed)
+		stats.maxUsed = used();
+	return true;
+}
+
+// Отдаёт порту столько, сколько он примет без ожидания
+void PN5180TxRing::service()
+{
+	int room = out.availableForWrite();
+	while (room > 0 && tail != head)
+	{
+		// Непрерывный участок до конца кольца или до head
+		uint16_t end = (head > tail) ? head : PN5180_TX_RING_SIZE;
+		uint16_t n = end - tail;
+		if (n > (uint16_t)room)
+			n = (uint16_t)room;
+		out.write(buffer + tail, n);
+		tail = (tail + n) % PN5180_TX_RING_SIZE;
+		room -= n;
+	}
+}
+
+void PN5180TxRing::flush()
+{
+	while (tail != head)
+	{
+		uint16_t end = (head > tail) ? head : PN5180_TX_RING_SIZE;
+		out.write(buffer + tail, end - tail);
+		tail = end % PN5180_TX_RING_SIZE;
+	}
+	out.flush();
+}
+
+const PN5180TxStats &PN5180TxRing::getStats() const
+{
+	return stats;
+}
+
+void PN5180TxRing::resetStats()
+{
+	memset(&stats, 0, sizeof(stats));
+}
+
+PN5180TxChannel::PN5180TxChannel(PN5180TxRing &ring, uint8_t priority)
+	: ring(ring), priority(priority)
+{
+	midLine = false;
+	dropping = false;
+}
+
+/*
+ * Низкий приоритет: не поместившийся байт обрывает строку, остаток строки
+ * до '\n' отбрасывается. Оборванная строка закрывается переводом строки из резерва,
+ * чтобы не склеиться со следующей.
+ */
+size_t PN5180TxChannel::write(uint8_t c)
+{
+	if (priority != PN5180_TX_LOW)
+		return ring.put(&c, 1) ? 1 : 0;
+	if (dropping)
+	{
+		ring.stats.droppedBytes++;
+		if (c == '\n')
+			dropping = false;
+		return 1;
+	}
+	if (ring.put(c, PN5180_TX_LOW))
+	{
+		midLine = (c != '\n');
+		return 1;
+	}
+	ring.stats.droppedLines++;
+	ring.stats.droppedBytes++;
+	if (midLine && ring.put('\n', PN5180_TX_HIGH))
+		midLine = false;
+	dropping = (c != '\n');
+	// Для Print байт «записан»: print() не должен повторять или прерывать вывод
+	return 1;
+}
+
+size_t PN5180TxChannel::write(const uint8_t *data, size_t len)
+{
+	if (priority != PN5180_TX_LOW)
+		return ring.put(data, (uint16_t)len) ? len : 0;
+	for (size_t i = 0; i < len; i++)
+		write(data[i]);
+	return len;
+}
+
+int PN5180TxChannel::availableForWrite()
+{
+	int n = ring.available();
+	if (priority == PN5180_TX_LOW)
+		n -= PN5180_TX_RESERVE;
+	return n > 0 ? n : 0;
+}
+
+void PN5180TxChannel::flush()
+{
+	ring.flush();
+}
@@ -25,117 +25,339 @@
 
 #include <PN5180.h>
 #include <PN5180ISO14443.h>
+#include <PN5180ISO14443Session.h>
+#include <PN5180Discovery.h>
+#include <PN5180NDEFType2.h>
+#include <PN5180NDEFType4.h>
+#include <PN5180Events.h>
+#include <PN5180TxRing.h>
+#include <PN5180Recovery.h>
+#include <PN5180Tuning.h>
+#include <PN5180Thermal.h>
+#include <PN5180CardTracker.h>
+#include <PN5180Allowlist.h>
+
+// 1 — по Serial идут только двоичные кадры событий (PN5180Events.h) на высокой скорости,
+// 0 — текст для монитора порта
+#ifndef PN5180_BINARY_EVENTS
+#define PN5180_BINARY_EVENTS 0
+#endif
+// 1 — при старте калибровка RF с эталонной картой и запись лучшей настройки в EEPROM
+#ifndef PN5180_TUNE
+#define PN5180_TUNE 0
+#endif
+// 1 — поле выключено между циклами опроса и включается перед REQA/WUPA: меньше ток и нагрев
+#ifndef PN5180_FIELD_GATING
+#define PN5180_FIELD_GATING 1
+#endif
+// 1 — при старте замер поиска в списке разрешённых UID (PN5180Allowlist.h) на образе AllowlistBenchData.h
+#ifndef PN5180_ALLOWLIST_BENCH
+#define PN5180_ALLOWLIST_BENCH 0
+#endif
+#if PN5180_ALLOWLIST_BENCH
+#include "AllowlistBenchData.h"
+#endif
+#define SERIAL_BAUD_TEXT 115200 // отчёт о карте (~400 байт) уходит за ~35 мс, а не за 0,4 с
+#define SERIAL_BAUD_EVENTS 500000 // 16 МГц AVR: делитель без ошибки
 
 #define PN5180_NSS 10
 #define PN5180_BUSY 9
 #define PN5180_RST 7
 
 PN5180ISO14443 nfc(PN5180_NSS, PN5180_BUSY, PN5180_RST);
-void printCardWorkInfo();
+PN5180ISO14443Session session(nfc);
+// FeliCa и ISO15693 — тот же PN5180, другие протоколы
+PN5180FeliCa nfcF(PN5180_NSS, PN5180_BUSY, PN5180_RST);
+PN5180ISO15693 nfcV(PN5180_NSS, PN5180_BUSY, PN5180_RST);
+PN5180Discovery discovery(nfc, &nfcF, &nfcV);
+PN5180NDEFType2 ndefType2(nfc);
+PN5180NDEFType4 ndefType4(nfc);
+PN5180Recovery recovery(nfc);
+PN5180Thermal thermal(nfc);
+void onCardEvent(uint8_t event, const PN5180TrackedCard &card, void *);
+PN5180CardTracker tracker(onCardEvent);
+
+// Приёмник, отбрасывающий вывод
+class NullPrint : public Print
+{
+public:
+  size_t write(uint8_t) { return 1; }
+};
+// Весь вывод идёт через кольцо: запись не ждёт UART, при переполнении теряется текст, а не события
+PN5180TxRing txRing(Serial);
+#if PN5180_BINARY_EVENTS
+// Текст скетча в двоичном режиме не занимает линию
+NullPrint console;
+PN5180TxChannel eventOut(txRing, PN5180_TX_HIGH);
+PN5180EventWriter events(eventOut);
+#else
+PN5180TxChannel console(txRing, PN5180_TX_LOW);
+NullPrint noEvents;
+PN5180EventWriter events(noEvents);
+#endif
+void serviceDelay(unsigned long ms);
+void consoleDrain();
+void runTuning();
+void runAllowlistBench();
+
+void printCardWorkInfo(uint8_t *buffer, uint8_t uidLength);
+void printOtherCard(const PN5180DiscoveryResult &card);
+bool runApduBatch();
+void readNdefType4();
+void printHceStats();
+void readMifareClassic(uint8_t *buffer, uint8_t uidLength);
+void cardDone();
+bool printNdefRecord(uint8_t event, const NDEFRecord &record, const uint8_t *data, uint16_t len, void *);
+
+// Ключи MIFARE Classic для перебора (Key A)
+const uint8_t mifareClassicKeys[][6] = {
+    {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF}, // ключ по умолчанию
+    {0xA0, 0xA1, 0xA2, 0xA3, 0xA4, 0xA5}, // MAD
+    {0xD3, 0xF7, 0xD3, 0xF7, 0xD3, 0xF7}, // NFC Forum
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+};
+#define MIFARE_CLASSIC_SECTOR 1 // читаемый сектор
+
+// Пакет APDU, выполняемый в открытой сессии ISO-DEP
+const uint8_t apduSelectAID[] = {0x00, 0xA4, 0x04, 0x00, 0x05, 0xF0, 0x12, 0x34, 0x56, 0x78, 0x00}; // SELECT AID F0 12 34 56 78
+const uint8_t apduGetChallenge[] = {0x00, 0x84, 0x00, 0x00, 0x08};                                // GET CHALLENGE, 8 байт
+const PN5180Apdu apduBatch[] = {
+    {apduSelectAID, sizeof(apduSelectAID), APDU_SW_OK},
+    {apduGetChallenge, sizeof(apduGetChallenge), APDU_SW_ANY},
+};
+#define APDU_BATCH_INTERVAL 200 // мс между пакетами в открытой сессии
+#define START_RETRY_INTERVAL 100 // мс между попытками запуска PN5180
+
+// Собственный AID приложения на телефоне (HCE)
+const uint8_t hceAid[] = {0xF0, 0x12, 0x34, 0x56, 0x78};
 uint32_t irqStatus = 0;
 // uint32_t loopCnt = 0;
-bool errorFlag = false;
 
 void setup()
 {
-  Serial.begin(9600);
+#if PN5180_BINARY_EVENTS
+  Serial.begin(SERIAL_BAUD_EVENTS);
+#else
+  Serial.begin(SERIAL_BAUD_TEXT);
+#endif
+  pn5180Log = &console;
+#if PN5180_ALLOWLIST_BENCH
+  runAllowlistBench();
+#endif
 
-  while (nfc.PN5180_Start() == false)
+  // Короткая пауза вокруг NSS вместо 2 мс / 1 мс на каждую команду: темп команд задаёт BUSY,
+  // ответ карты перед каждым READ_DATA дожидается waitForRx()
+  PN5180::nssGuardUs = PN5180_NSS_GUARD_FAST_US;
+  uint8_t startError;
+  while ((startError = nfc.fastStart()) != PN5180_START_OK)
   {
-    Serial.println(F("PN5180 not detected!"));
-    Serial.println(F("Please check wiring and power supply!"));
-    Serial.println(F("Restarting PN5180..."));
-    Serial.flush();
-    delay(900); // wait for a second before retrying
+    console.print(F("PN5180 not detected, start error "));
+    console.println(startError);
+    console.println(F("Please check wiring and power supply!"));
+    events.error(PN5180_EVENT_ERROR_START, startError);
+    serviceDelay(START_RETRY_INTERVAL);
   }
+  events.hello(nfc.getVersions());
+#if PN5180_TUNE
+  runTuning();
+#endif
   nfc.setupRF();
+  thermal.begin();
+#if PN5180_FIELD_GATING
+  discovery.setFieldGating(true);
+#endif
+  nfc.mifareClassicSetKeys(mifareClassicKeys, sizeof(mifareClassicKeys) / sizeof(mifareClassicKeys[0]));
 }
 
 // ISO 14443 loop
 void loop()
 {
-  if (errorFlag)
+  txRing.service();
+
+  // Пока сессия ISO-DEP открыта, карта не активируется заново — сразу следующий пакет APDU
+  if (session.isOpen())
   {
-    nfc.reset();
-    nfc.setupRF();
-    errorFlag = false;
-    delay(10);
+    // Телефон заблокирован — повторяем SELECT по расписанию, не снимая поле
+    if (session.hceIsPending())
+    {
+      uint8_t resp[64];
+      uint16_t len = sizeof(resp);
+      uint8_t status = session.hcePoll(resp, &len);
+      if (status == HCE_PENDING)
+        return;
+      printHceStats();
+      if (status == HCE_FAILED)
+      {
+        session.close();
+        console.println(F("Телефон не ответил на SELECT, сессия закрыта."));
+        console.println(F("------------------------------------------------"));
+        return;
+      }
+      console.println(F("Приложение HCE выбрано."));
+    }
+
+    if (!runApduBatch())
+    {
+      session.close();
+      console.println(F("Сессия ISO-DEP закрыта."));
+      console.println(F("------------------------------------------------"));
+    }
+    serviceDelay(APDU_BATCH_INTERVAL);
+    return;
   }
 
-  // Serial.println(F("------------------------------------------------"));
-  // Serial.print(F("Loop #"));
-  // Serial.println(loopCnt++);
+  // console.println(F("------------------------------------------------"));
+  // console.print(F("Loop #"));
+  // console.println(loopCnt++);
   irqStatus = nfc.getIRQStatus();
   // nfc.showIRQStatus(irqStatus);
+  if (thermal.update(irqStatus))
+  {
+    console.print(F("Тепловой уровень "));
+    console.print(thermal.getLevel());
+    console.print(F(", пауза, мс: "));
+    console.println(thermal.pollInterval());
+  }
 
-  if (irqStatus != 0x24007 && irqStatus != 0)
+  // 0x24007 — состояние после опроса Type A; после опроса B/F/V проверяем только отключение поля
+  uint8_t tech = discovery.getTechnology();
+  bool irqError = (tech == PN5180_TECH_A || tech == PN5180_TECH_NONE) ? (irqStatus != 0x24007 && irqStatus != 0)
+                                                                      : (irqStatus & TX_RFOFF_IRQ_STAT) != 0;
+  if (irqError)
   {
-    // Serial.println(F("Error: Unexpected IRQ status (not 0x24007 or 0)"));
-    errorFlag = true;
+    // console.println(F("Error: Unexpected IRQ status (not 0x24007 or 0)"));
+    events.error(PN5180_EVENT_ERROR_IRQ, irqStatus);
+    // Самое дешёвое действие по причине; после полного сброса опрос технологий начинается заново
+    uint8_t action = recovery.recover(irqStatus);
+    if (action == RECOVERY_ACTION_RESET)
+      discovery.restart();
+    // После сброса PN5180 порог датчика потерян; ступень драйвера после LOAD_RF_CONFIG
+    // восстанавливает обработчик загрузки конфигурации
+    if (action == RECOVERY_ACTION_RESET)
+      thermal.invalidate();
+    // Перегрев: поле выключено датчиком и остаётся выключенным на паузу нового уровня
+    if (recovery.getLastCause() == RECOVERY_CAUSE_TEMP)
+      thermal.rest(serviceDelay);
     // delay(1000);
     return;
   }
 
-  printCardWorkInfo();
+  PN5180DiscoveryResult card;
+  if (discovery.poll(&card))
+  {
+    // Карта обрабатывается один раз за поднесение, повторные чтения только отмечаются
+    uint8_t track = tracker.seen(card.technology, card.uid, card.uidLength);
+    if (track == TRACKER_NEW || track == TRACKER_FULL)
+    {
+      console.print(F("Время до UID, мс: "));
+      console.println(card.ttfu);
+#if PN5180_FIELD_GATING
+      console.print(F("Включение поля, мкс: "));
+      console.println(discovery.getStats().fieldUpLast);
+#endif
+      if (card.technology == PN5180_TECH_A)
+        printCardWorkInfo(card.data, card.uidLength);
+      else
+        printOtherCard(card);
+    }
+    else if (card.technology == PN5180_TECH_A)
+      nfc.mifareHalt(); // уже обработана: обратно в HALT до следующего WUPA
+  }
+  else
+    thermal.rest(serviceDelay); // нагрев: пауза с выключенным полем
+  tracker.endPoll();
   delay(2);
 }
 
-// Print card serial number, ATQA and SAK
-void printCardWorkInfo()
+// Карта убрана: событие выдаётся один раз, после подавления дребезга
+void onCardEvent(uint8_t event, const PN5180TrackedCard &card, void *)
 {
-  uint8_t uidLength;
-  uint8_t buffer[10] = {0}; // 0-1: ATQA, 2: SAK, 3-9: UID
-  uidLength = nfc.cardDetect(buffer);
-
-  if (!uidLength)
-  {
-    // Serial.println(F("Incorrect UID length or no card detected!"));
+  if (event != TRACKER_EVENT_LEAVE)
     return;
+  events.cardLeave(card.technology, card.uid, card.uidLength);
+  console.print(F("Карта убрана, UID: "));
+  for (int i = 0; i < card.uidLength; i++)
+  {
+    if (i > 0)
+      console.print(":");
+    char byteStr[4];
+    snprintf(byteStr, sizeof(byteStr), "%02X", card.uid[i]);
+    console.print(byteStr);
   }
+  console.println();
+}
 
+// Print card serial number, ATQA and SAK
+// buffer: 0-1: ATQA, 2: SAK, 3-9: UID
+void printCardWorkInfo(uint8_t *buffer, uint8_t uidLength)
+{
+#if PN5180_BINARY_EVENTS
+  events.cardEnterTypeA(buffer, uidLength);
+#else
   // --- UID ---
-  Serial.print(F("UID: "));
+  console.print(F("UID: "));
   for (int i = 3; i < 3 + uidLength; i++)
   {
     if (i > 3)
-      Serial.print(":");
+      console.print(":");
     char byteStr[4];
     snprintf(byteStr, sizeof(byteStr), "%02X", buffer[i]);
-    Serial.print(byteStr);
+    console.print(byteStr);
   }
-  Serial.println();
+  console.println();
 
   // --- SAK ---
   char sakStr[12];
   snprintf(sakStr, sizeof(sakStr), "SAK: 0x%02X", buffer[2]);
-  Serial.println(sakStr);
+  console.println(sakStr);
 
   // --- ATQA ---
   char atqaStr[16];
   snprintf(atqaStr, sizeof(atqaStr), "ATQA: 0x%02X%02X", buffer[1], buffer[0]); // порядок [1][0] = High:Low
-  Serial.println(atqaStr);
+  console.println(atqaStr);
+#endif
 
   // --- Обработка в зависимости от SAK ---
   if (buffer[2] == 0x20)
   {
-    Serial.println(F("SAK == 0x20, карта поддерживает APDU."));
-    nfc.sendRATS();
+    console.println(F("SAK == 0x20, карта поддерживает APDU."));
+    if (session.open() && session.isLikelyHCE())
+    {
+      // Телефон: выбор приложения с повторами выполняется в следующих loop()
+      console.println(F("Телефон (HCE), выбираем приложение..."));
+      session.hceBegin(hceAid, sizeof(hceAid));
+      return;
+    }
+    if (session.isOpen())
+      readNdefType4();
+    if (session.isOpen() && runApduBatch())
+    {
+      // Сессия остаётся открытой, следующий пакет — в следующем loop()
+      return;
+    }
+    session.close();
+  }
+  else if (buffer[2] == 0x08 || buffer[2] == 0x18 || buffer[2] == 0x09)
+  {
+    // SAK 0x08 — Classic 1K, 0x18 — Classic 4K, 0x09 — Classic Mini
+    readMifareClassic(buffer, uidLength);
+    cardDone();
+    return;
   }
   else
   {
-    Serial.println(F("Это не APDU карта."));
+    console.println(F("Это не APDU карта."));
 
     // Проверка на mifare_UL_EV1 48 кБ. UID длина 7 байт, SAK = 0x00, ATQA = 0x0044
     if (uidLength == 7 && buffer[2] == 0x00 && buffer[0] == 0x44 && buffer[1] == 0x00)
     {
-      Serial.println(F("Обнаружена mifare_UL_EV1 48 кБ."));
+      console.println(F("Обнаружена mifare_UL_EV1 48 кБ."));
     }
     else
     {
-      Serial.println(F("Это не mifare UL EV1."));
+      console.println(F("Это не mifare UL EV1."));
       nfc.mifareHalt();
-      Serial.println(F("------------------------------------------------"));
-      delay(1000);
+      cardDone();
       return;
     }
 
@@ -145,7 +367,9 @@ void printCardWorkInfo()
       // Проверяем, что это MIFARE Ultralight EV1 48 байт
       if (versionData[2] == 0x03 && versionData[4] == 0x01 && versionData[6] == 0x0B)
       {
-        Serial.println(F("Подтверждена mifare_UL_EV1 48 кБ."));
+        console.println(F("Подтверждена mifare_UL_EV1 48 кБ."));
+        if (ndefType2.read(printNdefRecord, 0) != NDEF_PARSE_DONE)
+          console.println(F("NDEF не прочитан."));
         // Аутентификация PWD_AUTH
         // uint8_t password[4] = {0xD1, 0xF7, 0x34, 0x85}; //  твой пароль
         uint8_t password[4] = {0xFF, 0xFF, 0xFF, 0xFF}; //  пароль по умолчанию
@@ -153,30 +377,334 @@ void printCardWorkInfo()
 
         if (nfc.mifare_UL_EV1_PwdAuth(password, pack_read))
         {
-          Serial.print(F("Аутентификация - успешно! PACK: "));
-          Serial.print(pack_read[0], HEX);
-          Serial.print(":");
-          Serial.println(pack_read[1], HEX);
+          console.print(F("Аутентификация - успешно! PACK: "));
+          console.print(pack_read[0], HEX);
+          console.print(":");
+          console.println(pack_read[1], HEX);
         }
         else
         {
-          Serial.println(F("Аутентификация не удалась."));
+          console.println(F("Аутентификация не удалась."));
           return;
         }
       }
       else
       {
-        Serial.println(F("Это не mifare_UL_EV1 48 кБ по версии"));
+        console.println(F("Это не mifare_UL_EV1 48 кБ по версии"));
       }
     }
     else
     {
-      Serial.println(F("Не удалось получить версию чипа"));
+      console.println(F("Не удалось получить версию чипа"));
     }
   }
 
   // Завершаем сессию
   nfc.mifareHalt();
-  Serial.println(F("------------------------------------------------"));
-  delay(950);
+  cardDone();
+}
+
+// Карта Type B, FeliCa или ISO15693, найденная циклом опроса
+void printOtherCard(const PN5180DiscoveryResult &card)
+{
+  events.cardEnter(card.technology, card.uid, card.uidLength);
+  if (card.technology == PN5180_TECH_B)
+    console.print(F("Type B, PUPI: "));
+  else if (card.technology == PN5180_TECH_F)
+    console.print(F("FeliCa, IDm: "));
+  else
+    console.print(F("ISO15693, UID: "));
+  for (int i = 0; i < card.uidLength; i++)
+  {
+    if (i > 0)
+      console.print(":");
+    char byteStr[4];
+    snprintf(byteStr, sizeof(byteStr), "%02X", card.uid[i]);
+    console.print(byteStr);
+  }
+  console.println();
+
+  // Type B после ATTRIB уже в ISO-DEP — тот же пакет APDU, что и для Type A
+  if (card.technology == PN5180_TECH_B)
+  {
+    if (session.attach())
+      readNdefType4();
+    if (session.isOpen() && runApduBatch())
+      return;
+    session.close();
+  }
+  cardDone();
+}
+
+// Конец отчёта о карте
+void cardDone()
+{
+  console.println(F("------------------------------------------------"));
+}
+
+// Чтение сектора MIFARE Classic с перебором ключей. Дамп длиннее кольца вывода,
+// поэтому печатаем его только после HALT, когда обмен с картой закончен
+void readMifareClassic(uint8_t *buffer, uint8_t uidLength)
+{
+  console.println(F("Обнаружена MIFARE Classic."));
+
+  uint8_t sectorData[64];
+  int8_t key = nfc.mifareClassicReadSectorAnyKey(MIFARE_CLASSIC_SECTOR, MIFARE_KEY_A, buffer + 3, uidLength, sectorData);
+  nfc.mifareHalt();
+  if (key < 0)
+  {
+    console.println(F("Ни один ключ не подошёл."));
+  }
+  else
+  {
+    console.print(F("Сектор "));
+    console.print(MIFARE_CLASSIC_SECTOR);
+    console.print(F(", ключ #"));
+    console.println(key);
+    for (int i = 0; i < 64; i++)
+    {
+      if (i % 16 == 0)
+        consoleDrain();
+      if (sectorData[i] < 0x10)
+        console.print("0");
+      console.print(sectorData[i], HEX);
+      console.print((i % 16 == 15) ? "\n" : " ");
+    }
+  }
+}
+
+// Печать записей NDEF по мере чтения страниц: тип, затем полезная нагрузка кусками
+bool printNdefRecord(uint8_t event, const NDEFRecord &record, const uint8_t *data, uint16_t len, void *)
+{
+  // Вызывается посреди обмена со считывателем: не ждём порт, лишнее кольцо отбросит и посчитает
+  if (event == NDEF_EVENT_RECORD_BEGIN)
+  {
+    console.print(F("NDEF #"));
+    console.print(record.index);
+    console.print(F(" TNF="));
+    console.print(record.flags & NDEF_TNF_MASK);
+    console.print(F(" тип="));
+    for (uint8_t i = 0; i < record.typeLength && i < NDEF_MAX_TYPE_LEN; i++)
+      console.print((char)record.type[i]);
+    console.print(F(", "));
+    console.print(record.payloadLength);
+    console.print(F(" байт: "));
+  }
+  else if (event == NDEF_EVENT_PAYLOAD)
+  {
+    for (uint16_t i = 0; i < len; i++)
+      console.print((data[i] >= 0x20 && data[i] < 0x7F) ? (char)data[i] : '.');
+  }
+  else
+  {
+    console.println();
+  }
+  return true;
+}
+
+// Сообщение NDEF карты Type 4, если на ней есть NDEF-приложение
+void readNdefType4()
+{
+  if (!ndefType4.select())
+    return;
+  if (ndefType4.read(printNdefRecord, 0) != NDEF_PARSE_DONE)
+    console.println(F("NDEF не прочитан."));
+}
+
+// Печать ответа на команду пакета
+bool printApduResponse(uint8_t index, const uint8_t *resp, uint16_t len, uint16_t sw, void *)
+{
+  events.apduResult(index, sw, len);
+  console.print(F("APDU #"));
+  console.print(index);
+  console.print(F(": "));
+  for (uint16_t i = 0; i < len; i++)
+  {
+    if (resp[i] < 0x10)
+      console.print("0");
+    console.print(resp[i], HEX);
+    console.print(" ");
+  }
+  console.println();
+  return true;
+}
+
+// Выполняет пакет APDU в открытой сессии, false — пакет прерван
+bool runApduBatch()
+{
+  uint8_t resp[64];
+  uint8_t count = sizeof(apduBatch) / sizeof(apduBatch[0]);
+  uint8_t done = session.runBatch(apduBatch, count, resp, sizeof(resp), printApduResponse);
+  if (done < count)
+  {
+    events.error(PN5180_EVENT_ERROR_SESSION, session.getLastSW());
+    console.print(F("Пакет прерван на APDU #"));
+    console.print(done);
+    console.print(F(", SW="));
+    console.println(session.getLastSW(), HEX);
+    return false;
+  }
+  return true;
+}
+
+// Статистика ответов телефонов в режиме HCE
+void printHceStats()
+{
+  const PN5180HceStats &stats = session.getHceStats();
+  console.print(F("HCE: выбрано "));
+  console.print(stats.selected);
+  console.print(F(" из "));
+  console.print(stats.sessions);
+  console.print(F(", с первой попытки "));
+  console.print(stats.firstTry);
+  console.print(F(", повторов "));
+  console.println(stats.retries);
+  if (stats.answers > 0)
+  {
+    console.print(F("Ответ на SELECT, мс: мин "));
+    console.print(stats.answerTimeMin);
+    console.print(F(", макс "));
+    console.print(stats.answerTimeMax);
+    console.print(F(", средн "));
+    console.println(stats.answerTimeSum / stats.answers);
+  }
+  uint16_t unlocked = stats.selected - stats.firstTry;
+  if (unlocked > 0)
+  {
+    console.print(F("Разблокировка, мс: мин "));
+    console.print(stats.unlockTimeMin);
+    console.print(F(", макс "));
+    console.print(stats.unlockTimeMax);
+    console.print(F(", средн "));
+    console.println(stats.unlockTimeSum / unlocked);
+  }
+}
+
+// Калибровка RF: сначала без карты, затем с эталонной картой на рабочем расстоянии
+void runTuning()
+{
+  PN5180Tuning tuning(nfc);
+  console.println(F("Калибровка RF: уберите карты с антенны"));
+  serviceDelay(3000);
+  if (!tuning.measureIdle())
+  {
+    console.println(F("Ошибка калибровки без карты"));
+    return;
+  }
+  console.println(F("Положите эталонную карту на рабочее расстояние"));
+  while (!tuning.cardPresent())
+    serviceDelay(100);
+  serviceDelay(1000); // рука убрана, карта неподвижна
+  if (!tuning.measureCard())
+  {
+    console.println(F("Ошибка калибровки с картой"));
+    return;
+  }
+  // Таблица длиннее кольца вывода — печатаем напрямую
+  txRing.flush();
+  tuning.print(Serial);
+  int8_t gear = tuning.best();
+  if (gear < 0)
+  {
+    console.println(F("Карта не активировалась ни на одной ступени, настройка не изменена"));
+    return;
+  }
+  console.print(F("Лучшая ступень "));
+  console.print(gear);
+  console.print(F(", запись в EEPROM: "));
+  console.println(tuning.store(gear) == EECFG_OK ? F("готово") : F("ошибка"));
+}
+
+#if PN5180_ALLOWLIST_BENCH
+// Тот же образ через функцию чтения — как из внешней памяти (SPI flash, SD)
+bool readAllowlistBench(uint32_t offset, uint8_t *buffer, uint8_t len, void *)
+{
+  memcpy_P(buffer, allowlistBench + offset, len);
+  return true;
+}
+
+volatile uint8_t allowlistBenchSink;
+
+/*
+ * Среднее время contains() по всем UID образа, мкс. С foreign — UID с изменённым
+ * последним байтом (чужие). Из общего времени вычитается проход без поиска:
+ * копирование UID из PROGMEM и сам цикл.
+ */
+float timeAllowlist(PN5180Allowlist &allowlist, bool foreign, uint16_t *found)
+{
+  uint8_t key[sizeof(allowlistBenchKeys[0])];
+  *found = 0;
+  unsigned long start = micros();
+  for (uint16_t i = 0; i < allowlistBenchKeyCount; i++)
+  {
+    memcpy_P(key, allowlistBenchKeys[i], sizeof(key));
+    if (foreign)
+      key[key[0]] ^= 0x5A;
+    *found += allowlist.contains(key + 1, key[0]);
+  }
+  unsigned long total = micros() - start;
+  start = micros();
+  for (uint16_t i = 0; i < allowlistBenchKeyCount; i++)
+  {
+    memcpy_P(key, allowlistBenchKeys[i], sizeof(key));
+    if (foreign)
+      key[key[0]] ^= 0x5A;
+    allowlistBenchSink = key[1];
+  }
+  unsigned long overhead = micros() - start;
+  return (float)(total - overhead) / allowlistBenchKeyCount;
+}
+
+void runAllowlistBench()
+{
+  PN5180Allowlist allowlist;
+  console.print(F("Список UID: "));
+  console.print(allowlistBenchKeyCount);
+  console.print(F(" UID, "));
+  console.print(sizeof(allowlistBench));
+  console.println(F(" байт во flash"));
+  txRing.flush();
+  for (uint8_t external = 0; external < 2; external++)
+  {
+    if (!(external ? allowlist.begin(readAllowlistBench) : allowlist.beginProgmem(allowlistBench)))
+    {
+      console.println(F("Образ списка повреждён"));
+      return;
+    }
+    uint16_t hits, falsePositives;
+    float hitUs = timeAllowlist(allowlist, false, &hits);
+    float missUs = timeAllowlist(allowlist, true, &falsePositives);
+    console.print(external ? F("Функция чтения") : F("PROGMEM"));
+    console.print(F(": свои "));
+    console.print(hitUs, 1);
+    console.print(F(" мкс, найдено "));
+    console.print(hits);
+    txRing.flush();
+    console.print(F("; чужие "));
+    console.print(missUs, 1);
+    console.print(F(" мкс, ложных "));
+    console.println(falsePositives);
+    txRing.flush();
+  }
+}
+#endif
+
+/*
+ * Ожидание, пока кольцо вывода (128 байт на AVR) уйдёт в порт. Блокирует, поэтому
+ * только после завершения обмена с картой: во время обмена лишние строки кольцо
+ * отбрасывает и считает. В двоичном режиме console — заглушка, и ждать нечего.
+ */
+void consoleDrain()
+{
+#if !PN5180_BINARY_EVENTS
+  txRing.flush();
+#endif
+}
+
+// Пауза, во время которой кольцо вывода продолжает уходить в порт
+void serviceDelay(unsigned long ms)
+{
+  unsigned long start = millis();
+  while (millis() - start < ms)
+    txRing.service();
 }